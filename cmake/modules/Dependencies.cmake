@@ -134,6 +134,28 @@ if(USE_LOCAL_TRANSCRIPTION)
     message(STATUS "Python3 version: ${Python3_VERSION}")
 endif()
 
+# whisper.cpp - Native in-process local transcription (LOCAL_BACKEND: whisper.cpp)
+option(USE_WHISPER_CPP "Enable native whisper.cpp local transcription backend" OFF)
+if(USE_WHISPER_CPP)
+    find_package(whisper QUIET)
+
+    if(NOT whisper_FOUND)
+        message(STATUS "whisper.cpp not found in system, fetching from GitHub...")
+        FetchContent_Declare(
+            whisper
+            GIT_REPOSITORY https://github.com/ggerganov/whisper.cpp.git
+            GIT_TAG v1.7.4
+            GIT_SHALLOW TRUE
+        )
+        set(WHISPER_BUILD_TESTS OFF CACHE BOOL "" FORCE)
+        set(WHISPER_BUILD_EXAMPLES OFF CACHE BOOL "" FORCE)
+        set(WHISPER_BUILD_SERVER OFF CACHE BOOL "" FORCE)
+        FetchContent_MakeAvailable(whisper)
+    else()
+        message(STATUS "Using system whisper.cpp")
+    endif()
+endif()
+
 # Print dependency information
 message(STATUS "=== Dependency Summary ===")
 message(STATUS "CURL found: ${CURL_FOUND}")
@@ -143,4 +165,7 @@ if(USE_LOCAL_TRANSCRIPTION)
     message(STATUS "pybind11 found: ${pybind11_FOUND}")
     message(STATUS "Python3 found: ${Python3_FOUND}")
 endif()
+if(USE_WHISPER_CPP)
+    message(STATUS "whisper.cpp: enabled")
+endif()
 message(STATUS "=========================")
\ No newline at end of file
@@ -6,14 +6,20 @@ Can be used both as a standalone script and as a Python module.
 
 import sys
 import json
+import argparse
 import logging
 from pathlib import Path
 
-# Lazy import to avoid loading the model when just importing the module
-_model = None
+# Lazy import to avoid loading models when just importing the module.
+# Loaded models are cached by size so tiered mode keeps both resident.
+_models = {}
 
 # Configuration constants
 MODEL_SIZE = "large-v3"
+# Tiered mode: the draft model runs first with cheap decoding settings and
+# the C++ side re-runs low-confidence results with MODEL_SIZE
+DRAFT_BEAM_SIZE = 1
+DRAFT_BEST_OF = 1
 BEAM_SIZE = 9
 PATIENCE = 10
 BEST_OF = 9
@@ -26,61 +32,91 @@ WINDOW_SIZE_SAMPLES = 1536  # Supported: [512, 1024, 1536] for 16000 sampling_ra
 INITIAL_PROMPT = ""  # You are transcribing radio traffic from emergency services
 
 
-def get_model():
-    """Lazy initialization of the Whisper model."""
-    global _model
-    if _model is None:
+def get_model(model_size=None):
+    """Lazy initialization of a Whisper model (MODEL_SIZE by default)."""
+    size = model_size or MODEL_SIZE
+    model = _models.get(size)
+    if model is None:
         from faster_whisper import WhisperModel
         
         # Try GPU first, fall back to CPU if not available
         # int8_float32 uses ~2.3GB VRAM vs ~7.6GB for float32 with identical quality.
         # Pascal GPUs (GTX 10-series) don't support float16/int8_float16.
         try:
-            _model = WhisperModel(MODEL_SIZE, device="cuda", compute_type="int8_float32")
-            print(f"Loaded model {MODEL_SIZE} on CUDA (int8_float32)", file=sys.stderr)
+            model = WhisperModel(size, device="cuda", compute_type="int8_float32")
+            print(f"Loaded model {size} on CUDA (int8_float32)", file=sys.stderr)
         except Exception as e:
             print(f"Failed to load on CUDA: {e}, falling back to CPU", file=sys.stderr)
             try:
-                _model = WhisperModel(MODEL_SIZE, device="cpu", compute_type="int8")
-                print(f"Loaded model {MODEL_SIZE} on CPU", file=sys.stderr)
+                model = WhisperModel(size, device="cpu", compute_type="int8")
+                print(f"Loaded model {size} on CPU", file=sys.stderr)
             except Exception as cpu_e:
                 raise RuntimeError(f"Failed to load Whisper model: {cpu_e}")
+        _models[size] = model
     
-    return _model
+    return model
 
 
-def transcribe(filepath):
+def transcribe(audio, model_size=None, beam_size=None, patience=None,
+               best_of=None, temperature=None, vad_threshold=None,
+               min_silence_duration_ms=None):
     """
-    Transcribe an audio file using Faster Whisper.
+    Transcribe audio using Faster Whisper.
     
     Args:
-        filepath: Path to the audio file (MP3, WAV, etc.)
+        audio: Path to the audio file (MP3, WAV, etc.), or a 1-D float32
+               numpy array of 16 kHz mono samples already decoded by the
+               C++ side (passed without copying)
+        model_size: Model to use; None uses MODEL_SIZE with full-quality
+                    decoding, any other size uses the cheaper draft settings
+        beam_size, patience, best_of, temperature, vad_threshold,
+        min_silence_duration_ms: per-talkgroup DECODE_PROFILE overrides;
+                    None keeps the module (or draft) default
         
     Returns:
-        JSON string with transcription in format: {"text": "transcribed text"}
+        JSON string in format:
+        {"text": "...", "avg_logprob": x, "no_speech_prob": y}
+        where avg_logprob is the duration-weighted mean over segments and
+        no_speech_prob the highest segment value (1.0 if nothing was heard)
     """
-    # Validate file exists
-    audio_path = Path(filepath)
-    if not audio_path.exists():
-        raise FileNotFoundError(f"Audio file not found: {filepath}")
+    if isinstance(audio, (str, Path)):
+        # Validate file exists
+        audio_path = Path(audio)
+        if not audio_path.exists():
+            raise FileNotFoundError(f"Audio file not found: {audio}")
+        audio = str(audio_path)
     
     # Get or initialize the model
-    model = get_model()
+    draft = model_size is not None and model_size != MODEL_SIZE
+    model = get_model(model_size)
+    
+    if beam_size is None:
+        beam_size = DRAFT_BEAM_SIZE if draft else BEAM_SIZE
+    if patience is None:
+        patience = 1 if draft else PATIENCE
+    if best_of is None:
+        best_of = DRAFT_BEST_OF if draft else BEST_OF
+    if temperature is None:
+        temperature = TEMPERATURE
+    if vad_threshold is None:
+        vad_threshold = THRESHOLD
+    if min_silence_duration_ms is None:
+        min_silence_duration_ms = MIN_SILENCE_DURATION_MS
     
     # Perform transcription
     # Note: window_size_samples removed as it's not supported in all versions
     segments, info = model.transcribe(
-        str(audio_path),
-        beam_size=BEAM_SIZE,
-        patience=PATIENCE,
-        best_of=BEST_OF,
+        audio,
+        beam_size=beam_size,
+        patience=patience,
+        best_of=best_of,
         repetition_penalty=REPETITION_PENALTY,
         initial_prompt=INITIAL_PROMPT,
-        temperature=TEMPERATURE,
+        temperature=temperature,
         vad_filter=True,
         vad_parameters=dict(
-            threshold=THRESHOLD,
-            min_silence_duration_ms=MIN_SILENCE_DURATION_MS
+            threshold=vad_threshold,
+            min_silence_duration_ms=min_silence_duration_ms
         ),
         language=LANGUAGE
     )
@@ -92,8 +128,22 @@ def transcribe(filepath):
     text_parts = [segment.text.strip() for segment in segments]
     formatted_text = " ".join(text_parts)
     
+    # Confidence for the tiered escalation decision
+    total = sum(max(s.end - s.start, 0.0) for s in segments)
+    if segments and total > 0:
+        avg_logprob = sum(s.avg_logprob * max(s.end - s.start, 0.0) for s in segments) / total
+    elif segments:
+        avg_logprob = sum(s.avg_logprob for s in segments) / len(segments)
+    else:
+        avg_logprob = 0.0
+    no_speech_prob = max((s.no_speech_prob for s in segments), default=1.0)
+    
     # Create result dictionary
-    result = {"text": formatted_text}
+    result = {
+        "text": formatted_text,
+        "avg_logprob": round(avg_logprob, 4),
+        "no_speech_prob": round(no_speech_prob, 4),
+    }
     
     # Convert to compact JSON
     result_json = json.dumps(result, separators=(',', ':'))
@@ -103,17 +153,30 @@ def transcribe(filepath):
 
 def main():
     """Main function for standalone script usage."""
-    # Check if a filename is provided
-    if len(sys.argv) < 2:
-        print("Usage: python fasterWhisper.py <filename.mp3>", file=sys.stderr)
-        sys.exit(1)
-    
-    # Get filename from command line
-    filepath = sys.argv[1]
+    parser = argparse.ArgumentParser(description="Transcribe an audio file with faster-whisper")
+    parser.add_argument("filename")
+    parser.add_argument("model_size", nargs="?", default=None)
+    # DECODE_PROFILE overrides passed by the C++ subprocess fallback
+    parser.add_argument("--beam-size", type=int)
+    parser.add_argument("--patience", type=float)
+    parser.add_argument("--best-of", type=int)
+    parser.add_argument("--temperature", type=float)
+    parser.add_argument("--vad-threshold", type=float)
+    parser.add_argument("--min-silence-duration-ms", type=int)
+    args = parser.parse_args()
     
     try:
         # Transcribe and print result
-        result = transcribe(filepath)
+        result = transcribe(
+            args.filename,
+            args.model_size,
+            beam_size=args.beam_size,
+            patience=args.patience,
+            best_of=args.best_of,
+            temperature=args.temperature,
+            vad_threshold=args.vad_threshold,
+            min_silence_duration_ms=args.min_silence_duration_ms,
+        )
         print(result)
     except Exception as e:
         print(f"Error: {e}", file=sys.stderr)
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace sdrtrunk {
+
+/**
+ * Streaming rational-ratio polyphase resampler to mono float32
+ *
+ * Converts decoder output (interleaved int16, any channel count) to mono
+ * float at the target rate in one pass: downmix and int16 -> float are
+ * fused into the copy into the filter history, and each output sample is
+ * one vectorized dot product against a single filter phase. The
+ * prototype filter is a Kaiser-windowed sinc with TAPS_PER_PHASE taps per
+ * phase, cut off just below the lower of the two Nyquist frequencies.
+ * Output is time-aligned with the input (the filter delay is compensated)
+ * and has ceil(inputSamples * outRate / inRate) samples once finish() is
+ * called.
+ *
+ * SDRTrunk's rates reduce to small ratios: 8000 -> 16000 is 2/1,
+ * 22050 -> 16000 is 320/441 and 44100 -> 16000 is 160/441.
+ */
+class PolyphaseResampler {
+public:
+    static constexpr size_t TAPS_PER_PHASE = 32;
+
+    PolyphaseResampler(int inRate, int outRate);
+
+    int upFactor() const { return up_; }
+    int downFactor() const { return down_; }
+
+    /** Convert and resample interleaved int16 frames, appending to out */
+    void push(std::span<const int16_t> interleaved, int channels, std::vector<float>& out);
+
+    /** Resample mono float samples, appending to out */
+    void push(std::span<const float> mono, std::vector<float>& out);
+
+    /** Flush the samples still inside the filter window */
+    void finish(std::vector<float>& out);
+
+private:
+    void emit(std::vector<float>& out, int64_t limit);
+    void compact();
+
+    int up_ = 1;
+    int down_ = 1;
+    std::shared_ptr<const std::vector<float>> coefficients_;  // up_ rows of TAPS_PER_PHASE, reversed
+
+    std::vector<float> history_;  // input samples from historyStart_ on
+    int64_t historyStart_ = 0;    // input index of history_[0] (negative while primed with zeros)
+    int64_t received_ = 0;        // input samples pushed so far
+    int64_t position_ = 0;        // floor(n * down / up) for the next output n
+    int phase_ = 0;               // (n * down) mod up
+};
+
+namespace audio {
+
+// Vectorized kernels (AVX2/SSE2/NEON with a scalar fallback)
+
+// Mono float in [-1, 1) from interleaved int16; channels are averaged.
+// out must hold interleaved.size() / channels samples.
+void int16ToMonoFloat(std::span<const int16_t> interleaved, int channels, float* out);
+
+// Sum of a[i] * b[i]; a and b must have the same length
+float dot(std::span<const float> a, std::span<const float> b);
+
+} // namespace audio
+
+} // namespace sdrtrunk
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace sdrtrunk {
+
+/**
+ * Near-duplicate detection settings (FINGERPRINT_* keys)
+ *
+ * Simulcast sites and patched talkgroups record the same call with
+ * slightly different start and end times, so byte hashes never match.
+ * A recording whose fingerprint matches one stored within windowSeconds
+ * of its own timestamp reuses that recording's transcription.
+ */
+struct FingerprintConfig {
+    int windowSeconds = 10;        // search +/- this many seconds around the recording
+    double minSimilarity = 0.25;   // aligned landmarks / landmarks of the shorter recording
+    double minDurationRatio = 0.6; // shorter / longer duration; keeps a short clip from matching a long call
+};
+
+/**
+ * Spectral-peak landmark fingerprint of one recording
+ *
+ * Each landmark hashes a pair of spectral peaks (anchor bin, bin delta,
+ * frame delta) and keeps the anchor's frame. Two recordings of the same
+ * audio share many hashes at one constant frame offset, whatever their
+ * start times, while unrelated audio shares few and at scattered offsets.
+ * Landmarks are sorted by hash.
+ */
+struct AudioFingerprint {
+    struct Landmark {
+        uint32_t hash = 0;
+        uint32_t frame = 0;
+    };
+
+    uint32_t frames = 0;  // analysis frames covered (16 ms hop)
+    std::vector<Landmark> landmarks;
+
+    double durationSeconds() const;
+
+    /** Compact little-endian encoding for the audio_fingerprints table */
+    std::vector<uint8_t> serialize() const;
+
+    /** Decode serialize() output; malformed input gives an empty fingerprint */
+    static AudioFingerprint deserialize(std::span<const uint8_t> bytes);
+};
+
+/**
+ * Fingerprint 16 kHz mono PCM (decodeMP3ToPcm output)
+ *
+ * Peaks are taken from the 250-3400 Hz voice band of 32 ms frames, so
+ * silence and hang time contribute nothing.
+ */
+AudioFingerprint computeFingerprint(std::span<const float> samples);
+
+/**
+ * Share of the shorter fingerprint's landmarks that line up with the
+ * other at their best common frame offset, in [0, 1]
+ */
+double fingerprintSimilarity(const AudioFingerprint& a, const AudioFingerprint& b);
+
+/**
+ * Whether b is a re-recording of a under config's thresholds
+ */
+bool isNearDuplicate(const AudioFingerprint& a, const AudioFingerprint& b, const FingerprintConfig& config = {});
+
+} // namespace sdrtrunk
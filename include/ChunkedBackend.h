@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "TranscriptionBackend.h"
+
+class ThreadPool;
+
+namespace sdrtrunk {
+
+class PcmStream;
+
+/**
+ * When and how long recordings are split (CHUNK_* keys)
+ */
+struct ChunkingConfig {
+    double thresholdSeconds = 0.0;     // split recordings at least this long; 0 = off
+    double targetChunkSeconds = 30.0;  // aim for chunks this long (Whisper's window)
+    double searchSeconds = 5.0;        // look this far either side of the target for a pause
+    int maxParallel = 4;               // chunks transcribed at once, across all recordings
+};
+
+/**
+ * A [begin, end) range of samples
+ */
+struct AudioChunk {
+    size_t begin = 0;
+    size_t end = 0;
+};
+
+/**
+ * Split PCM into chunks of about targetChunkSeconds, cutting at the
+ * quietest point within searchSeconds of each target
+ *
+ * Quietness is the frame energy summed over a short window, from one
+ * vectorized pass over 20 ms frames. The last chunk absorbs a remainder
+ * shorter than searchSeconds. Audio shorter than one chunk is returned
+ * whole.
+ */
+std::vector<AudioChunk> splitAtSilence(std::span<const float> samples, int sampleRate, const ChunkingConfig& config);
+
+/**
+ * Transcribe long recordings as parallel chunks
+ *
+ * Recordings of at least thresholdSeconds are decoded once, split at
+ * pauses and handed to the wrapped backend as PCM chunks on a shared
+ * pool of maxParallel threads (the calling worker takes the first chunk
+ * itself). The texts are joined in order into one {"text":...} response,
+ * with a duration-weighted avg_logprob when every chunk reports one, so
+ * glossary post-processing sees a single transcription. Shorter
+ * recordings, backends that cannot take PCM and backends that serialize
+ * their calls (transcribesConcurrently() false) pass straight through.
+ *
+ * Recordings that arrive undecoded are streamed through PcmStream
+ * instead: each chunk is cut as soon as the decoded window covers its
+ * search range, and at most maxParallel chunks are in flight per
+ * recording, so memory stays bounded however long the recording is. The
+ * window and chunks are reserved against DecodeMemoryBudget first.
+ *
+ * Recordings whose whole decode would exceed the DecodeMemoryBudget cap
+ * are streamed the same way even when chunking is off or the backend
+ * serializes its calls, one chunk at a time in that case, so the cap
+ * holds for every recording a PCM backend sees.
+ */
+class ChunkedBackend : public TranscriptionBackend {
+public:
+    ChunkedBackend(std::shared_ptr<TranscriptionBackend> inner, ChunkingConfig config);
+    ~ChunkedBackend() override;
+
+    Result<std::string> transcribe(const TranscriptionRequest& request) override;
+    std::string name() const override { return "chunked(" + inner_->name() + ")"; }
+    bool consumesPcm() const override { return inner_->consumesPcm(); }
+    bool transcribesConcurrently() const override { return inner_->transcribesConcurrently(); }
+    bool streamsRecording(double durationSeconds) const override;
+
+private:
+    // Whether a recording this long is split for parallel transcription
+    bool splits(double durationSeconds) const;
+    Result<std::string> transcribeStream(const TranscriptionRequest& request, PcmStream& stream, size_t maxInFlight);
+
+    std::shared_ptr<TranscriptionBackend> inner_;
+    ChunkingConfig config_;
+    std::unique_ptr<ThreadPool> pool_;
+};
+
+} // namespace sdrtrunk
@@ -4,7 +4,13 @@
 // Standard Library Headers
 #include <string>
 
+#include "AudioFingerprint.h"
+#include "ChunkedBackend.h"
+#include "Glossary.h"
 #include "transcriptionProcessor.h"
+#include "TieredBackend.h"
+#include "TranscriptionRouter.h"
+#include "VoiceActivity.h"
 #include "yamlParser.h"
 
 class ConfigSingleton
@@ -14,7 +20,7 @@ public:
     void initialize(const YamlNode &config);
 
     std::string getOpenAIAPIKey() const;
-    const std::unordered_map<int, TalkgroupFiles>& getTalkgroupFiles() const;
+    const sdrtrunk::TalkgroupProfiles& getTalkgroupFiles() const;
     std::string getDatabasePath() const;
     std::string getDirectoryToMonitor() const;
     int getLoopWaitSeconds() const;
@@ -24,6 +30,23 @@ public:
     int getRateLimitWindowSeconds() const;
     int getMinDurationSeconds() const;
     int getMaxThreads() const;
+    std::string getLocalBackend() const;
+    std::string getWhisperCppModelPath() const;
+    int getWhisperCppThreads() const;
+    bool isHybridRouting() const;
+    const sdrtrunk::RoutingRules& getRoutingRules() const;
+    bool isVadEnabled() const;
+    const sdrtrunk::VadConfig& getVadConfig() const;
+    bool isTieredTranscription() const;
+    std::string getTierDraftModel() const;
+    std::string getWhisperCppDraftModelPath() const;
+    const sdrtrunk::TierThresholds& getTierThresholds() const;
+    bool isFingerprintDedup() const;
+    const sdrtrunk::FingerprintConfig& getFingerprintConfig() const;
+    const sdrtrunk::ChunkingConfig& getChunkingConfig() const;
+    int getDecodeMemoryCapMb() const;
+    int getGlossaryReloadSeconds() const;
+    sdrtrunk::GlossaryCache& getGlossaries();
     bool isDebugCurlHelper() const;
     bool isDebugDatabaseManager() const;
     bool isDebugFileProcessor() const;
@@ -39,7 +62,7 @@ private:
     std::string openaiAPIKey;
     std::string databasePath;
     std::string directoryToMonitor;
-    std::unordered_map<int, TalkgroupFiles> talkgroupFiles;
+    sdrtrunk::TalkgroupProfiles talkgroupFiles;  // one shared profile per distinct setting
     int loopWaitSeconds;
     int maxRetries;
     int maxRequestsPerMinute;
@@ -47,6 +70,23 @@ private:
     int rateLimitWindowSeconds;
     int minDurationSeconds;
     int maxThreads;
+    std::string localBackend;
+    std::string whisperCppModelPath;
+    int whisperCppThreads;
+    bool hybridRouting;
+    sdrtrunk::RoutingRules routingRules;
+    bool vadEnabled;
+    sdrtrunk::VadConfig vadConfig;
+    bool tieredTranscription;
+    std::string tierDraftModel;
+    std::string whisperCppDraftModelPath;
+    sdrtrunk::TierThresholds tierThresholds;
+    bool fingerprintDedup;
+    sdrtrunk::FingerprintConfig fingerprintConfig;
+    sdrtrunk::ChunkingConfig chunkingConfig;
+    int decodeMemoryCapMb;
+    int glossaryReloadSeconds;
+    sdrtrunk::GlossaryCache glossaries;  // every talkgroup's glossary set
     bool debugCurlHelper;
     bool debugDatabaseManager;
     bool debugFileProcessor;
@@ -3,10 +3,43 @@
 // Standard Library Headers
 #include <cstdint>
 #include <mutex>
+#include <optional>
 #include <string>
+#include <utility>
+#include <vector>
 
 // Project-Specific Headers
 #include <sqlite3.h>
+#include "MP3Duration.h"
+#include "RecordingFile.h"
+
+// A fingerprinted recording whose transcription can be reused
+struct StoredFingerprint
+{
+    std::string filename;
+    int talkgroupID = 0;
+    int64_t unixtime = 0;
+    std::vector<uint8_t> fingerprint;
+    std::string transcription;
+};
+
+// A transcribed recording to run the glossary pass on again
+struct StoredTranscription
+{
+    sqlite3_int64 id = 0;
+    int talkgroupID = 0;
+    int radioID = 0;
+    std::string transcription;
+    std::string v2transcription;
+};
+
+// Which recordings readTranscriptions() returns; unset fields match all
+struct TranscriptionFilter
+{
+    std::optional<int> talkgroupID;
+    std::optional<int64_t> fromUnixtime;  // inclusive
+    std::optional<int64_t> toUnixtime;    // exclusive
+};
 
 class DatabaseManager
 {
@@ -14,10 +47,27 @@ public:
     DatabaseManager(const std::string &dbPath);
     ~DatabaseManager();
     void createTable();
-    void insertRecording(const std::string &date, const std::string &time, int64_t unixtime, int talkgroupID, const std::string &talkgroupName, int radioID, double duration, const std::string &filename, const std::string &filepath, const std::string &transcription, const std::string &v2transcription);
+    void insertRecording(const std::string &date, const std::string &time, int64_t unixtime, int talkgroupID, const std::string &talkgroupName, int radioID, double duration, const std::string &filename, const std::string &filepath, const std::string &transcription, const std::string &v2transcription, const std::string &skipReason = "", double speechRatio = -1.0, const std::string &duplicateOf = "", const std::vector<int> &talkgroups = {});
+    void recordTierOutcome(int talkgroupID, bool escalated, double draftSeconds, double fullSeconds, double savedSeconds);
+    void insertFingerprint(const std::string &filename, int talkgroupID, int64_t unixtime, const std::vector<uint8_t> &fingerprint, const std::string &transcription);
+    std::vector<StoredFingerprint> findFingerprintsNear(int64_t unixtime, int windowSeconds);
+    std::optional<sdrtrunk::AudioMetadata> findAudioMetadata(const sdrtrunk::FileIdentity &identity);
+    void storeAudioMetadata(const sdrtrunk::FileIdentity &identity, const sdrtrunk::AudioMetadata &metadata);
+    // Filenames of recordings heard on a talkgroup, including as a patch
+    // member, between two unix times inclusive, oldest first
+    std::vector<std::string> findRecordingsByTalkgroup(int talkgroupID, int64_t fromUnixtime, int64_t toUnixtime);
+    // Up to limit transcribed recordings matching filter with an id above
+    // afterID, in id order; pass the last id back in for the next page
+    std::vector<StoredTranscription> readTranscriptions(const TranscriptionFilter &filter, sqlite3_int64 afterID, size_t limit);
+    // Replace the v2transcription of each (id, text) in one transaction;
+    // the number of rows updated, 0 when the transaction is rolled back
+    size_t updateV2Transcriptions(const std::vector<std::pair<sqlite3_int64, std::string>> &updates);
 
 private:
     void migrateSchema();
+    void addColumnIfMissing(const std::string &column, const std::string &definition);
+    void backfillRecordingTalkgroups();
+    bool insertRecordingTalkgroups(sqlite3_int64 recordingID, int64_t unixtime, const std::vector<int> &talkgroups);
     sqlite3 *db;
     std::mutex writeMutex_;
 };
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "Result.h"
+
+namespace sdrtrunk {
+
+/**
+ * Whisper decoding settings for one talkgroup
+ *
+ * Set per talkgroup with DECODE_PROFILE in TALKGROUP_FILES so compute is
+ * spent only where accuracy matters. Talkgroups without a profile use the
+ * backend's own defaults (the "accurate" preset for faster-whisper).
+ */
+struct DecodeProfile {
+    std::string name;
+    int beamSize = 9;
+    double patience = 10.0;
+    int bestOf = 9;
+    double temperature = 0.1;
+    double vadThreshold = 0.45;       // faster-whisper Silero VAD speech threshold
+    int minSilenceDurationMs = 1500;  // silence that splits VAD segments
+
+    bool operator==(const DecodeProfile&) const = default;
+};
+
+/**
+ * Look up a built-in profile: "fast", "balanced" or "accurate"
+ *
+ * @return The preset, or ConfigError for an unknown name
+ */
+Result<DecodeProfile> decodeProfilePreset(std::string_view name);
+
+} // namespace sdrtrunk
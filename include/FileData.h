@@ -4,8 +4,10 @@
 #include <string>
 #include <chrono>
 #include <filesystem>
+#include <vector>
 
 #include "DomainTypes.h"
+#include "TranscriptionBackend.h"
 
 using sdrtrunk::domain::TalkgroupId;
 using sdrtrunk::domain::RadioId;
@@ -19,6 +21,8 @@ struct FileData
     std::string time;
     std::chrono::system_clock::time_point timestamp;
     TalkgroupId talkgroupID;
+    // Every talkgroup of a patched call, talkgroupID first (recording_talkgroups)
+    std::vector<int> talkgroups;
     std::string talkgroupName;
     RadioId radioID;
     Duration duration;
@@ -26,6 +30,14 @@ struct FileData
     FilePath filepath;
     Transcription transcription;
     Transcription v2transcription;
+    // Set when a pre-transcription gate drops the recording (e.g. "vad")
+    std::string skipReason;
+    // Fraction of speech frames from the VAD gate; negative if not analyzed
+    double speechRatio = -1.0;
+    // Filename of the earlier copy whose transcription was reused
+    std::string duplicateOf;
+    // Draft/full tier result when TIERED_TRANSCRIPTION is on
+    sdrtrunk::TierOutcome tierOutcome;
 
     // Constructor with defaults
     FileData() : talkgroupID(0), radioID(0) {}
@@ -0,0 +1,270 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Result.h"
+
+namespace sdrtrunk {
+
+/**
+ * Case-insensitive multi-key matcher (Aho-Corasick)
+ *
+ * The keys are compiled once into a DFA over ASCII-case-folded bytes, so
+ * scan() reports every occurrence of every key in one pass over the
+ * text, however many keys there are. Bytes that appear in no key share
+ * one input class to keep the transition table small.
+ *
+ * The tables are plain arrays so that a compiled glossary file can hold
+ * them and be scanned in place once mapped.
+ */
+class GlossaryMatcher {
+public:
+    struct Tables {
+        std::span<const uint16_t> classOf;      // 256 entries: byte to input class, 0 for bytes in no key
+        uint32_t classes = 0;
+        std::span<const uint32_t> next;         // state * classes + class to next state
+        std::span<const uint32_t> outputStart;  // keys ending at state s: outputs[outputStart[s], outputStart[s + 1])
+        std::span<const uint32_t> outputs;
+        std::span<const uint32_t> lengths;      // per key
+    };
+
+    GlossaryMatcher() = default;
+
+    /** Empty keys never match */
+    explicit GlossaryMatcher(const std::vector<std::string>& keys);
+
+    /** Over tables that storage keeps alive, e.g. a mapped compiled glossary */
+    GlossaryMatcher(const Tables& tables, std::shared_ptr<const void> storage)
+        : tables_(tables), storage_(std::move(storage)) {}
+
+    /**
+     * Call onMatch(key index, begin, end) for each occurrence in text,
+     * overlapping ones included, in order of end position
+     */
+    template <typename OnMatch>
+    void scan(std::string_view text, OnMatch&& onMatch) const {
+        if (tables_.next.empty()) {
+            return;
+        }
+        uint32_t state = 0;
+        for (size_t i = 0; i < text.size(); ++i) {
+            state = tables_.next[state * tables_.classes + tables_.classOf[static_cast<unsigned char>(text[i])]];
+            for (uint32_t o = tables_.outputStart[state]; o < tables_.outputStart[state + 1]; ++o) {
+                const uint32_t key = tables_.outputs[o];
+                // Always true of a well-formed automaton; keeps a damaged
+                // compiled file from reporting a match before the text
+                if (tables_.lengths[key] <= i + 1) {
+                    onMatch(static_cast<size_t>(key), i + 1 - tables_.lengths[key], i + 1);
+                }
+            }
+        }
+    }
+
+    /**
+     * Keys that end the text key, case-folded; a key equal to it ignoring
+     * case is among them when there is one
+     */
+    std::span<const uint32_t> keysEndingAt(std::string_view key) const;
+
+    const Tables& tables() const { return tables_; }
+    size_t states() const { return tables_.outputStart.empty() ? 0 : tables_.outputStart.size() - 1; }
+
+private:
+    Tables tables_;
+    std::shared_ptr<const void> storage_;
+};
+
+/**
+ * Mappings of one JSON glossary file, multi-key or flat format, with a
+ * hyphen-free variant added for each hyphenated key
+ */
+Result<std::unordered_map<std::string, std::string>> loadGlossaryJson(const std::string& path);
+
+/**
+ * Mappings of several glossary files, JSON or compiled, merged in order
+ * with the first file to define a key winning. With strict set a file
+ * that cannot be read fails the merge; otherwise it is logged (a missing
+ * JSON file quietly) and skipped.
+ */
+Result<std::unordered_map<std::string, std::string>> mergeGlossaryFiles(const std::vector<std::string>& files,
+                                                                         bool strict);
+
+/**
+ * Merged, immutable mappings of one set of glossary files
+ *
+ * Built once from the files at startup, with hyphen variants expanded
+ * and all keys compiled into one GlossaryMatcher, then shared read-only
+ * by all talkgroups that list the same files and by every worker thread.
+ * For a key found in several files the first file listed wins, as it
+ * always has.
+ *
+ * Terms are records into one string table with each distinct value
+ * stored once, the layout of a compiled glossary (glossary-compiler), so
+ * a snapshot opened from one points straight into the mapped file.
+ */
+class GlossarySnapshot {
+public:
+    struct Term {
+        std::string_view key;
+        std::string_view value;
+    };
+
+    // Offsets into the string table
+    struct TermRecord {
+        uint32_t keyOffset;
+        uint32_t keyLength;
+        uint32_t valueOffset;
+        uint32_t valueLength;
+    };
+
+    /**
+     * Read and merge files in order; unreadable files contribute nothing.
+     * A compiled glossary listed on its own is mapped rather than copied.
+     */
+    static std::shared_ptr<const GlossarySnapshot> build(const std::vector<std::string>& files);
+
+    /** From mappings already merged; terms keep the map's order */
+    static std::shared_ptr<const GlossarySnapshot> fromMappings(std::vector<std::string> files,
+                                                                const std::unordered_map<std::string, std::string>& mappings);
+
+    /** Map a file written by writeCompiled() read-only */
+    static Result<std::shared_ptr<const GlossarySnapshot>> openCompiled(const std::string& path);
+
+    /** Whether path starts like a compiled glossary */
+    static bool isCompiled(const std::string& path);
+
+    /** Write the snapshot as a compiled glossary; the bytes written */
+    Result<size_t> writeCompiled(const std::string& path) const;
+
+    const std::vector<std::string>& files() const { return files_; }
+    size_t size() const { return records_.size(); }
+    Term term(size_t index) const {
+        const TermRecord& r = records_[index];
+        return {strings_.substr(r.keyOffset, r.keyLength), strings_.substr(r.valueOffset, r.valueLength)};
+    }
+
+    /** Value of key, matched exactly */
+    std::optional<std::string_view> find(std::string_view key) const;
+
+    /** The terms copied into a map */
+    std::unordered_map<std::string, std::string> mappings() const;
+
+    /**
+     * Write `, "key":"value"` for each term found in text as a whole word
+     * (case-insensitive, bounded like regex \b), the v2 transcription
+     * format; terms are written in term order
+     */
+    void appendMatches(std::ostream& out, const std::string& text) const;
+
+private:
+    GlossarySnapshot() = default;
+
+    std::vector<std::string> files_;
+    std::span<const TermRecord> records_;
+    std::string_view strings_;
+    GlossaryMatcher matcher_;  // key i is term i
+    std::shared_ptr<const void> storage_;  // owns records_ and strings_
+};
+
+/**
+ * Size and modification time of a glossary file when it was checked
+ */
+struct GlossaryFileStamp {
+    bool exists = false;
+    uintmax_t size = 0;
+    std::filesystem::file_time_type mtime{};
+
+    static GlossaryFileStamp of(const std::string& path);
+    bool operator==(const GlossaryFileStamp&) const = default;
+};
+
+/**
+ * The current snapshot of one glossary file list, replaced as the files
+ * change
+ *
+ * Workers call snapshot() and keep the returned pointer for as long as
+ * they use it; reloadIfChanged() builds the replacement off to the side
+ * and publishes it with one atomic store, so a reload never makes a
+ * worker wait for a rebuild and a snapshot is freed only after its last
+ * reader lets go (RCU style).
+ */
+class GlossarySet {
+public:
+    explicit GlossarySet(std::vector<std::string> files);
+
+    const std::vector<std::string>& files() const { return files_; }
+
+    std::shared_ptr<const GlossarySnapshot> snapshot() const { return current_.load(std::memory_order_acquire); }
+
+    /**
+     * Rebuild and publish when a file has changed and then stayed the
+     * same for one more check, so a file caught mid-write is not loaded;
+     * true when a new snapshot was published. One caller at a time.
+     */
+    bool reloadIfChanged();
+
+private:
+    std::vector<GlossaryFileStamp> stamps() const;
+
+    std::vector<std::string> files_;
+    std::atomic<std::shared_ptr<const GlossarySnapshot>> current_;
+    std::vector<GlossaryFileStamp> built_;    // stamps the current snapshot was read at
+    std::vector<GlossaryFileStamp> pending_;  // changed stamps seen by the last check
+};
+
+/**
+ * Glossary sets keyed by file list, so talkgroups sharing a list share
+ * one set
+ */
+class GlossaryCache {
+public:
+    std::shared_ptr<GlossarySet> get(const std::vector<std::string>& files);
+    size_t size() const;
+
+    /** reloadIfChanged() on every set; the number reloaded */
+    size_t reloadChanged();
+
+private:
+    mutable std::mutex mutex_;
+    std::map<std::vector<std::string>, std::shared_ptr<GlossarySet>> sets_;
+};
+
+/**
+ * Background thread that reloads a cache's changed glossaries
+ * (GLOSSARY_RELOAD_SECONDS); stops when destroyed
+ */
+class GlossaryWatcher {
+public:
+    GlossaryWatcher(GlossaryCache& cache, std::chrono::milliseconds interval);
+    ~GlossaryWatcher();
+    GlossaryWatcher(const GlossaryWatcher&) = delete;
+    GlossaryWatcher& operator=(const GlossaryWatcher&) = delete;
+
+private:
+    void run();
+
+    GlossaryCache& cache_;
+    std::chrono::milliseconds interval_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+} // namespace sdrtrunk
@@ -1,12 +1,70 @@
 #pragma once
 
+#include <span>
 #include <string>
+#include <vector>
 #include "Result.h"
 
 namespace sdrtrunk {
 
+class RecordingFile;
+
+// Whisper models consume 16 kHz mono float32 PCM
+inline constexpr int WHISPER_SAMPLE_RATE = 16000;
+
+/**
+ * Decoded mono float32 PCM audio
+ */
+struct PcmBuffer {
+    std::vector<float> samples;
+    int sampleRate = WHISPER_SAMPLE_RATE;
+
+    double durationSeconds() const {
+        return sampleRate > 0 ? static_cast<double>(samples.size()) / sampleRate : 0.0;
+    }
+};
+
 /**
- * Get MP3 file duration using libmpg123
+ * Duration and stream format of a recording
+ *
+ * What the pipeline probes before deciding whether and how to transcribe
+ * a file; kept in the audio_metadata table so a revisited file is not
+ * probed again.
+ */
+struct AudioMetadata {
+    double durationSeconds = 0.0;
+    int sampleRate = 0;   // 0 when no frame header was found
+    int channels = 0;
+    int bitrateKbps = 0;  // of the first frame; VBR streams vary
+    std::string format;   // e.g. "MPEG-2.5 Layer III"
+};
+
+/**
+ * Get MP3 file duration
+ *
+ * The file is opened as a RecordingFile (memory-mapped) and the duration
+ * is read from the first frames (see parseMP3HeaderDuration), which only
+ * touches a few pages.
+ * Files without a usable header, or whose header disagrees with the file
+ * size, fall back to scanMP3Duration().
+ *
+ * @param filepath Path to the MP3 file
+ * @return Duration in seconds, or error if parsing fails
+ */
+Result<double> getMP3Duration(const std::string& filepath);
+
+/**
+ * Get MP3 duration from a recording that is already open
+ */
+Result<double> getMP3Duration(const RecordingFile& file);
+
+/**
+ * Duration (as getMP3Duration) plus the first frame's format
+ */
+Result<AudioMetadata> probeMP3Metadata(const RecordingFile& file);
+
+/**
+ * Get MP3 file duration by scanning every frame with libmpg123
  *
  * This uses the battle-tested libmpg123 library which provides:
  * - Accurate frame counting and duration calculation
@@ -17,6 +75,48 @@ namespace sdrtrunk {
  * @param filepath Path to the MP3 file
  * @return Duration in seconds, or error if parsing fails
  */
-Result<double> getMP3Duration(const std::string& filepath);
+Result<double> scanMP3Duration(const std::string& filepath);
+Result<double> scanMP3Duration(const RecordingFile& file);
+
+/**
+ * Duration from MP3 headers without walking the whole file
+ *
+ * Uses, in order: a Xing/Info frame count (minus LAME encoder delay and
+ * padding, as mpg123 does for gapless playback), a VBRI frame count, or
+ * CBR arithmetic from the first frame's bitrate and the audio size. The
+ * CBR path first checks that the leading frames share one bitrate, so a
+ * VBR file without a header is rejected rather than misestimated.
+ *
+ * @param file Complete file contents (normally a read-only mapping);
+ *             only the leading frames and the last 128 bytes are read
+ * @return Duration in seconds, or InvalidFormat when no header is usable
+ *         or the header is inconsistent with the file size
+ */
+Result<double> parseMP3HeaderDuration(std::span<const unsigned char> file);
+
+/**
+ * Decode an MP3 file to 16 kHz mono float32 PCM using libmpg123
+ *
+ * mpg123 decodes to int16 at the native rate (8/22.05/44.1 kHz for
+ * SDRTrunk); PolyphaseResampler mixes it down and converts it to
+ * WHISPER_SAMPLE_RATE, so the result can be handed straight to the local
+ * Whisper model.
+ *
+ * @param filepath Path to the MP3 file
+ * @return Decoded PCM, or error if decoding fails
+ */
+Result<PcmBuffer> decodeMP3ToPcm(const std::string& filepath);
+
+/**
+ * Decode an already open recording (see RecordingFile) without reopening it
+ */
+Result<PcmBuffer> decodeMP3ToPcm(const RecordingFile& file);
+
+/**
+ * Resample mono float PCM from inRate to outRate (linear interpolation)
+ *
+ * No anti-aliasing; decodes use PolyphaseResampler instead.
+ */
+std::vector<float> resamplePcm(std::span<const float> input, int inRate, int outRate);
 
-} // namespace sdrtrunk
\ No newline at end of file
+} // namespace sdrtrunk
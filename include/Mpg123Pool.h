@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include "Result.h"
+
+// libmpg123's opaque handle; mpg123.h is only needed where the handle is used
+typedef struct mpg123_handle_struct mpg123_handle;
+
+namespace sdrtrunk {
+
+/**
+ * A configured mpg123 handle borrowed from the calling thread's pool
+ *
+ * mpg123_new() and flag setup happen once per thread and flag set; each
+ * lease only opens a stream on an already configured handle. Destroying
+ * the lease closes the stream (and the file descriptor, if the lease
+ * opened it), resets any output format restrictions and returns the handle
+ * to the pool of the thread that releases it.
+ */
+class Mpg123Lease {
+public:
+    Mpg123Lease(Mpg123Lease&& other) noexcept;
+    Mpg123Lease& operator=(Mpg123Lease&& other) noexcept;
+    Mpg123Lease(const Mpg123Lease&) = delete;
+    Mpg123Lease& operator=(const Mpg123Lease&) = delete;
+    ~Mpg123Lease();
+
+    mpg123_handle* get() const { return handle_; }
+
+private:
+    friend Result<Mpg123Lease> openMpg123File(const std::string& filepath, long flags);
+    friend Result<Mpg123Lease> openMpg123Fd(int fd, long flags);
+    friend Result<Mpg123Lease> openMpg123Feed(long flags);
+
+    Mpg123Lease(mpg123_handle* handle, long flags) : handle_(handle), flags_(flags) {}
+    void release();
+
+    mpg123_handle* handle_ = nullptr;
+    long flags_ = 0;
+    int ownedFd_ = -1;
+};
+
+/**
+ * Open a file on a pooled handle
+ *
+ * @param filepath Path to the MP3 file; opened with open() and handed to
+ *                 mpg123_open_fd() (mpg123_open() on Windows)
+ * @param flags MPG123_* flags added to a new handle, e.g. MPG123_GAPLESS;
+ *              handles are only reused for the same flags
+ * @return Lease with the stream open, or FileNotFound
+ */
+Result<Mpg123Lease> openMpg123File(const std::string& filepath, long flags);
+
+/**
+ * Open an already open file descriptor on a pooled handle
+ *
+ * The descriptor stays owned by the caller and must outlive the lease.
+ */
+Result<Mpg123Lease> openMpg123Fd(int fd, long flags);
+
+/**
+ * Open a pooled handle in feed mode (data pushed with mpg123_feed/decode)
+ */
+Result<Mpg123Lease> openMpg123Feed(long flags);
+
+/**
+ * Handle reuse counters for the calling thread
+ */
+struct Mpg123PoolStats {
+    size_t created = 0;  // mpg123_new() calls
+    size_t reused = 0;   // leases served from the idle list
+    size_t idle = 0;     // handles currently pooled
+};
+
+Mpg123PoolStats mpg123ThreadPoolStats();
+
+} // namespace sdrtrunk
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "AudioConvert.h"
+#include "MP3Duration.h"
+#include "Mpg123Pool.h"
+#include "Result.h"
+
+namespace sdrtrunk {
+
+class RecordingFile;
+
+// 10.24 s at 16 kHz; a whole number of 32 ms VAD frames, so blockwise
+// voice-activity counts add up to the whole-recording result
+inline constexpr size_t PCM_BLOCK_SAMPLES = 512 * 320;
+
+/**
+ * Process-wide cap on decoded PCM held by concurrent decodes
+ * (DECODE_MEMORY_CAP_MB)
+ *
+ * A decode reserves its whole working set before it starts and keeps the
+ * reservation until its samples are dropped. reserve() blocks while the
+ * reservation would take the total over the cap; a single reservation
+ * larger than the cap waits until nothing else is reserved, so it is
+ * delayed rather than refused. Reserving everything up front means a
+ * decode never waits while holding part of the budget, so concurrent
+ * decodes cannot deadlock each other.
+ */
+class DecodeMemoryBudget {
+public:
+    /**
+     * Bytes held against a budget; released on destruction
+     */
+    class Reservation {
+    public:
+        Reservation() = default;
+        Reservation(Reservation&& other) noexcept;
+        Reservation& operator=(Reservation&& other) noexcept;
+        Reservation(const Reservation&) = delete;
+        Reservation& operator=(const Reservation&) = delete;
+        ~Reservation();
+
+        size_t bytes() const { return bytes_; }
+
+    private:
+        friend class DecodeMemoryBudget;
+        Reservation(DecodeMemoryBudget* budget, size_t bytes) : budget_(budget), bytes_(bytes) {}
+        void release();
+
+        DecodeMemoryBudget* budget_ = nullptr;
+        size_t bytes_ = 0;
+    };
+
+    /** @param capBytes 0 means unlimited */
+    explicit DecodeMemoryBudget(size_t capBytes = 0) : cap_(capBytes) {}
+
+    /** The budget shared by every decode in the process */
+    static DecodeMemoryBudget& instance();
+
+    void setCapBytes(size_t capBytes);
+    size_t capBytes() const;
+
+    /** Block until bytes fit under the cap, then hold them */
+    Reservation reserve(size_t bytes);
+
+    /** Hold bytes if they fit now */
+    std::optional<Reservation> tryReserve(size_t bytes);
+
+    size_t reservedBytes() const;
+
+    /** Highest reservedBytes() seen */
+    size_t peakBytes() const;
+
+private:
+    bool fits(size_t bytes) const;
+    Reservation grant(size_t bytes);
+    void release(size_t bytes);
+
+    mutable std::mutex mutex_;
+    std::condition_variable released_;
+    size_t cap_;
+    size_t reserved_ = 0;
+    size_t peak_ = 0;
+};
+
+/** Bytes of a whole decode of seconds of audio at WHISPER_SAMPLE_RATE */
+size_t wholeDecodeBytes(double seconds);
+
+/**
+ * Whether a whole decode of seconds of audio is larger than the process
+ * cap; such recordings are streamed instead of decoded whole
+ */
+bool exceedsDecodeBudget(double seconds);
+
+/**
+ * Samples of a whole decode and their reservation against
+ * DecodeMemoryBudget::instance(), released together
+ */
+struct BudgetedPcm {
+    PcmBuffer pcm;
+    DecodeMemoryBudget::Reservation reservation;
+};
+
+/**
+ * decodeMP3ToPcm() after reserving the decode's size against the process
+ * budget. durationSeconds <= 0 reads the duration from the frame headers;
+ * when that fails too, the decoded size is reserved once it is known.
+ */
+Result<BudgetedPcm> decodeWithinBudget(const RecordingFile& file, double durationSeconds = 0.0);
+Result<BudgetedPcm> decodeWithinBudget(const std::string& path, double durationSeconds = 0.0);
+
+/**
+ * Recycled PCM block buffers shared by every PcmStream
+ *
+ * Each stream takes one buffer when it opens and gives it back when it
+ * is destroyed, so a steady stream of recordings allocates no new block
+ * buffers once the pool has warmed up.
+ */
+class PcmBlockPool {
+public:
+    static PcmBlockPool& instance();
+
+    /** Empty buffer with capacity for a block plus one decode read */
+    std::vector<float> acquire();
+    void release(std::vector<float>&& block);
+
+    size_t idle() const;
+    size_t created() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<std::vector<float>> idle_;
+    size_t created_ = 0;
+};
+
+/**
+ * Streaming decode of an MP3 recording to 16 kHz mono float32 PCM
+ *
+ * The memory-mapped file is pushed through mpg123's feed API in small
+ * slices and resampled with PolyphaseResampler, so memory use is one
+ * PCM_BLOCK_SAMPLES block however long the recording is. Blocks are
+ * exactly PCM_BLOCK_SAMPLES except the last, and concatenated they equal
+ * decodeMP3ToPcm() output.
+ *
+ * A stream is used by one thread at a time; the file must outlive it.
+ */
+class PcmStream {
+public:
+    static Result<PcmStream> open(const RecordingFile& file);
+
+    PcmStream(PcmStream&& other) noexcept = default;
+    PcmStream& operator=(PcmStream&& other) noexcept = default;
+    PcmStream(const PcmStream&) = delete;
+    PcmStream& operator=(const PcmStream&) = delete;
+    ~PcmStream();
+
+    /**
+     * The next block, valid until the following call; empty at the end
+     * of the recording
+     */
+    Result<std::span<const float>> next();
+
+    /** Heap bytes a stream holds while decoding, for DecodeMemoryBudget */
+    static size_t workingSetBytes();
+
+    /** Samples returned so far */
+    uint64_t samplesDecoded() const { return decoded_; }
+
+private:
+    PcmStream(Mpg123Lease lease, std::span<const unsigned char> input, std::string path);
+    Result<bool> decodeMore();
+
+    Mpg123Lease lease_;
+    std::span<const unsigned char> input_;
+    size_t fed_ = 0;
+    std::string path_;
+    std::optional<PolyphaseResampler> resampler_;  // created once the format is known
+    long nativeRate_ = 0;
+    int channels_ = 0;
+    std::vector<int16_t> scratch_;
+    std::vector<float> buffer_;  // from PcmBlockPool
+    size_t emitted_ = 0;         // leading samples of buffer_ handed out by the last next()
+    uint64_t decoded_ = 0;
+    bool finished_ = false;
+};
+
+} // namespace sdrtrunk
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+#include "Result.h"
+
+namespace sdrtrunk {
+
+/**
+ * Which file, and which version of it, a recording is
+ *
+ * From the fstat() at open(). The same (device, inode) with a different
+ * size or modification time is a rewritten file. Windows has no inode
+ * here, so identities there are never valid().
+ */
+struct FileIdentity {
+    uint64_t device = 0;
+    uint64_t inode = 0;
+    uint64_t size = 0;
+    int64_t mtimeNs = 0;
+
+    bool valid() const { return inode != 0; }
+    bool operator==(const FileIdentity&) const = default;
+};
+
+/**
+ * A recording opened once for every pipeline stage
+ *
+ * open() does one open(), one fstat() and one mmap() (a single read() if
+ * the file cannot be mapped, and on Windows). Duration probing, the
+ * voice-activity/PCM decode, the OpenAI upload and local transcription
+ * all read from this object instead of reopening the path.
+ *
+ * The descriptor's file offset is shared: consumers that read through
+ * fd() rewind it first, and a recording is only used by one pipeline
+ * stage at a time.
+ */
+class RecordingFile {
+public:
+    static Result<RecordingFile> open(const std::string& filepath);
+
+    RecordingFile(RecordingFile&& other) noexcept;
+    RecordingFile& operator=(RecordingFile&& other) noexcept;
+    RecordingFile(const RecordingFile&) = delete;
+    RecordingFile& operator=(const RecordingFile&) = delete;
+    ~RecordingFile();
+
+    const std::string& path() const { return path_; }
+
+    /** File contents as of open() */
+    std::span<const unsigned char> bytes() const { return {data_, size_}; }
+
+    /** Size from the fstat() at open() */
+    uint64_t size() const { return size_; }
+
+    const FileIdentity& identity() const { return identity_; }
+
+    /** Open descriptor, or -1 where the file is read into memory instead */
+    int fd() const { return fd_; }
+
+    /**
+     * Whether the writer has appended since open()
+     *
+     * Re-stats the open descriptor rather than the path.
+     */
+    bool hasGrown() const;
+
+private:
+    RecordingFile() = default;
+    void reset();
+
+    std::string path_;
+    int fd_ = -1;
+    const unsigned char* data_ = nullptr;
+    size_t size_ = 0;
+    bool mapped_ = false;
+    std::vector<unsigned char> buffer_;  // used when the file is not mapped
+    FileIdentity identity_;
+};
+
+} // namespace sdrtrunk
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace sdrtrunk {
+
+/**
+ * Days since 1970-01-01 of a proleptic Gregorian date
+ *
+ * Howard Hinnant's days_from_civil; month and day are not range checked,
+ * so day 0 or 32 land on the neighbouring month the way mktime()
+ * normalizes them.
+ */
+constexpr int64_t daysFromCivil(int64_t year, unsigned month, unsigned day) noexcept {
+    year -= month <= 2 ? 1 : 0;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const auto yoe = static_cast<unsigned>(year - era * 400);                // [0, 399]
+    const unsigned doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;  // [0, 365]
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;              // [0, 146096]
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+static_assert(daysFromCivil(1970, 1, 1) == 0);
+static_assert(daysFromCivil(2000, 3, 1) == 11017);
+static_assert(daysFromCivil(2024, 2, 29) == 19782);
+
+/**
+ * Wall-clock seconds of an SDRTrunk "YYYYMMDD" date and "hhmmss" time,
+ * counted as if the wall clock were UTC
+ *
+ * nullopt unless both are all digits with the month, hour, minute and
+ * second in range.
+ */
+constexpr std::optional<int64_t> parseRecordingWallClock(std::string_view date, std::string_view time) noexcept {
+    if (date.size() != 8 || time.size() != 6) {
+        return std::nullopt;
+    }
+    auto number = [](std::string_view digits) -> std::optional<unsigned> {
+        unsigned value = 0;
+        for (char c : digits) {
+            if (c < '0' || c > '9') {
+                return std::nullopt;
+            }
+            value = value * 10 + static_cast<unsigned>(c - '0');
+        }
+        return value;
+    };
+    const auto year = number(date.substr(0, 4));
+    const auto month = number(date.substr(4, 2));
+    const auto day = number(date.substr(6, 2));
+    const auto hour = number(time.substr(0, 2));
+    const auto minute = number(time.substr(2, 2));
+    const auto second = number(time.substr(4, 2));
+    if (!year || !month || !day || !hour || !minute || !second ||
+        *month < 1 || *month > 12 || *day < 1 || *day > 31 || *hour > 23 || *minute > 59 || *second > 60) {
+        return std::nullopt;
+    }
+    return daysFromCivil(*year, *month, *day) * 86400 + *hour * 3600 + *minute * 60 + *second;
+}
+
+static_assert(parseRecordingWallClock("20240115", "143045") == 1705329045);
+static_assert(!parseRecordingWallClock("2024011", "143045"));
+static_assert(!parseRecordingWallClock("20241315", "143045"));
+
+/**
+ * Unix time of a wall-clock time in the local time zone
+ *
+ * Every time is read with the zone's standard UTC offset, as mktime()
+ * reads a tm with tm_isdst = 0, so results match rows stored by the
+ * earlier get_time()/mktime() conversion: times during DST are not moved
+ * an hour back. The offset is looked up once per DST period and cached
+ * per thread, so converting recordings from the same period takes no
+ * lock and does not allocate; mktime() takes glibc's time zone lock on
+ * every call. When the standard offset itself changes, repeated times
+ * resolve to the first occurrence and skipped times use the offset from
+ * before the change.
+ */
+int64_t localWallClockToUnix(int64_t wallClockSeconds);
+
+/**
+ * Unix time of a recording's date and time fields; nullopt when they
+ * cannot be parsed
+ */
+std::optional<int64_t> recordingUnixTime(std::string_view date, std::string_view time);
+
+/**
+ * Drop every thread's cached offsets, after TZ has changed
+ */
+void reloadLocalTimeZone();
+
+} // namespace sdrtrunk
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <string>
+
+#include "DatabaseManager.h"
+#include "Result.h"
+#include "transcriptionProcessor.h"
+
+namespace sdrtrunk {
+
+/**
+ * How --reenrich walks the recordings table
+ */
+struct ReenrichOptions {
+    TranscriptionFilter filter;
+    size_t batchSize = 10000;  // rows read, and at most rows written, per transaction
+    size_t threads = 1;
+};
+
+struct ReenrichStats {
+    size_t scanned = 0;
+    size_t updated = 0;
+    size_t unchanged = 0;
+    size_t failed = 0;  // stored transcription has no text to enrich
+};
+
+/**
+ * Filter for --reenrich: one talkgroup and/or local dates "YYYYMMDD",
+ * both ends inclusive and either may be empty
+ */
+Result<TranscriptionFilter> reenrichFilter(std::optional<int> talkgroupID, const std::string& fromDate,
+                                           const std::string& toDate);
+
+/**
+ * Re-run generateV2Transcription() on stored transcriptions after a
+ * glossary change, without the audio or the transcription API
+ *
+ * Rows are read in id-ordered batches, enriched on options.threads
+ * workers, and the rows whose v2transcription changed are written back
+ * in one transaction per batch while the next batch is enriched. Stops
+ * after the current batch when cancel becomes true.
+ */
+ReenrichStats reenrichTranscriptions(DatabaseManager& db, const TalkgroupProfiles& talkgroupFiles,
+                                     const ReenrichOptions& options, const std::atomic<bool>* cancel = nullptr);
+
+} // namespace sdrtrunk
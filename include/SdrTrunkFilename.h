@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace sdrtrunk {
+
+// Patch members kept per recording; SDRTrunk rarely patches more than four
+inline constexpr size_t MAX_PATCH_MEMBERS = 16;
+
+/**
+ * Fields of an SDRTrunk recording filename
+ *
+ *   20260208_121343_NC-VIPER__TO_P52197-[52198--51426]_V2_FROM_2499936.mp3
+ *   date     time   name        patch  members           ver  radio
+ *
+ * Older SDRTrunk versions run the name straight on from the time
+ * (20250715_112349Name__TO_...) and write legacy patches as TO_P_52198.
+ * The views point into the parsed string, which must outlive them.
+ */
+struct SdrTrunkFilename {
+    std::string_view filename;
+    std::string_view date;  // YYYYMMDD; empty when the name is too short
+    std::string_view time;  // HHMMSS
+    std::string_view name;  // talkgroup or system name; empty without "__TO_"
+
+    // Primary talkgroup: the first patch member, else the TO_ number
+    std::optional<int> talkgroup;
+    std::optional<int> patchGroup;  // P-group of a patched call
+    std::array<int, MAX_PATCH_MEMBERS> patchMembers{};
+    size_t patchMemberCount = 0;
+    std::optional<int> radioId;
+    int version = 1;  // _V2 and later re-recordings
+
+    std::span<const int> members() const { return {patchMembers.data(), patchMemberCount}; }
+};
+
+/**
+ * Parse an SDRTrunk filename in one pass without allocating
+ *
+ * Matches what the original std::regex patterns accepted: a P-group's
+ * talkgroup is the first bracketed number ("\[(\d+)"), else the P number
+ * ("TO_P_?(\d+)"); other recordings use the first "TO_(\d+)"; the radio
+ * is the first "_FROM_(\d+)". Numbers too large for an int count as
+ * absent.
+ */
+SdrTrunkFilename parseSdrTrunkFilename(std::string_view filename);
+
+/**
+ * Every talkgroup a recording was heard on, primary first: the primary
+ * talkgroup, the other patch members, then the patch group. Empty when
+ * the name has no talkgroup.
+ */
+std::vector<int> recordingTalkgroups(const SdrTrunkFilename& parsed);
+
+} // namespace sdrtrunk
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "DecodeProfile.h"
+#include "Glossary.h"
+
+struct TalkgroupFiles
+{
+    std::vector<std::string> glossaryFiles;
+    std::string prompt;
+    std::optional<sdrtrunk::DecodeProfile> decodeProfile;  // DECODE_PROFILE; unset = backend defaults
+    // Merged glossaryFiles, shared by talkgroups with the same list and
+    // reloaded as the files change; the files are read on each call when unset
+    std::shared_ptr<const sdrtrunk::GlossarySet> glossary;
+
+    bool operator==(const TalkgroupFiles&) const = default;
+};
+
+namespace sdrtrunk {
+
+/** Inclusive run of talkgroup IDs */
+struct TalkgroupRange {
+    int first;
+    int last;
+};
+
+/**
+ * Ranges of a TALKGROUP_FILES key such as "52197-52201,28513", in key
+ * order; a reversed range is dropped. Throws like std::stoi on a
+ * malformed ID.
+ */
+std::vector<TalkgroupRange> parseTalkgroupRanges(const std::string& idString);
+
+/**
+ * TALKGROUP_FILES settings by talkgroup ID
+ *
+ * Stored as a sorted table of disjoint ID intervals, each pointing at a
+ * shared TalkgroupFiles, so a key like "1-65535" is one entry rather than
+ * one per ID and lookup is a binary search. Equal settings under several
+ * keys share one profile. Reads look like a const
+ * std::unordered_map<int, TalkgroupFiles>; iteration visits every ID in
+ * ascending order.
+ */
+class TalkgroupProfiles {
+    struct Interval {
+        int first;
+        int last;
+        std::shared_ptr<const TalkgroupFiles> profile;
+    };
+
+public:
+    struct Entry {
+        int first;  // talkgroup ID
+        const TalkgroupFiles& second;
+    };
+
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Entry;
+        using difference_type = std::ptrdiff_t;
+        using reference = Entry;
+
+        struct ArrowProxy {
+            Entry entry;
+            const Entry* operator->() const { return &entry; }
+        };
+
+        const_iterator() = default;
+        Entry operator*() const { return {id_, *(*intervals_)[index_].profile}; }
+        ArrowProxy operator->() const { return {**this}; }
+        const_iterator& operator++() {
+            if (id_ == (*intervals_)[index_].last) {
+                ++index_;
+                id_ = index_ < intervals_->size() ? (*intervals_)[index_].first : 0;
+            } else {
+                ++id_;
+            }
+            return *this;
+        }
+        const_iterator operator++(int) {
+            auto previous = *this;
+            ++*this;
+            return previous;
+        }
+        bool operator==(const const_iterator&) const = default;
+
+    private:
+        friend class TalkgroupProfiles;
+        const_iterator(const std::vector<Interval>* intervals, size_t index, int id)
+            : intervals_(intervals), index_(index), id_(id) {}
+        const std::vector<Interval>* intervals_ = nullptr;
+        size_t index_ = 0;
+        int id_ = 0;
+    };
+
+    /**
+     * Give the IDs in ranges the settings files, replacing what they had;
+     * the stored profile is shared with any talkgroup given equal settings
+     */
+    void assign(const std::vector<TalkgroupRange>& ranges, TalkgroupFiles files);
+
+    /** Settings of a talkgroup, nullptr for one not configured */
+    const TalkgroupFiles* lookup(int talkgroupID) const;
+
+    /** Distinct profiles stored */
+    size_t profileCount() const { return profiles_.size(); }
+
+    /** Entries in the interval table */
+    size_t intervalCount() const { return intervals_.size(); }
+
+    size_t size() const { return talkgroupCount_; }
+    bool empty() const { return intervals_.empty(); }
+    size_t count(int talkgroupID) const { return lookup(talkgroupID) ? 1 : 0; }
+    const_iterator begin() const;
+    const_iterator end() const { return const_iterator(&intervals_, intervals_.size(), 0); }
+    const_iterator find(int talkgroupID) const;
+
+    /** Throws std::out_of_range for a talkgroup not configured */
+    const TalkgroupFiles& at(int talkgroupID) const;
+
+private:
+    // Index of the interval holding talkgroupID, or intervals_.size()
+    size_t locate(int talkgroupID) const;
+    void insert(const TalkgroupRange& range, const std::shared_ptr<const TalkgroupFiles>& profile);
+
+    std::vector<std::shared_ptr<const TalkgroupFiles>> profiles_;
+    std::vector<Interval> intervals_;  // sorted by first, disjoint
+    size_t talkgroupCount_ = 0;
+};
+
+} // namespace sdrtrunk
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "TranscriptionBackend.h"
+
+namespace sdrtrunk {
+
+/**
+ * Confidence fields reported alongside a transcription
+ *
+ * A missing field is ignored by the escalation decision; a result
+ * missing both carries no confidence and is escalated.
+ */
+struct TranscriptionConfidence {
+    std::optional<double> avgLogprob;
+    std::optional<double> noSpeechProb;
+};
+
+/**
+ * Read avg_logprob / no_speech_prob from a backend's JSON response
+ */
+TranscriptionConfidence parseTranscriptionConfidence(std::string_view json);
+
+/**
+ * When a draft result is trusted
+ */
+struct TierThresholds {
+    double minAvgLogprob = -0.6;   // escalate below this
+    double maxNoSpeechProb = 0.6;  // escalate above this
+};
+
+/**
+ * Two-tier speculative transcription
+ *
+ * Every recording is first transcribed by a cheap draft backend (small
+ * model, greedy decoding). Only results below the confidence thresholds,
+ * results without any confidence, or drafts that fail, are re-run on the
+ * full backend. When both backends take PCM the recording is decoded
+ * once and shared by both passes.
+ *
+ * Saved compute is estimated from the full backend's measured
+ * real-time factor (wall seconds per audio second) on escalations.
+ */
+class TieredBackend : public TranscriptionBackend {
+public:
+    TieredBackend(std::shared_ptr<TranscriptionBackend> draft,
+                  std::shared_ptr<TranscriptionBackend> full,
+                  TierThresholds thresholds = {});
+
+    Result<std::string> transcribe(const TranscriptionRequest& request) override;
+    std::string name() const override;
+    bool consumesPcm() const override { return draft_->consumesPcm() && full_->consumesPcm(); }
+    bool transcribesConcurrently() const override {
+        return draft_->transcribesConcurrently() && full_->transcribesConcurrently();
+    }
+
+    bool shouldEscalate(const TranscriptionConfidence& confidence) const;
+
+private:
+    double estimateFullSeconds(double audioSeconds) const;
+    void recordFullRun(double audioSeconds, double wallSeconds);
+
+    std::shared_ptr<TranscriptionBackend> draft_;
+    std::shared_ptr<TranscriptionBackend> full_;
+    TierThresholds thresholds_;
+
+    mutable std::mutex rtfMutex_;
+    double fullAudioSeconds_ = 0.0;
+    double fullWallSeconds_ = 0.0;
+};
+
+} // namespace sdrtrunk
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "DecodeProfile.h"
+#include "MP3Duration.h"
+#include "PcmStream.h"
+#include "Result.h"
+
+namespace sdrtrunk {
+
+class RecordingFile;
+
+/**
+ * Which tier produced a tiered transcription and what it cost
+ */
+struct TierOutcome {
+    bool tiered = false;          // set once a TieredBackend handled the request
+    bool escalated = false;       // re-run with the full model
+    double draftSeconds = 0.0;    // wall time of the draft pass
+    double fullSeconds = 0.0;     // wall time of the full pass (0 if not run)
+    double savedSeconds = 0.0;    // estimated full-model time avoided
+};
+
+/**
+ * One recording to transcribe
+ *
+ * pcm is optional: when a pipeline stage has already decoded the
+ * recording, backends that consume samples use it instead of decoding
+ * the file again. decodeProfile carries the talkgroup's DECODE_PROFILE to
+ * local backends (null = backend defaults). tierOutcome, when set, is
+ * filled in by tiered backends. file, when set, is the recording already
+ * opened by the pipeline; backends decode or upload from it instead of
+ * reopening filePath.
+ */
+struct TranscriptionRequest {
+    std::string filePath;
+    std::string prompt;
+    int talkgroupId = 0;
+    double durationSeconds = 0.0;
+    const PcmBuffer* pcm = nullptr;
+    const DecodeProfile* decodeProfile = nullptr;
+    TierOutcome* tierOutcome = nullptr;
+    const RecordingFile* file = nullptr;
+};
+
+/**
+ * Decode a request's recording to 16 kHz PCM, from request.file if set;
+ * the samples hold their size against DecodeMemoryBudget until dropped
+ */
+Result<BudgetedPcm> decodeRequestAudio(const TranscriptionRequest& request);
+
+/**
+ * A transcription engine (OpenAI API, faster-whisper, whisper.cpp, ...)
+ *
+ * Implementations must be safe to call from several pool workers at once.
+ * On success the result is the Whisper-style JSON response, e.g.
+ * {"text":"..."}, which extractActualTranscription() understands.
+ */
+class TranscriptionBackend {
+public:
+    virtual ~TranscriptionBackend() = default;
+
+    virtual Result<std::string> transcribe(const TranscriptionRequest& request) = 0;
+    virtual std::string name() const = 0;
+
+    /** Whether request.pcm, when set, is transcribed instead of the file */
+    virtual bool consumesPcm() const { return false; }
+
+    /**
+     * Whether calls from several threads actually run at the same time,
+     * rather than queueing on a lock inside the engine
+     */
+    virtual bool transcribesConcurrently() const { return true; }
+
+    /**
+     * Whether an undecoded recording of this length is streamed in
+     * chunks rather than decoded whole
+     */
+    virtual bool streamsRecording(double /*durationSeconds*/) const { return false; }
+};
+
+/**
+ * OpenAI Whisper API over libcurl (curl_transcribe_audio)
+ */
+class OpenAIBackend : public TranscriptionBackend {
+public:
+    explicit OpenAIBackend(std::string apiKey) : apiKey_(std::move(apiKey)) {}
+
+    Result<std::string> transcribe(const TranscriptionRequest& request) override;
+    std::string name() const override { return "openai"; }
+
+private:
+    std::string apiKey_;
+};
+
+/**
+ * faster-whisper through the embedded Python module (local_transcribe_audio)
+ *
+ * model selects a faster-whisper model size (e.g. "small.en"); empty uses
+ * the module default.
+ */
+class FasterWhisperBackend : public TranscriptionBackend {
+public:
+    explicit FasterWhisperBackend(std::string model = "") : model_(std::move(model)) {}
+
+    Result<std::string> transcribe(const TranscriptionRequest& request) override;
+    std::string name() const override { return model_.empty() ? "faster-whisper" : "faster-whisper:" + model_; }
+    bool consumesPcm() const override;
+    // local_transcribe_audio() holds one process-wide model lock per call
+    bool transcribesConcurrently() const override { return false; }
+
+private:
+    std::string model_;
+};
+
+/**
+ * Build the {"text":"..."} response for backends that produce plain text
+ */
+inline std::string makeTranscriptionJson(std::string_view text) {
+    static constexpr char hex[] = "0123456789abcdef";
+    std::string json = "{\"text\":\"";
+    json.reserve(json.size() + text.size() + 2);
+    for (char c : text) {
+        switch (c) {
+            case '"': json += "\\\""; break;
+            case '\\': json += "\\\\"; break;
+            case '\n': json += "\\n"; break;
+            case '\r': json += "\\r"; break;
+            case '\t': json += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    json += "\\u00";
+                    json += hex[(c >> 4) & 0x0F];
+                    json += hex[c & 0x0F];
+                } else {
+                    json += c;
+                }
+        }
+    }
+    json += "\"}";
+    return json;
+}
+
+/**
+ * Build {"text":"...","avg_logprob":x} for backends that report confidence
+ */
+inline std::string makeTranscriptionJson(std::string_view text, double avgLogprob) {
+    std::string json = makeTranscriptionJson(text);
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), ",\"avg_logprob\":%.4f}", avgLogprob);
+    json.pop_back();
+    json += buffer;
+    return json;
+}
+
+} // namespace sdrtrunk
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_set>
+
+#include "TranscriptionBackend.h"
+
+namespace sdrtrunk {
+
+/**
+ * Rules for splitting recordings between the local and remote backends
+ *
+ * A value of 0 disables the corresponding limit.
+ */
+struct RoutingRules {
+    // Recordings longer than this go remote
+    double localMaxDurationSeconds = 0.0;
+    // Once this many local transcriptions are running, overflow goes remote
+    int localMaxInFlight = 0;
+    // Remote is only used while at least this many API requests remain in
+    // the rate-limit window; otherwise work stays local
+    int remoteMinHeadroom = 1;
+    // Talkgroups pinned to one side regardless of the rules above
+    std::unordered_set<int> localTalkgroups;
+    std::unordered_set<int> remoteTalkgroups;
+};
+
+enum class Route { Local, Remote };
+
+/**
+ * Hybrid local/remote transcription
+ *
+ * Picks a backend per recording from its talkgroup and duration, the
+ * number of local transcriptions currently in flight and the remaining
+ * remote rate-limit headroom, so short clips can stay on the local
+ * GPU/CPU while long ones or overflow spill to the cloud.
+ */
+class TranscriptionRouter : public TranscriptionBackend {
+public:
+    // Returns requests still available in the current remote rate-limit window
+    using HeadroomFn = std::function<int()>;
+
+    TranscriptionRouter(std::shared_ptr<TranscriptionBackend> local,
+                        std::shared_ptr<TranscriptionBackend> remote,
+                        RoutingRules rules,
+                        HeadroomFn remoteHeadroom);
+
+    Result<std::string> transcribe(const TranscriptionRequest& request) override;
+    std::string name() const override { return "hybrid"; }
+
+    /**
+     * Routing decision for a request given the current load
+     */
+    Route choose(const TranscriptionRequest& request) const;
+
+    int localInFlight() const { return localInFlight_.load(); }
+
+private:
+    // choose() without the in-flight limit; limited is set when a Local
+    // result still needs a free slot under localMaxInFlight
+    Route preferredRoute(const TranscriptionRequest& request, bool& limited) const;
+    // Take a local slot only while fewer than localMaxInFlight are taken
+    bool tryAcquireLocalSlot();
+
+    std::shared_ptr<TranscriptionBackend> local_;
+    std::shared_ptr<TranscriptionBackend> remote_;
+    RoutingRules rules_;
+    HeadroomFn remoteHeadroom_;
+    std::atomic<int> localInFlight_{0};
+};
+
+const char* routeToString(Route route);
+
+} // namespace sdrtrunk
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace sdrtrunk {
+
+/**
+ * Thresholds for the pre-transcription voice-activity gate
+ *
+ * A frame counts as speech when it is loud enough, its zero-crossing rate
+ * is below broadband-noise levels and its spectrum is not flat. Dead air
+ * fails the energy test; encrypted audio and static fail ZCR/flatness.
+ */
+struct VadConfig {
+    int frameSamples = 512;            // 32 ms at 16 kHz
+    double energyThresholdDb = -45.0;  // frame RMS in dBFS
+    double maxZeroCrossingRate = 0.45; // crossings per sample
+    double maxSpectralFlatness = 0.40; // 0 = pure tone, ~0.56 = white noise
+    double minSpeechRatio = 0.10;      // speech frames / frames to transcribe
+};
+
+/**
+ * Frame statistics for one recording
+ */
+struct VadResult {
+    size_t frames = 0;
+    size_t speechFrames = 0;
+
+    double speechRatio() const {
+        return frames > 0 ? static_cast<double>(speechFrames) / static_cast<double>(frames) : 0.0;
+    }
+};
+
+/**
+ * Classify fixed-size frames of mono PCM as speech or non-speech
+ *
+ * @param samples Mono float PCM in [-1, 1]
+ * @param config  Frame size and thresholds
+ * @return Frame and speech-frame counts; a trailing partial frame is ignored
+ */
+VadResult analyzeVoiceActivity(std::span<const float> samples, const VadConfig& config = {});
+
+namespace vad {
+
+// Vectorized per-frame kernels (AVX2/SSE2/NEON with a scalar fallback)
+
+// Sum of x[i]^2
+float sumOfSquares(std::span<const float> x);
+
+// Number of sign changes between consecutive samples
+size_t zeroCrossings(std::span<const float> x);
+
+// Hann-windowed power spectrum, bins 0..n/2; false unless x.size() is a
+// power of two (at least 4)
+bool powerSpectrum(std::span<const float> x, std::vector<float>& power);
+
+// Geometric / arithmetic mean of the Hann-windowed power spectrum,
+// excluding DC; x.size() must be a power of two
+double spectralFlatness(std::span<const float> x);
+
+} // namespace vad
+
+} // namespace sdrtrunk
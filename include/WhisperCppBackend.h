@@ -0,0 +1,57 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "TranscriptionBackend.h"
+
+struct whisper_context;
+struct whisper_state;
+
+namespace sdrtrunk {
+
+struct WhisperCppConfig {
+    std::string modelPath;      // ggml model file, e.g. ggml-base.en.bin
+    int threads = 4;            // n_threads per transcription
+    std::string language = "en";
+    int beamSize = 5;           // 1 selects greedy decoding
+};
+
+/**
+ * In-process local transcription on whisper.cpp
+ *
+ * One model (whisper_context) is loaded and shared; every concurrent
+ * caller checks out its own whisper_state, so each pool worker decodes
+ * independently without a global lock. No Python or GIL is involved.
+ *
+ * When the build has no whisper.cpp (USE_WHISPER_CPP off), create()
+ * returns a ConfigError.
+ */
+class WhisperCppBackend : public TranscriptionBackend {
+public:
+    static Result<std::unique_ptr<WhisperCppBackend>> create(const WhisperCppConfig& config);
+
+    ~WhisperCppBackend() override;
+    WhisperCppBackend(const WhisperCppBackend&) = delete;
+    WhisperCppBackend& operator=(const WhisperCppBackend&) = delete;
+
+    Result<std::string> transcribe(const TranscriptionRequest& request) override;
+    std::string name() const override { return "whisper.cpp"; }
+    bool consumesPcm() const override { return true; }
+
+private:
+    WhisperCppBackend(whisper_context* ctx, WhisperCppConfig config);
+
+    whisper_state* acquireState();
+    void releaseState(whisper_state* state);
+
+    whisper_context* ctx_;
+    WhisperCppConfig config_;
+    std::mutex statesMutex_;
+    std::vector<whisper_state*> idleStates_;
+    std::vector<whisper_state*> allStates_;
+};
+
+} // namespace sdrtrunk
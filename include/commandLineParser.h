@@ -1,6 +1,7 @@
 #ifndef COMMAND_LINE_PARSER_H
 #define COMMAND_LINE_PARSER_H
 
+#include <optional>
 #include <string>
 
 struct CommandLineArgs {
@@ -8,6 +9,11 @@ struct CommandLineArgs {
     bool localFlag;
     bool parallelFlag;
     bool helpFlag;
+    // --reenrich: redo v2transcription of stored rows, then exit
+    bool reenrichFlag;
+    std::optional<int> reenrichTalkgroup;
+    std::string reenrichFrom;  // YYYYMMDD
+    std::string reenrichTo;
 };
 
 CommandLineArgs parseCommandLine(int argc, char* argv[]);
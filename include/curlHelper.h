@@ -6,6 +6,10 @@
 // Third-Party Library Headers
 #include <curl/curl.h>
 
+namespace sdrtrunk {
+class RecordingFile;
+}
+
 // Callback function to write the CURL response to a string
 size_t WriteCallback(void *contents, size_t size, size_t nmemb, void *userp);
 
@@ -15,8 +19,18 @@ void setupCurlHeaders(CURL *curl, struct curl_slist *&headers, const std::string
 // Setup CURL post fields
 void setupCurlPostFields(CURL *curl, curl_mime *&mime, const std::string &file_path, const std::string &prompt = "");
 
+// Setup CURL post fields, streaming the file from an open recording
+void setupCurlPostFields(CURL *curl, curl_mime *&mime, const sdrtrunk::RecordingFile &file, const std::string &prompt = "");
+
 // Make a CURL request and return the response
 std::string makeCurlRequest(CURL *curl, curl_mime *mime);
 
+// Requests still available in the current rate-limit window
+// (MAX_REQUESTS_PER_MINUTE per RATE_LIMIT_WINDOW_SECONDS)
+int remoteRequestHeadroom();
+
 // Transcribe audio using CURL
 std::string curl_transcribe_audio(const std::string &file_path, const std::string &OPENAI_API_KEY, const std::string &prompt = "");
+
+// Transcribe an already open recording (uploaded from memory, not reopened)
+std::string curl_transcribe_audio(const sdrtrunk::RecordingFile &file, const std::string &OPENAI_API_KEY, const std::string &prompt = "");
@@ -4,8 +4,30 @@
 #include <string>
 #include <expected>
 
+#include "DecodeProfile.h"
+#include "MP3Duration.h"
+#include "RecordingFile.h"
+
+// Per-call options for local transcription
+struct LocalTranscribeOptions
+{
+    std::string model;                      // faster-whisper model size; empty = module default
+    const sdrtrunk::PcmBuffer* pcm = nullptr;  // already-decoded samples, skips decoding
+    const sdrtrunk::DecodeProfile* profile = nullptr;  // per-talkgroup decoding; null = module defaults
+    const sdrtrunk::RecordingFile* file = nullptr;     // already-open recording; skips path checks and reopening
+};
+
 // Returns transcription on success, error message on failure
-std::expected<std::string, std::string> local_transcribe_audio(const std::string& mp3FilePath);
+std::expected<std::string, std::string> local_transcribe_audio(const std::string& mp3FilePath,
+                                                               const LocalTranscribeOptions& options = {});
+
+// Start loading the local Whisper model on a background thread (idempotent);
+// draftModel, when set, is the TIER_DRAFT_MODEL loaded by the same task
+void start_model_warmup(const std::string& draftModel = "");
+
+// Block until the model is loaded; returns error message if loading failed.
+// Starts the warm-up itself if start_model_warmup() was never called.
+std::expected<void, std::string> wait_for_model_ready();
 
 void cleanup_python();  // Clean up Python interpreter on exit
 
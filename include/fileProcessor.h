@@ -6,9 +6,26 @@
 
 // Project-Specific Headers
 #include "FileData.h"
+#include "RecordingFile.h"
+#include "SdrTrunkFilename.h"
 
-FileData processFile(const std::filesystem::path &path, const std::string &directoryToMonitor, const std::string &OPENAI_API_KEY);
+class DatabaseManager;
+
+namespace sdrtrunk {
+class TranscriptionBackend;
+}
+
+// db, when set, is used to find and record near-duplicate recordings (FINGERPRINT_DEDUP)
+FileData processFile(const std::filesystem::path &path, const std::string &directoryToMonitor, const std::string &OPENAI_API_KEY, DatabaseManager *db = nullptr);
+// Whether processFile streams a recording rather than decoding it whole, which skips fingerprint dedup;
+// localBackend is the backend that may transcribe it locally, null when only the OpenAI API is used
+bool streamsRecording(const sdrtrunk::TranscriptionBackend *localBackend, double durationSeconds);
+// Build the local backend (LOCAL_BACKEND, loading its models) on a background thread (idempotent);
+// workers that need it before then wait for the build to finish
+void startLocalBackendWarmup();
 void find_and_move_mp3_without_txt(const std::string &directoryToMonitor);
 bool isFileBeingWrittenTo(const std::string &filePath);
+bool isFileBeingWrittenTo(const sdrtrunk::RecordingFile &file);  // re-stats the open descriptor
 bool isFileLocked(const std::string &filePath);
-void extractFileInfo(FileData &fileData, const std::string &filename, const std::string &transcription);
\ No newline at end of file
+void extractFileInfo(FileData &fileData, const std::string &filename, const std::string &transcription);
+void extractFileInfo(FileData &fileData, const sdrtrunk::SdrTrunkFilename &parsed, const std::string &transcription);  // views into the filename
\ No newline at end of file
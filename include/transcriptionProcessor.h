@@ -6,13 +6,10 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <functional>
+#include <optional>
 #include <vector>
 
-struct TalkgroupFiles
-{
-    std::vector<std::string> glossaryFiles;
-    std::string prompt;
-};
+#include "TalkgroupProfiles.h"
 
 // Function to read a mapping file and return an unordered_map
 std::unordered_map<std::string, std::string> readMappingFile(const std::string &filePath);
@@ -25,7 +22,7 @@ void insertMappings(std::stringstream &orderedJsonStr, const std::string &actual
 
 std::unordered_set<int> parseTalkgroupIDs(const std::string &idString);
 
-std::unordered_map<int, TalkgroupFiles> readTalkgroupFileMappings(const std::string &configFilePath);
+sdrtrunk::TalkgroupProfiles readTalkgroupFileMappings(const std::string &configFilePath);
 
 std::string generateV2Transcription(
     const std::string &transcription,
@@ -33,4 +30,17 @@ std::string generateV2Transcription(
     int radioID,
     const std::unordered_map<int, TalkgroupFiles> &talkgroupFiles);
 
+// The same, with talkgroups looked up in the configured profiles
+std::string generateV2Transcription(
+    const std::string &transcription,
+    int talkgroupID,
+    int radioID,
+    const sdrtrunk::TalkgroupProfiles &talkgroupProfiles);
+
+// The same for a talkgroup's settings; files may be null
+std::string generateV2Transcription(
+    const std::string &transcription,
+    int radioID,
+    const TalkgroupFiles *files);
+
 #endif // TRANSCRIPTION_PROCESSOR_H
\ No newline at end of file
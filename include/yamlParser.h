@@ -67,6 +67,7 @@ private:
 // Template specializations
 template<> std::string YamlNode::as<std::string>() const;
 template<> int YamlNode::as<int>() const;
+template<> double YamlNode::as<double>() const;
 template<> bool YamlNode::as<bool>() const;
 
 // Stream operator for YamlNode
@@ -0,0 +1,369 @@
+/**
+ * @file AudioConvert.cpp
+ * @brief Fused int16 -> mono float conversion and polyphase resampling
+ *
+ * Turns mpg123's native-rate int16 output into the 16 kHz mono float32
+ * that Whisper consumes. The conversion and FIR kernels are vectorized
+ * like the voice-activity kernels: SSE2 is the x86-64 baseline, AVX2 is
+ * selected at runtime on GCC/Clang builds, and NEON is used on ARM64.
+ */
+
+#include "../include/AudioConvert.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <numbers>
+#include <numeric>
+#include <utility>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SDRTRUNK_AUDIO_X86 1
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define SDRTRUNK_AUDIO_AVX2 1
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define SDRTRUNK_AUDIO_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace sdrtrunk {
+
+namespace {
+
+constexpr size_t TAPS = PolyphaseResampler::TAPS_PER_PHASE;
+constexpr int64_t HALF_TAPS = static_cast<int64_t>(TAPS / 2);
+
+// Passband edge as a fraction of the lower Nyquist frequency; P25 voice
+// sits well below it. Beta 8.6 gives roughly 85 dB of stopband rejection.
+constexpr double ROLLOFF = 0.92;
+constexpr double KAISER_BETA = 8.6;
+
+void int16ToMonoScalar(const int16_t* in, int channels, size_t frames, float* out) {
+    const float scale = 1.0f / (32768.0f * static_cast<float>(channels));
+    const size_t stride = static_cast<size_t>(channels);
+    for (size_t f = 0; f < frames; ++f) {
+        int32_t sum = 0;
+        for (size_t c = 0; c < stride; ++c) {
+            sum += in[f * stride + c];
+        }
+        out[f] = static_cast<float>(sum) * scale;
+    }
+}
+
+float dotScalar(const float* a, const float* b, size_t n) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+#ifdef SDRTRUNK_AUDIO_X86
+
+void int16ToMonoSse2(const int16_t* in, int channels, size_t frames, float* out) {
+    size_t f = 0;
+    if (channels == 1) {
+        const __m128 scale = _mm_set1_ps(1.0f / 32768.0f);
+        for (; f + 8 <= frames; f += 8) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + f));
+            // Sign-extend by duplicating into the high half and shifting down
+            __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+            __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+            _mm_storeu_ps(out + f, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+            _mm_storeu_ps(out + f + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+        }
+    } else if (channels == 2) {
+        // madd against ones sums each left/right pair into one int32
+        const __m128 scale = _mm_set1_ps(0.5f / 32768.0f);
+        const __m128i ones = _mm_set1_epi16(1);
+        for (; f + 4 <= frames; f += 4) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * f));
+            _mm_storeu_ps(out + f, _mm_mul_ps(_mm_cvtepi32_ps(_mm_madd_epi16(v, ones)), scale));
+        }
+    }
+    int16ToMonoScalar(in + f * static_cast<size_t>(channels), channels, frames - f, out + f);
+}
+
+float dotSse2(const float* a, const float* b, size_t n) {
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, _mm_add_ps(acc0, acc1));
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + dotScalar(a + i, b + i, n - i);
+}
+
+#ifdef SDRTRUNK_AUDIO_AVX2
+
+__attribute__((target("avx2")))
+void int16ToMonoAvx2(const int16_t* in, int channels, size_t frames, float* out) {
+    size_t f = 0;
+    if (channels == 1) {
+        const __m256 scale = _mm256_set1_ps(1.0f / 32768.0f);
+        for (; f + 16 <= frames; f += 16) {
+            __m256i lo = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + f)));
+            __m256i hi = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + f + 8)));
+            _mm256_storeu_ps(out + f, _mm256_mul_ps(_mm256_cvtepi32_ps(lo), scale));
+            _mm256_storeu_ps(out + f + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(hi), scale));
+        }
+    } else if (channels == 2) {
+        // Pairs never straddle the 128-bit lanes, so madd keeps frame order
+        const __m256 scale = _mm256_set1_ps(0.5f / 32768.0f);
+        const __m256i ones = _mm256_set1_epi16(1);
+        for (; f + 8 <= frames; f += 8) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2 * f));
+            _mm256_storeu_ps(out + f, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_madd_epi16(v, ones)), scale));
+        }
+    }
+    int16ToMonoSse2(in + f * static_cast<size_t>(channels), channels, frames - f, out + f);
+}
+
+__attribute__((target("avx2,fma")))
+float dotAvx2(const float* a, const float* b, size_t n) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+    }
+    __m256 acc = _mm256_add_ps(acc0, acc1);
+    __m128 half = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, half);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + dotScalar(a + i, b + i, n - i);
+}
+
+bool hasAvx2() {
+    static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return supported;
+}
+
+#endif // SDRTRUNK_AUDIO_AVX2
+
+#endif // SDRTRUNK_AUDIO_X86
+
+#ifdef SDRTRUNK_AUDIO_NEON
+
+void int16ToMonoNeon(const int16_t* in, int channels, size_t frames, float* out) {
+    size_t f = 0;
+    if (channels == 1) {
+        const float32x4_t scale = vdupq_n_f32(1.0f / 32768.0f);
+        for (; f + 8 <= frames; f += 8) {
+            int16x8_t v = vld1q_s16(in + f);
+            vst1q_f32(out + f, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), scale));
+            vst1q_f32(out + f + 4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), scale));
+        }
+    } else if (channels == 2) {
+        const float32x4_t scale = vdupq_n_f32(0.5f / 32768.0f);
+        for (; f + 8 <= frames; f += 8) {
+            int16x8x2_t v = vld2q_s16(in + 2 * f);  // de-interleaves left and right
+            int32x4_t lo = vaddl_s16(vget_low_s16(v.val[0]), vget_low_s16(v.val[1]));
+            int32x4_t hi = vaddl_s16(vget_high_s16(v.val[0]), vget_high_s16(v.val[1]));
+            vst1q_f32(out + f, vmulq_f32(vcvtq_f32_s32(lo), scale));
+            vst1q_f32(out + f + 4, vmulq_f32(vcvtq_f32_s32(hi), scale));
+        }
+    }
+    int16ToMonoScalar(in + f * static_cast<size_t>(channels), channels, frames - f, out + f);
+}
+
+float dotNeon(const float* a, const float* b, size_t n) {
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = vfmaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+        acc1 = vfmaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    return vaddvq_f32(vaddq_f32(acc0, acc1)) + dotScalar(a + i, b + i, n - i);
+}
+
+#endif // SDRTRUNK_AUDIO_NEON
+
+using DotKernel = float (*)(const float*, const float*, size_t);
+
+DotKernel selectDotKernel() {
+#if defined(SDRTRUNK_AUDIO_AVX2)
+    return hasAvx2() ? dotAvx2 : dotSse2;
+#elif defined(SDRTRUNK_AUDIO_X86)
+    return dotSse2;
+#elif defined(SDRTRUNK_AUDIO_NEON)
+    return dotNeon;
+#else
+    return dotScalar;
+#endif
+}
+
+double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 50 && term > 1e-12 * sum; ++k) {
+        double half = x / (2.0 * k);
+        term *= half * half;
+        sum += term;
+    }
+    return sum;
+}
+
+// Kaiser-windowed sinc prototype, split into `up` phases of TAPS taps.
+// Each phase is stored reversed so an output is a dot product with a
+// contiguous input window, and normalized to unit DC gain.
+std::vector<float> designFilterBank(int up, int down) {
+    const size_t phases = static_cast<size_t>(up);
+    const size_t length = phases * TAPS;
+    const double cutoff = 0.5 * ROLLOFF / static_cast<double>(std::max(up, down));
+    const double center = static_cast<double>(length) / 2.0;
+    const double windowNorm = besselI0(KAISER_BETA);
+
+    std::vector<double> prototype(length);
+    for (size_t j = 0; j < length; ++j) {
+        double x = static_cast<double>(j) - center;
+        double sinc = std::abs(x) < 1e-9 ? 2.0 * cutoff : std::sin(2.0 * std::numbers::pi * cutoff * x) / (std::numbers::pi * x);
+        double r = x / center;
+        double window = besselI0(KAISER_BETA * std::sqrt(std::max(0.0, 1.0 - r * r))) / windowNorm;
+        prototype[j] = sinc * window;
+    }
+
+    std::vector<float> bank(length);
+    for (size_t p = 0; p < phases; ++p) {
+        double gain = 0.0;
+        for (size_t k = 0; k < TAPS; ++k) {
+            gain += prototype[p + k * phases];
+        }
+        for (size_t m = 0; m < TAPS; ++m) {
+            double tap = prototype[p + (TAPS - 1 - m) * phases];
+            bank[p * TAPS + m] = static_cast<float>(std::abs(gain) > 1e-12 ? tap / gain : 0.0);
+        }
+    }
+    return bank;
+}
+
+std::shared_ptr<const std::vector<float>> filterBank(int up, int down) {
+    // A worker only ever sees a handful of source rates
+    thread_local std::map<std::pair<int, int>, std::shared_ptr<const std::vector<float>>> banks;
+    auto& bank = banks[{up, down}];
+    if (!bank) {
+        bank = std::make_shared<const std::vector<float>>(designFilterBank(up, down));
+    }
+    return bank;
+}
+
+} // namespace
+
+namespace audio {
+
+void int16ToMonoFloat(std::span<const int16_t> interleaved, int channels, float* out) {
+    if (channels <= 0) {
+        return;
+    }
+    const size_t frames = interleaved.size() / static_cast<size_t>(channels);
+#if defined(SDRTRUNK_AUDIO_AVX2)
+    if (hasAvx2()) {
+        int16ToMonoAvx2(interleaved.data(), channels, frames, out);
+        return;
+    }
+    int16ToMonoSse2(interleaved.data(), channels, frames, out);
+#elif defined(SDRTRUNK_AUDIO_X86)
+    int16ToMonoSse2(interleaved.data(), channels, frames, out);
+#elif defined(SDRTRUNK_AUDIO_NEON)
+    int16ToMonoNeon(interleaved.data(), channels, frames, out);
+#else
+    int16ToMonoScalar(interleaved.data(), channels, frames, out);
+#endif
+}
+
+float dot(std::span<const float> a, std::span<const float> b) {
+    static const DotKernel kernel = selectDotKernel();
+    return kernel(a.data(), b.data(), std::min(a.size(), b.size()));
+}
+
+} // namespace audio
+
+PolyphaseResampler::PolyphaseResampler(int inRate, int outRate) {
+    if (inRate > 0 && outRate > 0) {
+        const int common = std::gcd(inRate, outRate);
+        up_ = outRate / common;
+        down_ = inRate / common;
+    }
+    if (up_ != 1 || down_ != 1) {
+        coefficients_ = filterBank(up_, down_);
+        // Zeros before the first sample let the first outputs use a full window
+        history_.assign(static_cast<size_t>(HALF_TAPS - 1), 0.0f);
+        historyStart_ = -(HALF_TAPS - 1);
+    }
+}
+
+void PolyphaseResampler::push(std::span<const int16_t> interleaved, int channels, std::vector<float>& out) {
+    if (channels <= 0) {
+        return;
+    }
+    const size_t frames = interleaved.size() / static_cast<size_t>(channels);
+    std::vector<float>& target = coefficients_ ? history_ : out;
+    const size_t offset = target.size();
+    target.resize(offset + frames);
+    audio::int16ToMonoFloat(interleaved.first(frames * static_cast<size_t>(channels)), channels, target.data() + offset);
+    if (coefficients_) {
+        received_ += static_cast<int64_t>(frames);
+        emit(out, received_);
+        compact();
+    }
+}
+
+void PolyphaseResampler::push(std::span<const float> mono, std::vector<float>& out) {
+    std::vector<float>& target = coefficients_ ? history_ : out;
+    target.insert(target.end(), mono.begin(), mono.end());
+    if (coefficients_) {
+        received_ += static_cast<int64_t>(mono.size());
+        emit(out, received_);
+        compact();
+    }
+}
+
+void PolyphaseResampler::finish(std::vector<float>& out) {
+    if (!coefficients_) {
+        return;
+    }
+    // Zeros after the last sample complete the trailing windows
+    history_.resize(history_.size() + static_cast<size_t>(HALF_TAPS), 0.0f);
+    emit(out, received_);
+    history_.clear();
+    historyStart_ = position_ - HALF_TAPS + 1;
+}
+
+void PolyphaseResampler::emit(std::vector<float>& out, int64_t limit) {
+    static const DotKernel kernel = selectDotKernel();
+    const int64_t available = historyStart_ + static_cast<int64_t>(history_.size());
+    if (position_ >= limit || position_ + HALF_TAPS >= available) {
+        return;
+    }
+    const int64_t end = std::min(limit, available - HALF_TAPS);
+    out.reserve(out.size() + static_cast<size_t>((end - position_) * up_ / down_ + 1));
+
+    const float* taps = coefficients_->data();
+    while (position_ < end) {
+        const float* window = history_.data() + (position_ - HALF_TAPS + 1 - historyStart_);
+        out.push_back(kernel(taps + static_cast<size_t>(phase_) * TAPS, window, TAPS));
+        phase_ += down_;
+        position_ += phase_ / up_;
+        phase_ %= up_;
+    }
+}
+
+void PolyphaseResampler::compact() {
+    // Keep only the window the next output starts from
+    const int64_t drop = position_ - HALF_TAPS + 1 - historyStart_;
+    if (drop <= 0) {
+        return;
+    }
+    const int64_t kept = std::min<int64_t>(drop, static_cast<int64_t>(history_.size()));
+    history_.erase(history_.begin(), history_.begin() + kept);
+    historyStart_ += kept;
+}
+
+} // namespace sdrtrunk
@@ -0,0 +1,227 @@
+/**
+ * @file AudioFingerprint.cpp
+ * @brief Spectral-peak landmark fingerprints for near-duplicate recordings
+ *
+ * Works on the 16 kHz PCM the pipeline already decodes for the VAD gate.
+ * Each 32 ms frame (16 ms hop) contributes its strongest voice-band
+ * spectral peaks; each peak is paired with a few later peaks to form
+ * landmark hashes. Matching counts landmarks shared at one frame offset,
+ * which tolerates the different start and end times of simulcast and
+ * patched copies of the same call.
+ */
+
+#include "../include/AudioFingerprint.h"
+#include "../include/VoiceActivity.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+namespace sdrtrunk {
+
+namespace {
+
+constexpr size_t FRAME_SAMPLES = 512;  // 32 ms at 16 kHz, 31.25 Hz bins
+constexpr size_t HOP_SAMPLES = 256;
+constexpr double SAMPLE_RATE = 16000.0;
+
+constexpr size_t MIN_BIN = 8;    // 250 Hz
+constexpr size_t MAX_BIN = 109;  // 3.4 kHz
+constexpr size_t PEAK_NEIGHBORHOOD = 3;  // a peak is the maximum of +/- 3 bins
+constexpr size_t PEAKS_PER_FRAME = 3;
+constexpr float PEAK_OVER_MEAN = 4.0f;  // 6 dB above the frame's band mean
+// Hann-windowed power of a -50 dBFS sine at the peak bin
+constexpr float PEAK_FLOOR = (0.00316f * FRAME_SAMPLES / 4) * (0.00316f * FRAME_SAMPLES / 4);
+
+constexpr uint32_t TARGET_FRAMES = 32;  // pair with peaks up to ~0.5 s later
+constexpr size_t FAN_OUT = 3;
+constexpr int MAX_BIN_DELTA = 63;
+
+constexpr size_t MIN_LANDMARKS = 20;
+constexpr size_t MAX_PAIRS_PER_HASH = 64;  // skip hashes repeated by steady tones
+
+struct Peak {
+    uint32_t frame;
+    uint32_t bin;
+};
+
+uint32_t landmarkHash(uint32_t anchorBin, uint32_t targetBin, uint32_t frameDelta) {
+    const uint32_t binDelta = static_cast<uint32_t>(static_cast<int>(targetBin) - static_cast<int>(anchorBin) + 64);
+    return ((anchorBin - static_cast<uint32_t>(MIN_BIN)) << 13) | (binDelta << 6) | frameDelta;
+}
+
+void appendU32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out.push_back(static_cast<uint8_t>(value >> shift));
+    }
+}
+
+uint32_t readU32(const uint8_t* in) {
+    return static_cast<uint32_t>(in[0]) | static_cast<uint32_t>(in[1]) << 8 |
+           static_cast<uint32_t>(in[2]) << 16 | static_cast<uint32_t>(in[3]) << 24;
+}
+
+} // namespace
+
+double AudioFingerprint::durationSeconds() const {
+    return static_cast<double>(frames) * static_cast<double>(HOP_SAMPLES) / SAMPLE_RATE;
+}
+
+std::vector<uint8_t> AudioFingerprint::serialize() const {
+    std::vector<uint8_t> out;
+    out.reserve(8 + landmarks.size() * 8);
+    appendU32(out, frames);
+    appendU32(out, static_cast<uint32_t>(landmarks.size()));
+    for (const auto& landmark : landmarks) {
+        appendU32(out, landmark.hash);
+        appendU32(out, landmark.frame);
+    }
+    return out;
+}
+
+AudioFingerprint AudioFingerprint::deserialize(std::span<const uint8_t> bytes) {
+    AudioFingerprint fingerprint;
+    if (bytes.size() < 8) {
+        return fingerprint;
+    }
+    const size_t count = readU32(bytes.data() + 4);
+    if (bytes.size() != 8 + count * 8) {
+        return fingerprint;
+    }
+    fingerprint.frames = readU32(bytes.data());
+    fingerprint.landmarks.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        fingerprint.landmarks[i] = {readU32(bytes.data() + 8 + i * 8), readU32(bytes.data() + 12 + i * 8)};
+    }
+    return fingerprint;
+}
+
+AudioFingerprint computeFingerprint(std::span<const float> samples) {
+    AudioFingerprint fingerprint;
+    if (samples.size() < FRAME_SAMPLES) {
+        return fingerprint;
+    }
+
+    // Strongest local maxima of each frame's voice band
+    std::vector<Peak> peaks;
+    std::vector<float> power;
+    std::vector<Peak> candidates;
+    uint32_t frame = 0;
+    for (size_t offset = 0; offset + FRAME_SAMPLES <= samples.size(); offset += HOP_SAMPLES, ++frame) {
+        vad::powerSpectrum(samples.subspan(offset, FRAME_SAMPLES), power);
+
+        float mean = 0.0f;
+        for (size_t k = MIN_BIN; k <= MAX_BIN; ++k) {
+            mean += power[k];
+        }
+        mean /= static_cast<float>(MAX_BIN - MIN_BIN + 1);
+        const float threshold = std::max(PEAK_FLOOR, mean * PEAK_OVER_MEAN);
+
+        candidates.clear();
+        for (size_t k = MIN_BIN; k <= MAX_BIN; ++k) {
+            if (power[k] < threshold) {
+                continue;
+            }
+            const size_t lo = k - PEAK_NEIGHBORHOOD;
+            const size_t hi = std::min(k + PEAK_NEIGHBORHOOD, power.size() - 1);
+            bool isMax = true;
+            for (size_t j = lo; j <= hi && isMax; ++j) {
+                // Ties go to the lower bin
+                isMax = j == k || (j < k ? power[j] < power[k] : power[j] <= power[k]);
+            }
+            if (isMax) {
+                candidates.push_back({frame, static_cast<uint32_t>(k)});
+            }
+        }
+        const size_t keep = std::min(candidates.size(), PEAKS_PER_FRAME);
+        std::partial_sort(candidates.begin(), candidates.begin() + static_cast<std::ptrdiff_t>(keep), candidates.end(),
+                          [&power](const Peak& a, const Peak& b) { return power[a.bin] > power[b.bin]; });
+        peaks.insert(peaks.end(), candidates.begin(), candidates.begin() + static_cast<std::ptrdiff_t>(keep));
+    }
+    fingerprint.frames = frame;
+
+    // Pair each anchor with the first few peaks in its target zone
+    for (size_t i = 0; i < peaks.size(); ++i) {
+        const Peak& anchor = peaks[i];
+        size_t paired = 0;
+        for (size_t j = i + 1; j < peaks.size() && paired < FAN_OUT; ++j) {
+            const Peak& target = peaks[j];
+            const uint32_t frameDelta = target.frame - anchor.frame;
+            if (frameDelta == 0) {
+                continue;
+            }
+            if (frameDelta > TARGET_FRAMES) {
+                break;
+            }
+            if (std::abs(static_cast<int>(target.bin) - static_cast<int>(anchor.bin)) > MAX_BIN_DELTA) {
+                continue;
+            }
+            fingerprint.landmarks.push_back({landmarkHash(anchor.bin, target.bin, frameDelta), anchor.frame});
+            ++paired;
+        }
+    }
+    std::ranges::sort(fingerprint.landmarks, [](const auto& a, const auto& b) {
+        return a.hash != b.hash ? a.hash < b.hash : a.frame < b.frame;
+    });
+    return fingerprint;
+}
+
+double fingerprintSimilarity(const AudioFingerprint& a, const AudioFingerprint& b) {
+    const size_t shorter = std::min(a.landmarks.size(), b.landmarks.size());
+    if (shorter == 0) {
+        return 0.0;
+    }
+
+    // Histogram of frame offsets over landmarks with equal hashes
+    std::unordered_map<int64_t, uint32_t> offsets;
+    size_t i = 0;
+    size_t j = 0;
+    while (i < a.landmarks.size() && j < b.landmarks.size()) {
+        const uint32_t hash = a.landmarks[i].hash;
+        if (hash < b.landmarks[j].hash) {
+            ++i;
+            continue;
+        }
+        if (b.landmarks[j].hash < hash) {
+            ++j;
+            continue;
+        }
+        size_t iEnd = i;
+        while (iEnd < a.landmarks.size() && a.landmarks[iEnd].hash == hash) ++iEnd;
+        size_t jEnd = j;
+        while (jEnd < b.landmarks.size() && b.landmarks[jEnd].hash == hash) ++jEnd;
+        if ((iEnd - i) * (jEnd - j) <= MAX_PAIRS_PER_HASH) {
+            for (size_t x = i; x < iEnd; ++x) {
+                for (size_t y = j; y < jEnd; ++y) {
+                    ++offsets[static_cast<int64_t>(b.landmarks[y].frame) - static_cast<int64_t>(a.landmarks[x].frame)];
+                }
+            }
+        }
+        i = iEnd;
+        j = jEnd;
+    }
+
+    // Start times rarely differ by a whole hop, so neighbouring offsets
+    // belong to the same alignment
+    uint32_t best = 0;
+    for (const auto& [offset, count] : offsets) {
+        uint32_t total = count;
+        if (auto it = offsets.find(offset - 1); it != offsets.end()) total += it->second;
+        if (auto it = offsets.find(offset + 1); it != offsets.end()) total += it->second;
+        best = std::max(best, total);
+    }
+    return std::min(1.0, static_cast<double>(best) / static_cast<double>(shorter));
+}
+
+bool isNearDuplicate(const AudioFingerprint& a, const AudioFingerprint& b, const FingerprintConfig& config) {
+    if (a.landmarks.size() < MIN_LANDMARKS || b.landmarks.size() < MIN_LANDMARKS) {
+        return false;
+    }
+    const double longer = static_cast<double>(std::max(a.frames, b.frames));
+    if (static_cast<double>(std::min(a.frames, b.frames)) < config.minDurationRatio * longer) {
+        return false;
+    }
+    return fingerprintSimilarity(a, b) >= config.minSimilarity;
+}
+
+} // namespace sdrtrunk
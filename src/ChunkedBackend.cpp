@@ -0,0 +1,370 @@
+/**
+ * @file ChunkedBackend.cpp
+ * @brief Split long recordings at pauses and transcribe the chunks in parallel
+ */
+
+#include "../include/ChunkedBackend.h"
+
+#include <algorithm>
+#include <deque>
+#include <exception>
+#include <future>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+
+#include "../include/ConfigSingleton.h"
+#include "../include/debugUtils.h"
+#include "../include/jsonParser.h"
+#include "../include/MP3Duration.h"
+#include "../include/PcmStream.h"
+#include "../include/ThreadPool.h"
+#include "../include/TieredBackend.h"
+#include "../include/VoiceActivity.h"
+
+namespace sdrtrunk {
+
+namespace {
+
+constexpr double FRAME_SECONDS = 0.02;
+constexpr size_t QUIET_WINDOW_FRAMES = 10;  // a pause is judged over 200 ms
+
+std::string responseText(const std::string& json) {
+    size_t start = json.find('{');
+    if (start == std::string::npos) {
+        return "";
+    }
+    try {
+        auto object = JsonParser::parseString(json.substr(start));
+        if (auto it = object.find("text"); it != object.end() && std::holds_alternative<std::string>(it->second)) {
+            return std::get<std::string>(it->second);
+        }
+    } catch (const std::exception&) {
+        // Unparseable chunks contribute no text
+    }
+    return "";
+}
+
+std::string_view trimmed(std::string_view text) {
+    const auto first = text.find_first_not_of(" \t\r\n");
+    if (first == std::string_view::npos) {
+        return {};
+    }
+    return text.substr(first, text.find_last_not_of(" \t\r\n") - first + 1);
+}
+
+struct ChunkResult {
+    Result<std::string> text;
+    double seconds = 0.0;
+    TierOutcome outcome;
+};
+
+// Join chunk transcriptions in order; one failed chunk fails the
+// recording rather than storing a transcription with a hole in it
+Result<std::string> stitchChunks(const std::vector<ChunkResult>& chunks, TierOutcome* tierOutcome) {
+    std::string text;
+    double weightedLogprob = 0.0;
+    double totalSeconds = 0.0;
+    bool allConfident = true;
+    for (const auto& chunk : chunks) {
+        if (!chunk.text.has_value()) {
+            return std::unexpected(chunk.text.error());
+        }
+        const std::string chunkText = responseText(chunk.text.value());
+        auto part = trimmed(chunkText);
+        if (!part.empty()) {
+            if (!text.empty()) {
+                text += ' ';
+            }
+            text += part;
+        }
+        auto confidence = parseTranscriptionConfidence(chunk.text.value());
+        if (confidence.avgLogprob) {
+            weightedLogprob += *confidence.avgLogprob * chunk.seconds;
+        } else {
+            allConfident = false;
+        }
+        totalSeconds += chunk.seconds;
+    }
+
+    if (tierOutcome) {
+        TierOutcome total;
+        for (const auto& chunk : chunks) {
+            total.tiered = total.tiered || chunk.outcome.tiered;
+            total.escalated = total.escalated || chunk.outcome.escalated;
+            total.draftSeconds += chunk.outcome.draftSeconds;
+            total.fullSeconds += chunk.outcome.fullSeconds;
+            total.savedSeconds += chunk.outcome.savedSeconds;
+        }
+        *tierOutcome = total;
+    }
+
+    if (allConfident && totalSeconds > 0.0) {
+        return makeTranscriptionJson(text, weightedLogprob / totalSeconds);
+    }
+    return makeTranscriptionJson(text);
+}
+
+} // namespace
+
+std::vector<AudioChunk> splitAtSilence(std::span<const float> samples, int sampleRate, const ChunkingConfig& config) {
+    std::vector<AudioChunk> chunks;
+    if (samples.empty()) {
+        return chunks;
+    }
+    const size_t frame = std::max<size_t>(1, static_cast<size_t>(FRAME_SECONDS * sampleRate));
+    const size_t frames = samples.size() / frame;
+    const size_t target = static_cast<size_t>(config.targetChunkSeconds / FRAME_SECONDS);
+    const size_t search = std::min(static_cast<size_t>(config.searchSeconds / FRAME_SECONDS), target / 2);
+    if (target == 0 || frames <= target + search) {
+        chunks.push_back({0, samples.size()});
+        return chunks;
+    }
+
+    // Prefix sums of frame energy give any window's energy in O(1)
+    std::vector<double> energy(frames + 1, 0.0);
+    for (size_t f = 0; f < frames; ++f) {
+        energy[f + 1] = energy[f] + static_cast<double>(vad::sumOfSquares(samples.subspan(f * frame, frame)));
+    }
+    auto windowEnergy = [&](size_t center) {
+        size_t lo = center > QUIET_WINDOW_FRAMES / 2 ? center - QUIET_WINDOW_FRAMES / 2 : 0;
+        size_t hi = std::min(frames, center + QUIET_WINDOW_FRAMES / 2);
+        return energy[hi] - energy[lo];
+    };
+
+    size_t start = 0;
+    while (frames - start > target + search) {
+        size_t best = start + target;
+        double bestEnergy = windowEnergy(best);
+        for (size_t f = start + target - search; f <= start + target + search; ++f) {
+            double e = windowEnergy(f);
+            // Only a strictly quieter window moves the cut off the target
+            if (e < bestEnergy) {
+                best = f;
+                bestEnergy = e;
+            }
+        }
+        chunks.push_back({start * frame, best * frame});
+        start = best;
+    }
+    chunks.push_back({start * frame, samples.size()});
+    return chunks;
+}
+
+ChunkedBackend::ChunkedBackend(std::shared_ptr<TranscriptionBackend> inner, ChunkingConfig config)
+    : inner_(std::move(inner)), config_(config),
+      pool_(std::make_unique<ThreadPool>(static_cast<size_t>(std::max(1, config.maxParallel)))) {}
+
+ChunkedBackend::~ChunkedBackend() = default;
+
+bool ChunkedBackend::splits(double durationSeconds) const {
+    return config_.thresholdSeconds > 0.0 && inner_->transcribesConcurrently() &&
+           !(durationSeconds > 0.0 && durationSeconds < config_.thresholdSeconds);
+}
+
+bool ChunkedBackend::streamsRecording(double durationSeconds) const {
+    return inner_->consumesPcm() && (splits(durationSeconds) || exceedsDecodeBudget(durationSeconds));
+}
+
+Result<std::string> ChunkedBackend::transcribe(const TranscriptionRequest& request) {
+    if (!inner_->consumesPcm()) {
+        return inner_->transcribe(request);
+    }
+    // Split for speed when the engine runs chunks side by side
+    const bool parallel = config_.thresholdSeconds > 0.0 && inner_->transcribesConcurrently();
+    const bool split = splits(request.durationSeconds);
+    // Split for memory when a whole decode would not fit under the cap,
+    // whatever the engine
+    const bool oversized = !request.pcm && exceedsDecodeBudget(request.durationSeconds);
+    if (!split && !oversized) {
+        return inner_->transcribe(request);
+    }
+
+    // Undecoded recordings are streamed so that memory stays bounded
+    // however long they are
+    if (!request.pcm && request.file) {
+        if (auto stream = PcmStream::open(*request.file); stream.has_value()) {
+            return transcribeStream(request, stream.value(), parallel ? static_cast<size_t>(std::max(1, config_.maxParallel)) : 1);
+        }
+    }
+    if (!split) {
+        return inner_->transcribe(request);
+    }
+
+    BudgetedPcm decoded;
+    const PcmBuffer* pcm = request.pcm;
+    if (!pcm) {
+        auto result = decodeRequestAudio(request);
+        if (!result.has_value()) {
+            return inner_->transcribe(request);
+        }
+        decoded = std::move(result.value());
+        pcm = &decoded.pcm;
+    }
+    TranscriptionRequest whole = request;
+    whole.pcm = pcm;
+    if (pcm->durationSeconds() < config_.thresholdSeconds) {
+        return inner_->transcribe(whole);
+    }
+    auto chunks = splitAtSilence(pcm->samples, pcm->sampleRate, config_);
+    if (chunks.size() < 2) {
+        return inner_->transcribe(whole);
+    }
+
+    if (ConfigSingleton::getInstance().isDebugFileProcessor()) {
+        std::cout << "[" << getCurrentTime() << "] "
+                  << "ChunkedBackend.cpp transcribe Splitting " << request.filePath << " ("
+                  << pcm->durationSeconds() << " s) into " << chunks.size() << " chunks" << std::endl;
+    }
+
+    std::vector<PcmBuffer> chunkPcm(chunks.size());
+    std::vector<ChunkResult> results(chunks.size());
+    std::vector<TranscriptionRequest> requests(chunks.size(), request);
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        chunkPcm[i].sampleRate = pcm->sampleRate;
+        chunkPcm[i].samples.assign(pcm->samples.begin() + static_cast<std::ptrdiff_t>(chunks[i].begin),
+                                   pcm->samples.begin() + static_cast<std::ptrdiff_t>(chunks[i].end));
+        results[i].seconds = chunkPcm[i].durationSeconds();
+        requests[i].pcm = &chunkPcm[i];
+        requests[i].durationSeconds = results[i].seconds;
+        requests[i].tierOutcome = request.tierOutcome ? &results[i].outcome : nullptr;
+    }
+
+    std::vector<std::future<Result<std::string>>> pending;
+    pending.reserve(chunks.size() - 1);
+    for (size_t i = 1; i < chunks.size(); ++i) {
+        pending.push_back(pool_->enqueue([this, &requests, i]() { return inner_->transcribe(requests[i]); }));
+    }
+    std::exception_ptr failure;
+    try {
+        results[0].text = inner_->transcribe(requests[0]);
+    } catch (...) {
+        failure = std::current_exception();
+    }
+    // The queued chunks point into requests and chunkPcm; wait for all of
+    // them before anything here goes out of scope
+    for (auto& future : pending) {
+        future.wait();
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+    for (size_t i = 1; i < chunks.size(); ++i) {
+        results[i].text = pending[i - 1].get();
+    }
+    return stitchChunks(results, request.tierOutcome);
+}
+
+Result<std::string> ChunkedBackend::transcribeStream(const TranscriptionRequest& request, PcmStream& stream,
+                                                     size_t maxInFlight) {
+    // Cut a chunk once the window holds a full search range past the
+    // target plus the quiet-window margin, so cuts land where a
+    // whole-recording split would put them
+    const size_t windowLimit =
+        static_cast<size_t>((config_.targetChunkSeconds + config_.searchSeconds + 1.0) * WHISPER_SAMPLE_RATE);
+
+    // The window, the chunks in flight and the chunk being cut, reserved
+    // before the first block is decoded
+    auto reservation = DecodeMemoryBudget::instance().reserve(
+        PcmStream::workingSetBytes() + (windowLimit + PCM_BLOCK_SAMPLES + (maxInFlight + 1) * windowLimit) * sizeof(float));
+
+    struct StreamedChunk {
+        PcmBuffer pcm;
+        TranscriptionRequest request;
+        ChunkResult result;
+        std::future<Result<std::string>> future;
+    };
+    std::deque<std::unique_ptr<StreamedChunk>> inFlight;
+    std::vector<ChunkResult> results;
+    std::exception_ptr failure;
+
+    auto collectOldest = [&]() {
+        auto chunk = std::move(inFlight.front());
+        inFlight.pop_front();
+        try {
+            chunk->result.text = chunk->future.get();
+        } catch (...) {
+            if (!failure) {
+                failure = std::current_exception();
+            }
+        }
+        results.push_back(std::move(chunk->result));
+    };
+    auto submit = [&](std::span<const float> samples) {
+        while (inFlight.size() >= maxInFlight) {
+            collectOldest();
+        }
+        auto chunk = std::make_unique<StreamedChunk>();
+        chunk->pcm.samples.assign(samples.begin(), samples.end());
+        chunk->result.seconds = chunk->pcm.durationSeconds();
+        chunk->request = request;
+        chunk->request.pcm = &chunk->pcm;
+        chunk->request.durationSeconds = chunk->result.seconds;
+        chunk->request.tierOutcome = request.tierOutcome ? &chunk->result.outcome : nullptr;
+        StreamedChunk* queued = chunk.get();
+        chunk->future = pool_->enqueue([this, queued]() { return inner_->transcribe(queued->request); });
+        inFlight.push_back(std::move(chunk));
+    };
+
+    std::vector<float> window;
+    window.reserve(windowLimit + PCM_BLOCK_SAMPLES);
+    std::optional<Error> streamError;
+    for (;;) {
+        auto block = stream.next();
+        if (!block.has_value()) {
+            streamError = block.error();
+            break;
+        }
+        if (block->empty()) {
+            break;
+        }
+        window.insert(window.end(), block->begin(), block->end());
+        while (window.size() > windowLimit) {
+            auto chunks = splitAtSilence(window, WHISPER_SAMPLE_RATE, config_);
+            if (chunks.size() < 2) {
+                break;
+            }
+            const auto cut = static_cast<std::ptrdiff_t>(chunks[0].end);
+            submit(std::span<const float>(window.data(), chunks[0].end));
+            window.erase(window.begin(), window.begin() + cut);
+        }
+    }
+    if (!streamError) {
+        for (const auto& chunk : splitAtSilence(window, WHISPER_SAMPLE_RATE, config_)) {
+            submit(std::span<const float>(window).subspan(chunk.begin, chunk.end - chunk.begin));
+        }
+    }
+    // Queued chunks point into inFlight; drain it before returning
+    while (!inFlight.empty()) {
+        collectOldest();
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+    if (streamError) {
+        // Nothing was transcribed yet; let the backend report the file
+        if (results.empty()) {
+            return inner_->transcribe(request);
+        }
+        return std::unexpected(*streamError);
+    }
+
+    if (ConfigSingleton::getInstance().isDebugFileProcessor()) {
+        std::cout << "[" << getCurrentTime() << "] "
+                  << "ChunkedBackend.cpp transcribeStream Streamed " << request.filePath << " ("
+                  << static_cast<double>(stream.samplesDecoded()) / WHISPER_SAMPLE_RATE << " s) as "
+                  << results.size() << " chunks" << std::endl;
+    }
+    if (results.size() == 1) {
+        if (request.tierOutcome) {
+            *request.tierOutcome = results.front().outcome;
+        }
+        return results.front().text;
+    }
+    return stitchChunks(results, request.tierOutcome);
+}
+
+} // namespace sdrtrunk
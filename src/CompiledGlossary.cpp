@@ -0,0 +1,231 @@
+/**
+ * @file CompiledGlossary.cpp
+ * @brief Compiled glossary files, mapped read-only
+ *
+ * glossary-compiler writes a GlossarySnapshot's arrays as they are in
+ * memory: a fixed header, then the matcher's tables, the term records
+ * and the interned string table, each 8-byte aligned. Opening one maps
+ * it (RecordingFile) and checks every count, offset and index against
+ * the file size, so there is no parse step and a damaged file is
+ * rejected instead of read out of bounds.
+ *
+ *   header | classOf[256] u16 | next[states * classes] u32
+ *          | outputStart[states + 1] u32 | outputs u32 | lengths[terms] u32
+ *          | terms[terms] TermRecord | strings
+ *
+ * Values are little-endian; other hosts refuse the file.
+ */
+
+#include "../include/Glossary.h"
+#include "../include/RecordingFile.h"
+
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <type_traits>
+
+namespace sdrtrunk {
+
+namespace {
+
+constexpr char MAGIC[8] = {'S', 'D', 'R', 'T', 'G', 'L', 'O', 'S'};
+constexpr uint32_t FORMAT_VERSION = 1;
+
+struct CompiledHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t terms;
+    uint32_t states;
+    uint32_t classes;
+    uint32_t outputs;
+    uint32_t stringBytes;
+    uint64_t classOfOffset;
+    uint64_t nextOffset;
+    uint64_t outputStartOffset;
+    uint64_t outputsOffset;
+    uint64_t lengthsOffset;
+    uint64_t termsOffset;
+    uint64_t stringsOffset;
+    uint64_t fileSize;
+};
+
+static_assert(std::is_trivially_copyable_v<CompiledHeader>);
+static_assert(sizeof(CompiledHeader) % 8 == 0);
+static_assert(sizeof(GlossarySnapshot::TermRecord) == 16);
+
+uint64_t alignUp(uint64_t offset) {
+    return (offset + 7) & ~uint64_t{7};
+}
+
+// count elements of T at offset; nullopt unless they lie inside the file
+template <typename T>
+std::optional<std::span<const T>> section(std::span<const unsigned char> file, uint64_t offset, uint64_t count) {
+    if (offset % alignof(T) != 0 || offset > file.size() || count > (file.size() - offset) / sizeof(T)) {
+        return std::nullopt;
+    }
+    return std::span<const T>(reinterpret_cast<const T*>(file.data() + offset), static_cast<size_t>(count));
+}
+
+template <typename T>
+void writeSection(std::ostream& out, uint64_t offset, std::span<const T> values) {
+    static const char padding[8] = {};
+    const auto at = static_cast<uint64_t>(out.tellp());
+    out.write(padding, static_cast<std::streamsize>(offset - at));
+    out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size_bytes()));
+}
+
+} // namespace
+
+bool GlossarySnapshot::isCompiled(const std::string& path) {
+    char magic[sizeof(MAGIC)] = {};
+    std::ifstream in(path, std::ios::binary);
+    return in.read(magic, sizeof(magic)) && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+Result<std::shared_ptr<const GlossarySnapshot>> GlossarySnapshot::openCompiled(const std::string& path) {
+    using Snapshot = std::shared_ptr<const GlossarySnapshot>;
+    if constexpr (std::endian::native != std::endian::little) {
+        return Err<Snapshot>(ErrorCode::InvalidFormat, "Compiled glossaries are little-endian only", path);
+    }
+
+    auto opened = RecordingFile::open(path);
+    if (!opened) {
+        return std::unexpected(opened.error());
+    }
+    auto file = std::make_shared<RecordingFile>(std::move(*opened));
+    const auto bytes = file->bytes();
+
+    CompiledHeader header{};
+    if (bytes.size() < sizeof(header)) {
+        return Err<Snapshot>(ErrorCode::InvalidFormat, "Compiled glossary is truncated", path);
+    }
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        return Err<Snapshot>(ErrorCode::InvalidFormat, "Not a compiled glossary", path);
+    }
+    if (header.version != FORMAT_VERSION) {
+        return Err<Snapshot>(ErrorCode::InvalidFormat,
+                             "Unsupported compiled glossary version " + std::to_string(header.version), path);
+    }
+    if (header.fileSize != bytes.size()) {
+        return Err<Snapshot>(ErrorCode::InvalidFormat, "Compiled glossary is truncated", path);
+    }
+    // At most one class per byte value plus the class of unused bytes
+    if (header.states == 0 || header.classes == 0 || header.classes > 257) {
+        return Err<Snapshot>(ErrorCode::InvalidFormat, "Compiled glossary has no automaton", path);
+    }
+
+    const auto classOf = section<uint16_t>(bytes, header.classOfOffset, 256);
+    const auto next = section<uint32_t>(bytes, header.nextOffset, uint64_t{header.states} * header.classes);
+    const auto outputStart = section<uint32_t>(bytes, header.outputStartOffset, uint64_t{header.states} + 1);
+    const auto outputs = section<uint32_t>(bytes, header.outputsOffset, header.outputs);
+    const auto lengths = section<uint32_t>(bytes, header.lengthsOffset, header.terms);
+    const auto records = section<TermRecord>(bytes, header.termsOffset, header.terms);
+    const auto strings = section<char>(bytes, header.stringsOffset, header.stringBytes);
+    if (!classOf || !next || !outputStart || !outputs || !lengths || !records || !strings) {
+        return Err<Snapshot>(ErrorCode::InvalidFormat, "Compiled glossary section out of bounds", path);
+    }
+
+    // Every index the matcher and the records follow stays in range
+    auto invalid = [&path]() { return Err<Snapshot>(ErrorCode::InvalidFormat, "Compiled glossary is corrupt", path); };
+    for (uint16_t cls : *classOf) {
+        if (cls >= header.classes) {
+            return invalid();
+        }
+    }
+    for (uint32_t state : *next) {
+        if (state >= header.states) {
+            return invalid();
+        }
+    }
+    if ((*outputStart)[0] != 0 || outputStart->back() != header.outputs) {
+        return invalid();
+    }
+    for (size_t s = 0; s < header.states; ++s) {
+        if ((*outputStart)[s] > (*outputStart)[s + 1]) {
+            return invalid();
+        }
+    }
+    for (uint32_t term : *outputs) {
+        if (term >= header.terms) {
+            return invalid();
+        }
+    }
+    for (size_t t = 0; t < header.terms; ++t) {
+        const TermRecord& r = (*records)[t];
+        if (uint64_t{r.keyOffset} + r.keyLength > header.stringBytes ||
+            uint64_t{r.valueOffset} + r.valueLength > header.stringBytes || (*lengths)[t] != r.keyLength) {
+            return invalid();
+        }
+    }
+
+    std::shared_ptr<GlossarySnapshot> snapshot(new GlossarySnapshot());
+    snapshot->files_ = {path};
+    snapshot->records_ = *records;
+    snapshot->strings_ = std::string_view(strings->data(), strings->size());
+    snapshot->matcher_ = GlossaryMatcher({*classOf, header.classes, *next, *outputStart, *outputs, *lengths}, file);
+    snapshot->storage_ = std::move(file);
+    return Snapshot(std::move(snapshot));
+}
+
+Result<size_t> GlossarySnapshot::writeCompiled(const std::string& path) const {
+    const GlossaryMatcher::Tables& tables = matcher_.tables();
+    if (tables.next.empty()) {
+        // Snapshots always build a matcher, even with no terms
+        return Err<size_t>(ErrorCode::InvalidFormat, "Glossary has no automaton", path);
+    }
+
+    CompiledHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = FORMAT_VERSION;
+    header.terms = static_cast<uint32_t>(records_.size());
+    header.states = static_cast<uint32_t>(matcher_.states());
+    header.classes = tables.classes;
+    header.outputs = static_cast<uint32_t>(tables.outputs.size());
+    header.stringBytes = static_cast<uint32_t>(strings_.size());
+    uint64_t offset = sizeof(header);
+    auto place = [&offset](uint64_t bytes) {
+        const uint64_t at = alignUp(offset);
+        offset = at + bytes;
+        return at;
+    };
+    header.classOfOffset = place(tables.classOf.size_bytes());
+    header.nextOffset = place(tables.next.size_bytes());
+    header.outputStartOffset = place(tables.outputStart.size_bytes());
+    header.outputsOffset = place(tables.outputs.size_bytes());
+    header.lengthsOffset = place(tables.lengths.size_bytes());
+    header.termsOffset = place(records_.size_bytes());
+    header.stringsOffset = place(strings_.size());
+    header.fileSize = offset;
+
+    // Written beside the target and renamed over it, so a daemon that
+    // has the old file mapped keeps reading the old contents
+    const std::string temp = path + ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return Err<size_t>(ErrorCode::PermissionDenied, "Cannot write compiled glossary", temp);
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        writeSection(out, header.classOfOffset, tables.classOf);
+        writeSection(out, header.nextOffset, tables.next);
+        writeSection(out, header.outputStartOffset, tables.outputStart);
+        writeSection(out, header.outputsOffset, tables.outputs);
+        writeSection(out, header.lengthsOffset, tables.lengths);
+        writeSection(out, header.termsOffset, records_);
+        writeSection(out, header.stringsOffset, std::span<const char>(strings_.data(), strings_.size()));
+        if (!out.flush()) {
+            return Err<size_t>(ErrorCode::SystemError, "Failed writing compiled glossary", temp);
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(temp, path, ec);
+    if (ec) {
+        std::filesystem::remove(temp, ec);
+        return Err<size_t>(ErrorCode::SystemError, "Cannot replace compiled glossary", path);
+    }
+    return static_cast<size_t>(header.fileSize);
+}
+
+} // namespace sdrtrunk
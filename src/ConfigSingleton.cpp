@@ -12,15 +12,49 @@ ConfigSingleton &ConfigSingleton::getInstance()
     return instance;
 }
 
+// DECODE_PROFILE is either a preset name or a block with an optional
+// PRESET (default "accurate") and per-setting overrides
+static sdrtrunk::Result<sdrtrunk::DecodeProfile> parseDecodeProfile(const YamlNode &node)
+{
+    if (std::holds_alternative<std::string>(node.getValue())) {
+        return sdrtrunk::decodeProfilePreset(node.as<std::string>());
+    }
+    std::string preset = "accurate";
+    if (node.hasKey("PRESET")) {
+        preset = node["PRESET"].as<std::string>();
+    }
+    auto profile = sdrtrunk::decodeProfilePreset(preset);
+    if (!profile.has_value()) {
+        return profile;
+    }
+    try {
+        if (node.hasKey("BEAM_SIZE")) profile->beamSize = node["BEAM_SIZE"].as<int>();
+        if (node.hasKey("PATIENCE")) profile->patience = node["PATIENCE"].as<double>();
+        if (node.hasKey("BEST_OF")) profile->bestOf = node["BEST_OF"].as<int>();
+        if (node.hasKey("TEMPERATURE")) profile->temperature = node["TEMPERATURE"].as<double>();
+        if (node.hasKey("VAD_THRESHOLD")) profile->vadThreshold = node["VAD_THRESHOLD"].as<double>();
+        if (node.hasKey("MIN_SILENCE_DURATION_MS")) profile->minSilenceDurationMs = node["MIN_SILENCE_DURATION_MS"].as<int>();
+    } catch (const std::exception &e) {
+        return sdrtrunk::Err<sdrtrunk::DecodeProfile>(sdrtrunk::ErrorCode::ConfigError, e.what(), "DECODE_PROFILE");
+    }
+    if (profile->beamSize < 1 || profile->bestOf < 1) {
+        return sdrtrunk::Err<sdrtrunk::DecodeProfile>(sdrtrunk::ErrorCode::ConfigError,
+                                                      "BEAM_SIZE and BEST_OF must be at least 1", "DECODE_PROFILE");
+    }
+    return profile;
+}
+
 void ConfigSingleton::initialize(const YamlNode &config)
 {
     // Parsing TALKGROUP_FILES with debug output
     const YamlNode &tgFilesNode = config["TALKGROUP_FILES"];
     auto tgKeys = tgFilesNode.getKeys();
+    // One glossary set per distinct file list, built here so that
+    // transcriptions only look terms up
     for (const auto &tgKey : tgKeys) {
         std::cout << "[" << getCurrentTime() << "] " << "ConfigSingleton.cpp Processing Talkgroup: " << tgKey << std::endl; // Debugging output
 
-        std::unordered_set<int> tgIDs = parseTalkgroupIDs(tgKey);
+        std::vector<sdrtrunk::TalkgroupRange> tgRanges = sdrtrunk::parseTalkgroupRanges(tgKey);
         const YamlNode &tgNode = tgFilesNode[tgKey];
         const YamlNode &glossaryNode = tgNode["GLOSSARY"];
         
@@ -33,17 +67,29 @@ void ConfigSingleton::initialize(const YamlNode &config)
             }
         }
 
-        TalkgroupFiles tgFiles{glossaryFiles, {}};
+        TalkgroupFiles tgFiles{glossaryFiles, {}, std::nullopt, glossaries.get(glossaryFiles)};
         try {
             if (tgNode.hasKey("PROMPT")) {
                 tgFiles.prompt = tgNode["PROMPT"].as<std::string>();
                 std::cout << "[" << getCurrentTime() << "] " << "ConfigSingleton.cpp Added Prompt for talkgroup: " << tgKey << std::endl;
             }
         } catch (...) {}
-        for (int id : tgIDs) {
-            talkgroupFiles[id] = tgFiles;
+        if (tgNode.hasKey("DECODE_PROFILE")) {
+            auto profile = parseDecodeProfile(tgNode["DECODE_PROFILE"]);
+            if (profile.has_value()) {
+                tgFiles.decodeProfile = std::move(profile.value());
+                std::cout << "[" << getCurrentTime() << "] " << "ConfigSingleton.cpp Decode profile " << tgFiles.decodeProfile->name
+                          << " for talkgroup: " << tgKey << std::endl;
+            } else {
+                std::cerr << "[" << getCurrentTime() << "] " << "ConfigSingleton.cpp Ignoring DECODE_PROFILE for talkgroup "
+                          << tgKey << ": " << profile.error().toString() << std::endl;
+            }
         }
+        talkgroupFiles.assign(tgRanges, std::move(tgFiles));
     }
+    std::cout << "[" << getCurrentTime() << "] " << "ConfigSingleton.cpp Built " << glossaries.size()
+              << " glossary set(s) and " << talkgroupFiles.profileCount() << " talkgroup profile(s) for "
+              << talkgroupFiles.size() << " talkgroup(s) in " << talkgroupFiles.intervalCount() << " range(s)" << std::endl;
     databasePath = config["DATABASE_PATH"].as<std::string>();
     directoryToMonitor = config["DirectoryToMonitor"].as<std::string>();
     loopWaitSeconds = config["LoopWaitSeconds"].as<int>();
@@ -58,6 +104,122 @@ void ConfigSingleton::initialize(const YamlNode &config)
     } catch (...) {
         maxThreads = 1;
     }
+    // Local (--local) transcription engine: faster-whisper or whisper.cpp
+    try {
+        localBackend = config["LOCAL_BACKEND"].as<std::string>();
+    } catch (...) {
+        localBackend = "faster-whisper";
+    }
+    try {
+        whisperCppModelPath = config["WHISPER_CPP_MODEL"].as<std::string>();
+    } catch (...) {
+        whisperCppModelPath = "";
+    }
+    try {
+        whisperCppThreads = config["WHISPER_CPP_THREADS"].as<int>();
+    } catch (...) {
+        whisperCppThreads = 4;
+    }
+    // Hybrid routing splits recordings between the local and OpenAI backends
+    try {
+        hybridRouting = config["HYBRID_ROUTING"].as<bool>();
+    } catch (...) {
+        hybridRouting = false;
+    }
+    routingRules = sdrtrunk::RoutingRules{};
+    try {
+        routingRules.localMaxDurationSeconds = config["HYBRID_LOCAL_MAX_DURATION_SECONDS"].as<int>();
+    } catch (...) {}
+    try {
+        routingRules.localMaxInFlight = config["HYBRID_LOCAL_MAX_IN_FLIGHT"].as<int>();
+    } catch (...) {}
+    try {
+        routingRules.remoteMinHeadroom = config["HYBRID_REMOTE_MIN_HEADROOM"].as<int>();
+    } catch (...) {}
+    try {
+        routingRules.localTalkgroups = parseTalkgroupIDs(config["HYBRID_LOCAL_TALKGROUPS"].as<std::string>());
+    } catch (...) {}
+    try {
+        routingRules.remoteTalkgroups = parseTalkgroupIDs(config["HYBRID_REMOTE_TALKGROUPS"].as<std::string>());
+    } catch (...) {}
+    // Voice-activity gate run before transcription
+    try {
+        vadEnabled = config["VAD_ENABLED"].as<bool>();
+    } catch (...) {
+        vadEnabled = false;
+    }
+    vadConfig = sdrtrunk::VadConfig{};
+    try {
+        vadConfig.minSpeechRatio = config["VAD_MIN_SPEECH_RATIO"].as<double>();
+    } catch (...) {}
+    try {
+        vadConfig.energyThresholdDb = config["VAD_ENERGY_THRESHOLD_DB"].as<double>();
+    } catch (...) {}
+    try {
+        vadConfig.maxZeroCrossingRate = config["VAD_MAX_ZERO_CROSSING_RATE"].as<double>();
+    } catch (...) {}
+    try {
+        vadConfig.maxSpectralFlatness = config["VAD_MAX_SPECTRAL_FLATNESS"].as<double>();
+    } catch (...) {}
+    // Two-tier local transcription: draft model first, full model on low confidence
+    try {
+        tieredTranscription = config["TIERED_TRANSCRIPTION"].as<bool>();
+    } catch (...) {
+        tieredTranscription = false;
+    }
+    try {
+        tierDraftModel = config["TIER_DRAFT_MODEL"].as<std::string>();
+    } catch (...) {
+        tierDraftModel = "small.en";
+    }
+    try {
+        whisperCppDraftModelPath = config["WHISPER_CPP_DRAFT_MODEL"].as<std::string>();
+    } catch (...) {
+        whisperCppDraftModelPath = "";
+    }
+    tierThresholds = sdrtrunk::TierThresholds{};
+    try {
+        tierThresholds.minAvgLogprob = config["TIER_MIN_AVG_LOGPROB"].as<double>();
+    } catch (...) {}
+    try {
+        tierThresholds.maxNoSpeechProb = config["TIER_MAX_NO_SPEECH_PROB"].as<double>();
+    } catch (...) {}
+    // Reuse transcriptions of simulcast / patched copies of the same call
+    try {
+        fingerprintDedup = config["FINGERPRINT_DEDUP"].as<bool>();
+    } catch (...) {
+        fingerprintDedup = false;
+    }
+    fingerprintConfig = sdrtrunk::FingerprintConfig{};
+    try {
+        fingerprintConfig.windowSeconds = config["FINGERPRINT_WINDOW_SECONDS"].as<int>();
+    } catch (...) {}
+    try {
+        fingerprintConfig.minSimilarity = config["FINGERPRINT_MIN_SIMILARITY"].as<double>();
+    } catch (...) {}
+    // Split long local transcriptions at pauses and run the chunks in parallel
+    chunkingConfig = sdrtrunk::ChunkingConfig{};
+    try {
+        chunkingConfig.thresholdSeconds = config["CHUNK_THRESHOLD_SECONDS"].as<double>();
+    } catch (...) {}
+    try {
+        chunkingConfig.targetChunkSeconds = config["CHUNK_TARGET_SECONDS"].as<double>();
+    } catch (...) {}
+    try {
+        chunkingConfig.maxParallel = config["CHUNK_MAX_PARALLEL"].as<int>();
+    } catch (...) {}
+    // Decoded PCM held across all workers at once
+    try {
+        decodeMemoryCapMb = config["DECODE_MEMORY_CAP_MB"].as<int>();
+    } catch (...) {
+        decodeMemoryCapMb = 512;
+    }
+    // How often glossary files are checked for edits; 0 loads them once
+    try {
+        glossaryReloadSeconds = config["GLOSSARY_RELOAD_SECONDS"].as<int>();
+    } catch (...) {
+        glossaryReloadSeconds = 5;
+    }
     // Handle optional debug flags with defaults
     try {
         debugCurlHelper = config["DEBUG_CURL_HELPER"].as<bool>();
@@ -86,7 +248,7 @@ void ConfigSingleton::initialize(const YamlNode &config)
     }
 }
 
-const std::unordered_map<int, TalkgroupFiles>& ConfigSingleton::getTalkgroupFiles() const {
+const sdrtrunk::TalkgroupProfiles& ConfigSingleton::getTalkgroupFiles() const {
         return talkgroupFiles;
 }
 std::string ConfigSingleton::getDatabasePath() const { return databasePath; }
@@ -95,6 +257,23 @@ std::string ConfigSingleton::getOpenAIAPIKey() const { return openaiAPIKey; }
 int ConfigSingleton::getLoopWaitSeconds() const { return loopWaitSeconds; }
 int ConfigSingleton::getMinDurationSeconds() const { return minDurationSeconds; }
 int ConfigSingleton::getMaxThreads() const { return maxThreads; }
+std::string ConfigSingleton::getLocalBackend() const { return localBackend; }
+std::string ConfigSingleton::getWhisperCppModelPath() const { return whisperCppModelPath; }
+int ConfigSingleton::getWhisperCppThreads() const { return whisperCppThreads; }
+bool ConfigSingleton::isHybridRouting() const { return hybridRouting; }
+const sdrtrunk::RoutingRules& ConfigSingleton::getRoutingRules() const { return routingRules; }
+bool ConfigSingleton::isVadEnabled() const { return vadEnabled; }
+const sdrtrunk::VadConfig& ConfigSingleton::getVadConfig() const { return vadConfig; }
+bool ConfigSingleton::isTieredTranscription() const { return tieredTranscription; }
+std::string ConfigSingleton::getTierDraftModel() const { return tierDraftModel; }
+std::string ConfigSingleton::getWhisperCppDraftModelPath() const { return whisperCppDraftModelPath; }
+const sdrtrunk::TierThresholds& ConfigSingleton::getTierThresholds() const { return tierThresholds; }
+bool ConfigSingleton::isFingerprintDedup() const { return fingerprintDedup; }
+const sdrtrunk::FingerprintConfig& ConfigSingleton::getFingerprintConfig() const { return fingerprintConfig; }
+const sdrtrunk::ChunkingConfig& ConfigSingleton::getChunkingConfig() const { return chunkingConfig; }
+int ConfigSingleton::getDecodeMemoryCapMb() const { return decodeMemoryCapMb; }
+int ConfigSingleton::getGlossaryReloadSeconds() const { return glossaryReloadSeconds; }
+sdrtrunk::GlossaryCache& ConfigSingleton::getGlossaries() { return glossaries; }
 int ConfigSingleton::getMaxRetries() const { return maxRetries; }
 int ConfigSingleton::getMaxRequestsPerMinute() const { return maxRequestsPerMinute; }
 int ConfigSingleton::getErrorWindowSeconds() const { return errorWindowSeconds; }
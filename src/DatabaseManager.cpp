@@ -1,9 +1,12 @@
 // Standard Library Headers
+#include <algorithm>
 #include <iostream>
+#include <utility>
 
 // Project-Specific Headers
 #include "../include/DatabaseManager.h"
 #include "../include/debugUtils.h"
+#include "../include/SdrTrunkFilename.h"
 
 DatabaseManager::DatabaseManager(const std::string &dbPath)
 {
@@ -122,13 +125,189 @@ void DatabaseManager::createTable()
 
     // Migrate old schema if needed
     migrateSchema();
+
+    // Columns added after the table was first shipped
+    addColumnIfMissing("skip_reason", "TEXT NOT NULL DEFAULT ''");
+    addColumnIfMissing("speech_ratio", "REAL");
+    addColumnIfMissing("duplicate_of", "TEXT NOT NULL DEFAULT ''");
+
+    // Per-talkgroup hit rate and compute for tiered transcription
+    const char *tierSQL = R"(
+        CREATE TABLE IF NOT EXISTS talkgroup_tier_stats (
+            talkgroup_id INTEGER PRIMARY KEY,
+            draft_accepted INTEGER NOT NULL DEFAULT 0,
+            escalated INTEGER NOT NULL DEFAULT 0,
+            draft_compute_seconds REAL NOT NULL DEFAULT 0.0,
+            full_compute_seconds REAL NOT NULL DEFAULT 0.0,
+            saved_compute_seconds REAL NOT NULL DEFAULT 0.0
+        )
+    )";
+    if (sqlite3_exec(db, tierSQL, 0, 0, &errMsg) != SQLITE_OK)
+    {
+        std::cerr << "[" << getCurrentTime() << "] "
+                  << "DatabaseManager.cpp createTable talkgroup_tier_stats: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+    }
+
+    // Spectral fingerprints of transcribed recordings, looked up by time
+    // to catch simulcast and patched copies of the same call
+    const char *fingerprintSQL = R"(
+        CREATE TABLE IF NOT EXISTS audio_fingerprints (
+            filename TEXT PRIMARY KEY,
+            talkgroup_id INTEGER NOT NULL,
+            unixtime INTEGER NOT NULL,
+            fingerprint BLOB NOT NULL,
+            transcription TEXT NOT NULL DEFAULT ''
+        )
+    )";
+    if (sqlite3_exec(db, fingerprintSQL, 0, 0, &errMsg) != SQLITE_OK)
+    {
+        std::cerr << "[" << getCurrentTime() << "] "
+                  << "DatabaseManager.cpp createTable audio_fingerprints: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+    }
+    sqlite3_exec(db, "CREATE INDEX IF NOT EXISTS idx_audio_fingerprints_unixtime ON audio_fingerprints(unixtime);", 0, 0, 0);
+
+    // Probed duration and format, one row per file; size and mtime tell a
+    // rewritten file (or a reused inode) from the one that was probed
+    const char *metadataSQL = R"(
+        CREATE TABLE IF NOT EXISTS audio_metadata (
+            device INTEGER NOT NULL,
+            inode INTEGER NOT NULL,
+            size INTEGER NOT NULL,
+            mtime_ns INTEGER NOT NULL,
+            duration REAL NOT NULL,
+            sample_rate INTEGER NOT NULL,
+            channels INTEGER NOT NULL,
+            bitrate_kbps INTEGER NOT NULL,
+            format TEXT NOT NULL,
+            PRIMARY KEY (device, inode)
+        ) WITHOUT ROWID
+    )";
+    if (sqlite3_exec(db, metadataSQL, 0, 0, &errMsg) != SQLITE_OK)
+    {
+        std::cerr << "[" << getCurrentTime() << "] "
+                  << "DatabaseManager.cpp createTable audio_metadata: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+    }
+
+    // Every talkgroup a recording was heard on (all members of a patch),
+    // with unixtime copied in so per-talkgroup time ranges are index seeks
+    const char *talkgroupsSQL = R"(
+        CREATE TABLE IF NOT EXISTS recording_talkgroups (
+            recording_id INTEGER NOT NULL,
+            talkgroup_id INTEGER NOT NULL,
+            unixtime INTEGER NOT NULL,
+            PRIMARY KEY (recording_id, talkgroup_id)
+        ) WITHOUT ROWID
+    )";
+    if (sqlite3_exec(db, talkgroupsSQL, 0, 0, &errMsg) != SQLITE_OK)
+    {
+        std::cerr << "[" << getCurrentTime() << "] "
+                  << "DatabaseManager.cpp createTable recording_talkgroups: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+        return;
+    }
+    sqlite3_exec(db, "CREATE INDEX IF NOT EXISTS idx_recording_talkgroups_talkgroup_unixtime ON recording_talkgroups(talkgroup_id, unixtime);", 0, 0, 0);
+    backfillRecordingTalkgroups();
+}
+
+// Fills recording_talkgroups for recordings stored before it existed,
+// re-parsing their filenames for the patch members
+void DatabaseManager::backfillRecordingTalkgroups()
+{
+    sqlite3_stmt *stmt;
+    const char *selectSQL = R"(
+        SELECT id, filename, talkgroup_id, unixtime FROM recordings
+        WHERE id NOT IN (SELECT recording_id FROM recording_talkgroups)
+    )";
+    if (sqlite3_prepare_v2(db, selectSQL, -1, &stmt, 0) != SQLITE_OK)
+        return;
+
+    sqlite3_exec(db, "BEGIN TRANSACTION;", 0, 0, 0);
+    int backfilled = 0;
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+        const sqlite3_int64 id = sqlite3_column_int64(stmt, 0);
+        const std::string filename = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 1));
+        std::vector<int> talkgroups = sdrtrunk::recordingTalkgroups(sdrtrunk::parseSdrTrunkFilename(filename));
+        talkgroups.insert(talkgroups.begin(), sqlite3_column_int(stmt, 2));
+        if (insertRecordingTalkgroups(id, sqlite3_column_int64(stmt, 3), talkgroups))
+            ++backfilled;
+    }
+    sqlite3_finalize(stmt);
+    sqlite3_exec(db, "COMMIT;", 0, 0, 0);
+
+    if (backfilled > 0)
+    {
+        std::cout << "[" << getCurrentTime() << "] "
+                  << "DatabaseManager.cpp backfillRecordingTalkgroups Indexed talkgroups of " << backfilled << " recordings" << std::endl;
+    }
 }
 
-void DatabaseManager::insertRecording(const std::string &date, const std::string &time, int64_t unixtime, int talkgroupID, const std::string &talkgroupName, int radioID, double duration, const std::string &filename, const std::string &filepath, const std::string &transcription, const std::string &v2transcription)
+// Caller holds the write lock or is creating the schema. Duplicate
+// talkgroups are stored once.
+bool DatabaseManager::insertRecordingTalkgroups(sqlite3_int64 recordingID, int64_t unixtime, const std::vector<int> &talkgroups)
+{
+    sqlite3_stmt *stmt;
+    const char *insertSQL = "INSERT OR IGNORE INTO recording_talkgroups (recording_id, talkgroup_id, unixtime) VALUES (?, ?, ?)";
+    if (sqlite3_prepare_v2(db, insertSQL, -1, &stmt, 0) != SQLITE_OK)
+    {
+        std::cerr << "[" << getCurrentTime() << "] "
+                  << "DatabaseManager.cpp insertRecordingTalkgroups Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+
+    bool ok = true;
+    sqlite3_bind_int64(stmt, 1, recordingID);
+    sqlite3_bind_int64(stmt, 3, unixtime);
+    for (int talkgroup : talkgroups)
+    {
+        sqlite3_bind_int(stmt, 2, talkgroup);
+        if (sqlite3_step(stmt) != SQLITE_DONE)
+        {
+            std::cerr << "[" << getCurrentTime() << "] "
+                      << "DatabaseManager.cpp insertRecordingTalkgroups Execution failed: " << sqlite3_errmsg(db) << std::endl;
+            ok = false;
+            break;
+        }
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+    return ok;
+}
+
+void DatabaseManager::addColumnIfMissing(const std::string &column, const std::string &definition)
+{
+    sqlite3_stmt *stmt;
+    if (sqlite3_prepare_v2(db, "PRAGMA table_info(recordings);", -1, &stmt, 0) != SQLITE_OK)
+        return;
+
+    bool exists = false;
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+        if (column == reinterpret_cast<const char *>(sqlite3_column_text(stmt, 1)))
+            exists = true;
+    }
+    sqlite3_finalize(stmt);
+    if (exists)
+        return;
+
+    std::string sql = "ALTER TABLE recordings ADD COLUMN " + column + " " + definition + ";";
+    char *errMsg = 0;
+    if (sqlite3_exec(db, sql.c_str(), 0, 0, &errMsg) != SQLITE_OK)
+    {
+        std::cerr << "[" << getCurrentTime() << "] "
+                  << "DatabaseManager.cpp addColumnIfMissing " << column << ": " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+    }
+}
+
+void DatabaseManager::insertRecording(const std::string &date, const std::string &time, int64_t unixtime, int talkgroupID, const std::string &talkgroupName, int radioID, double duration, const std::string &filename, const std::string &filepath, const std::string &transcription, const std::string &v2transcription, const std::string &skipReason, double speechRatio, const std::string &duplicateOf, const std::vector<int> &talkgroups)
 {
     std::lock_guard<std::mutex> lock(writeMutex_);
 
-    std::string insertSQL = "INSERT OR IGNORE INTO recordings (date, time, unixtime, talkgroup_id, talkgroup_name, radio_id, duration, filename, filepath, transcription, v2transcription) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)";
+    std::string insertSQL = "INSERT OR IGNORE INTO recordings (date, time, unixtime, talkgroup_id, talkgroup_name, radio_id, duration, filename, filepath, transcription, v2transcription, skip_reason, speech_ratio, duplicate_of) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)";
     sqlite3_stmt *stmt;
     int rc = sqlite3_prepare_v2(db, insertSQL.c_str(), -1, &stmt, 0);
     if (rc != SQLITE_OK)
@@ -150,15 +329,334 @@ void DatabaseManager::insertRecording(const std::string &date, const std::string
     sqlite3_bind_text(stmt, 9, filepath.c_str(), -1, SQLITE_STATIC);
     sqlite3_bind_text(stmt, 10, transcription.c_str(), -1, SQLITE_STATIC);
     sqlite3_bind_text(stmt, 11, v2transcription.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 12, skipReason.c_str(), -1, SQLITE_STATIC);
+    if (speechRatio >= 0.0)
+        sqlite3_bind_double(stmt, 13, speechRatio);
+    else
+        sqlite3_bind_null(stmt, 13);
+    sqlite3_bind_text(stmt, 14, duplicateOf.c_str(), -1, SQLITE_STATIC);
 
+    // The recording and its talkgroup rows are stored together or not at all
+    sqlite3_exec(db, "BEGIN TRANSACTION;", 0, 0, 0);
     rc = sqlite3_step(stmt);
     if (rc != SQLITE_DONE)
     {
         std::cerr << "[" << getCurrentTime() << "] "
                   << "DatabaseManager.cpp insertRecording Execution failed: " << sqlite3_errmsg(db) << std::endl;
         sqlite3_finalize(stmt);
+        sqlite3_exec(db, "ROLLBACK;", 0, 0, 0);
+        return;
+    }
+    sqlite3_finalize(stmt);
+
+    // Nothing more to index when the filename was already recorded
+    if (sqlite3_changes(db) > 0)
+    {
+        std::vector<int> allTalkgroups = talkgroups;
+        if (std::ranges::find(allTalkgroups, talkgroupID) == allTalkgroups.end())
+            allTalkgroups.insert(allTalkgroups.begin(), talkgroupID);
+        if (!insertRecordingTalkgroups(sqlite3_last_insert_rowid(db), unixtime, allTalkgroups))
+        {
+            sqlite3_exec(db, "ROLLBACK;", 0, 0, 0);
+            return;
+        }
+    }
+    sqlite3_exec(db, "COMMIT;", 0, 0, 0);
+}
+
+void DatabaseManager::recordTierOutcome(int talkgroupID, bool escalated, double draftSeconds, double fullSeconds, double savedSeconds)
+{
+    std::lock_guard<std::mutex> lock(writeMutex_);
+
+    const char *upsertSQL = R"(
+        INSERT INTO talkgroup_tier_stats (talkgroup_id, draft_accepted, escalated, draft_compute_seconds, full_compute_seconds, saved_compute_seconds)
+        VALUES (?1, ?2, ?3, ?4, ?5, ?6)
+        ON CONFLICT(talkgroup_id) DO UPDATE SET
+            draft_accepted = draft_accepted + excluded.draft_accepted,
+            escalated = escalated + excluded.escalated,
+            draft_compute_seconds = draft_compute_seconds + excluded.draft_compute_seconds,
+            full_compute_seconds = full_compute_seconds + excluded.full_compute_seconds,
+            saved_compute_seconds = saved_compute_seconds + excluded.saved_compute_seconds
+    )";
+    sqlite3_stmt *stmt;
+    if (sqlite3_prepare_v2(db, upsertSQL, -1, &stmt, 0) != SQLITE_OK)
+    {
+        std::cerr << "[" << getCurrentTime() << "] "
+                  << "DatabaseManager.cpp recordTierOutcome Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+        return;
+    }
+
+    sqlite3_bind_int(stmt, 1, talkgroupID);
+    sqlite3_bind_int(stmt, 2, escalated ? 0 : 1);
+    sqlite3_bind_int(stmt, 3, escalated ? 1 : 0);
+    sqlite3_bind_double(stmt, 4, draftSeconds);
+    sqlite3_bind_double(stmt, 5, fullSeconds);
+    sqlite3_bind_double(stmt, 6, savedSeconds);
+
+    if (sqlite3_step(stmt) != SQLITE_DONE)
+    {
+        std::cerr << "[" << getCurrentTime() << "] "
+                  << "DatabaseManager.cpp recordTierOutcome Execution failed: " << sqlite3_errmsg(db) << std::endl;
+    }
+    sqlite3_finalize(stmt);
+}
+
+void DatabaseManager::insertFingerprint(const std::string &filename, int talkgroupID, int64_t unixtime, const std::vector<uint8_t> &fingerprint, const std::string &transcription)
+{
+    std::lock_guard<std::mutex> lock(writeMutex_);
+
+    const char *insertSQL = "INSERT OR REPLACE INTO audio_fingerprints (filename, talkgroup_id, unixtime, fingerprint, transcription) VALUES (?, ?, ?, ?, ?)";
+    sqlite3_stmt *stmt;
+    if (sqlite3_prepare_v2(db, insertSQL, -1, &stmt, 0) != SQLITE_OK)
+    {
+        std::cerr << "[" << getCurrentTime() << "] "
+                  << "DatabaseManager.cpp insertFingerprint Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+        return;
+    }
+
+    sqlite3_bind_text(stmt, 1, filename.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int(stmt, 2, talkgroupID);
+    sqlite3_bind_int64(stmt, 3, unixtime);
+    sqlite3_bind_blob(stmt, 4, fingerprint.data(), static_cast<int>(fingerprint.size()), SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 5, transcription.c_str(), -1, SQLITE_STATIC);
+
+    if (sqlite3_step(stmt) != SQLITE_DONE)
+    {
+        std::cerr << "[" << getCurrentTime() << "] "
+                  << "DatabaseManager.cpp insertFingerprint Execution failed: " << sqlite3_errmsg(db) << std::endl;
+    }
+    sqlite3_finalize(stmt);
+}
+
+std::vector<StoredFingerprint> DatabaseManager::findFingerprintsNear(int64_t unixtime, int windowSeconds)
+{
+    std::lock_guard<std::mutex> lock(writeMutex_);
+
+    std::vector<StoredFingerprint> found;
+    const char *selectSQL = R"(
+        SELECT filename, talkgroup_id, unixtime, fingerprint, transcription
+        FROM audio_fingerprints
+        WHERE unixtime BETWEEN ?1 - ?2 AND ?1 + ?2 AND transcription != ''
+        ORDER BY ABS(unixtime - ?1)
+    )";
+    sqlite3_stmt *stmt;
+    if (sqlite3_prepare_v2(db, selectSQL, -1, &stmt, 0) != SQLITE_OK)
+    {
+        std::cerr << "[" << getCurrentTime() << "] "
+                  << "DatabaseManager.cpp findFingerprintsNear Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+        return found;
+    }
+
+    sqlite3_bind_int64(stmt, 1, unixtime);
+    sqlite3_bind_int(stmt, 2, windowSeconds);
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+        StoredFingerprint row;
+        row.filename = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0));
+        row.talkgroupID = sqlite3_column_int(stmt, 1);
+        row.unixtime = sqlite3_column_int64(stmt, 2);
+        const auto *blob = static_cast<const uint8_t *>(sqlite3_column_blob(stmt, 3));
+        row.fingerprint.assign(blob, blob + sqlite3_column_bytes(stmt, 3));
+        row.transcription = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 4));
+        found.push_back(std::move(row));
+    }
+    sqlite3_finalize(stmt);
+    return found;
+}
+
+std::optional<sdrtrunk::AudioMetadata> DatabaseManager::findAudioMetadata(const sdrtrunk::FileIdentity &identity)
+{
+    if (!identity.valid())
+    {
+        return std::nullopt;
+    }
+    std::lock_guard<std::mutex> lock(writeMutex_);
+
+    const char *selectSQL = R"(
+        SELECT duration, sample_rate, channels, bitrate_kbps, format
+        FROM audio_metadata
+        WHERE device = ? AND inode = ? AND size = ? AND mtime_ns = ?
+    )";
+    sqlite3_stmt *stmt;
+    if (sqlite3_prepare_v2(db, selectSQL, -1, &stmt, 0) != SQLITE_OK)
+    {
+        std::cerr << "[" << getCurrentTime() << "] "
+                  << "DatabaseManager.cpp findAudioMetadata Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+        return std::nullopt;
+    }
+
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(identity.device));
+    sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(identity.inode));
+    sqlite3_bind_int64(stmt, 3, static_cast<sqlite3_int64>(identity.size));
+    sqlite3_bind_int64(stmt, 4, identity.mtimeNs);
+    std::optional<sdrtrunk::AudioMetadata> found;
+    if (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+        sdrtrunk::AudioMetadata metadata;
+        metadata.durationSeconds = sqlite3_column_double(stmt, 0);
+        metadata.sampleRate = sqlite3_column_int(stmt, 1);
+        metadata.channels = sqlite3_column_int(stmt, 2);
+        metadata.bitrateKbps = sqlite3_column_int(stmt, 3);
+        metadata.format = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 4));
+        found = std::move(metadata);
+    }
+    sqlite3_finalize(stmt);
+    return found;
+}
+
+void DatabaseManager::storeAudioMetadata(const sdrtrunk::FileIdentity &identity, const sdrtrunk::AudioMetadata &metadata)
+{
+    if (!identity.valid())
+    {
         return;
     }
+    std::lock_guard<std::mutex> lock(writeMutex_);
 
+    const char *upsertSQL = R"(
+        INSERT OR REPLACE INTO audio_metadata
+            (device, inode, size, mtime_ns, duration, sample_rate, channels, bitrate_kbps, format)
+        VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)
+    )";
+    sqlite3_stmt *stmt;
+    if (sqlite3_prepare_v2(db, upsertSQL, -1, &stmt, 0) != SQLITE_OK)
+    {
+        std::cerr << "[" << getCurrentTime() << "] "
+                  << "DatabaseManager.cpp storeAudioMetadata Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+        return;
+    }
+
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(identity.device));
+    sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(identity.inode));
+    sqlite3_bind_int64(stmt, 3, static_cast<sqlite3_int64>(identity.size));
+    sqlite3_bind_int64(stmt, 4, identity.mtimeNs);
+    sqlite3_bind_double(stmt, 5, metadata.durationSeconds);
+    sqlite3_bind_int(stmt, 6, metadata.sampleRate);
+    sqlite3_bind_int(stmt, 7, metadata.channels);
+    sqlite3_bind_int(stmt, 8, metadata.bitrateKbps);
+    sqlite3_bind_text(stmt, 9, metadata.format.c_str(), -1, SQLITE_STATIC);
+
+    if (sqlite3_step(stmt) != SQLITE_DONE)
+    {
+        std::cerr << "[" << getCurrentTime() << "] "
+                  << "DatabaseManager.cpp storeAudioMetadata Execution failed: " << sqlite3_errmsg(db) << std::endl;
+    }
+    sqlite3_finalize(stmt);
+}
+
+std::vector<std::string> DatabaseManager::findRecordingsByTalkgroup(int talkgroupID, int64_t fromUnixtime, int64_t toUnixtime)
+{
+    std::lock_guard<std::mutex> lock(writeMutex_);
+
+    std::vector<std::string> found;
+    const char *selectSQL = R"(
+        SELECT r.filename
+        FROM recording_talkgroups t
+        JOIN recordings r ON r.id = t.recording_id
+        WHERE t.talkgroup_id = ? AND t.unixtime BETWEEN ? AND ?
+        ORDER BY t.unixtime
+    )";
+    sqlite3_stmt *stmt;
+    if (sqlite3_prepare_v2(db, selectSQL, -1, &stmt, 0) != SQLITE_OK)
+    {
+        std::cerr << "[" << getCurrentTime() << "] "
+                  << "DatabaseManager.cpp findRecordingsByTalkgroup Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+        return found;
+    }
+
+    sqlite3_bind_int(stmt, 1, talkgroupID);
+    sqlite3_bind_int64(stmt, 2, fromUnixtime);
+    sqlite3_bind_int64(stmt, 3, toUnixtime);
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+        found.emplace_back(reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0)));
+    }
+    sqlite3_finalize(stmt);
+    return found;
+}
+
+std::vector<StoredTranscription> DatabaseManager::readTranscriptions(const TranscriptionFilter &filter, sqlite3_int64 afterID, size_t limit)
+{
+    std::lock_guard<std::mutex> lock(writeMutex_);
+
+    // Only the filters in use go into the query, so each can use its index.
+    // Skipped recordings were never enriched and have nothing to redo.
+    std::string selectSQL = R"(
+        SELECT id, talkgroup_id, radio_id, transcription, v2transcription
+        FROM recordings
+        WHERE id > ?1 AND transcription != '' AND skip_reason = '')";
+    if (filter.talkgroupID)
+        selectSQL += " AND talkgroup_id = ?2";
+    if (filter.fromUnixtime)
+        selectSQL += " AND unixtime >= ?3";
+    if (filter.toUnixtime)
+        selectSQL += " AND unixtime < ?4";
+    selectSQL += " ORDER BY id LIMIT ?5";
+
+    std::vector<StoredTranscription> found;
+    sqlite3_stmt *stmt;
+    if (sqlite3_prepare_v2(db, selectSQL.c_str(), -1, &stmt, 0) != SQLITE_OK)
+    {
+        std::cerr << "[" << getCurrentTime() << "] "
+                  << "DatabaseManager.cpp readTranscriptions Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+        return found;
+    }
+
+    sqlite3_bind_int64(stmt, 1, afterID);
+    if (filter.talkgroupID)
+        sqlite3_bind_int(stmt, 2, *filter.talkgroupID);
+    if (filter.fromUnixtime)
+        sqlite3_bind_int64(stmt, 3, *filter.fromUnixtime);
+    if (filter.toUnixtime)
+        sqlite3_bind_int64(stmt, 4, *filter.toUnixtime);
+    sqlite3_bind_int64(stmt, 5, static_cast<sqlite3_int64>(limit));
+    found.reserve(limit);
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+        StoredTranscription row;
+        row.id = sqlite3_column_int64(stmt, 0);
+        row.talkgroupID = sqlite3_column_int(stmt, 1);
+        row.radioID = sqlite3_column_int(stmt, 2);
+        row.transcription = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 3));
+        row.v2transcription = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 4));
+        found.push_back(std::move(row));
+    }
+    sqlite3_finalize(stmt);
+    return found;
+}
+
+size_t DatabaseManager::updateV2Transcriptions(const std::vector<std::pair<sqlite3_int64, std::string>> &updates)
+{
+    if (updates.empty())
+        return 0;
+    std::lock_guard<std::mutex> lock(writeMutex_);
+
+    sqlite3_stmt *stmt;
+    if (sqlite3_prepare_v2(db, "UPDATE recordings SET v2transcription = ? WHERE id = ?", -1, &stmt, 0) != SQLITE_OK)
+    {
+        std::cerr << "[" << getCurrentTime() << "] "
+                  << "DatabaseManager.cpp updateV2Transcriptions Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+        return 0;
+    }
+
+    // One transaction per batch: one journal sync instead of one per row
+    sqlite3_exec(db, "BEGIN TRANSACTION;", 0, 0, 0);
+    size_t updated = 0;
+    for (const auto &[id, v2transcription] : updates)
+    {
+        sqlite3_bind_text(stmt, 1, v2transcription.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_int64(stmt, 2, id);
+        if (sqlite3_step(stmt) != SQLITE_DONE)
+        {
+            std::cerr << "[" << getCurrentTime() << "] "
+                      << "DatabaseManager.cpp updateV2Transcriptions Execution failed: " << sqlite3_errmsg(db) << std::endl;
+            sqlite3_finalize(stmt);
+            sqlite3_exec(db, "ROLLBACK;", 0, 0, 0);
+            return 0;
+        }
+        updated += static_cast<size_t>(sqlite3_changes(db));
+        sqlite3_reset(stmt);
+    }
     sqlite3_finalize(stmt);
+    sqlite3_exec(db, "COMMIT;", 0, 0, 0);
+    return updated;
 }
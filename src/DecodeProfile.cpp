@@ -0,0 +1,40 @@
+/**
+ * @file DecodeProfile.cpp
+ * @brief Built-in per-talkgroup decoding presets
+ */
+
+#include "../include/DecodeProfile.h"
+
+namespace sdrtrunk {
+
+Result<DecodeProfile> decodeProfilePreset(std::string_view name) {
+    DecodeProfile profile;
+    profile.name = std::string(name);
+    if (name == "accurate") {
+        // The fasterWhisper.py module defaults
+        return profile;
+    }
+    if (name == "balanced") {
+        profile.beamSize = 5;
+        profile.patience = 1.0;
+        profile.bestOf = 5;
+        profile.temperature = 0.0;
+        profile.minSilenceDurationMs = 1000;
+        return profile;
+    }
+    if (name == "fast") {
+        // Greedy decoding; shorter silences cut VAD segments sooner
+        profile.beamSize = 1;
+        profile.patience = 1.0;
+        profile.bestOf = 1;
+        profile.temperature = 0.0;
+        profile.vadThreshold = 0.5;
+        profile.minSilenceDurationMs = 500;
+        return profile;
+    }
+    return Err<DecodeProfile>(ErrorCode::ConfigError,
+                              "Unknown DECODE_PROFILE preset (expected fast, balanced or accurate)",
+                              std::string(name));
+}
+
+} // namespace sdrtrunk
@@ -0,0 +1,447 @@
+/**
+ * @file Glossary.cpp
+ * @brief Shared glossary snapshots
+ *
+ * generateV2Transcription() used to call readMappingFile() for each of a
+ * talkgroup's glossary files on every recording, parsing the JSON and
+ * rebuilding hyphen variants each time, and then compiled and ran a
+ * std::regex per term. A snapshot does the file work once per distinct
+ * file list, and its GlossaryMatcher finds every term in one pass over
+ * the transcription.
+ *
+ * Each file list's current snapshot lives in a GlossarySet. When
+ * GLOSSARY_RELOAD_SECONDS is set, a GlossaryWatcher polls the files'
+ * size and mtime and swaps in a rebuilt snapshot when they change.
+ *
+ * A snapshot's terms and automaton are flat arrays, so glossary-compiler
+ * can write them out and a compiled file is used in place once mapped
+ * (CompiledGlossary.cpp).
+ */
+
+#include "../include/Glossary.h"
+#include "../include/debugUtils.h"
+#include "../include/jsonParser.h"
+
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+namespace sdrtrunk {
+
+namespace {
+
+unsigned char foldCase(unsigned char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c - 'A' + 'a') : c;
+}
+
+bool isWordChar(unsigned char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+// What regex \b tests: a word character on exactly one side of pos
+bool isWordBoundary(std::string_view text, size_t pos) {
+    const bool before = pos > 0 && isWordChar(static_cast<unsigned char>(text[pos - 1]));
+    const bool after = pos < text.size() && isWordChar(static_cast<unsigned char>(text[pos]));
+    return before != after;
+}
+
+
+// Tables of a matcher built in memory
+struct OwnedTables {
+    std::array<uint16_t, 256> classOf{};
+    std::vector<uint32_t> next;
+    std::vector<uint32_t> outputStart;
+    std::vector<uint32_t> outputs;
+    std::vector<uint32_t> lengths;
+};
+
+// Records and string table of a snapshot built in memory
+struct OwnedTerms {
+    std::vector<GlossarySnapshot::TermRecord> records;
+    std::string strings;
+};
+
+std::string numberText(double num) {
+    if (num == static_cast<int>(num)) {
+        return std::to_string(static_cast<int>(num));
+    }
+    return std::to_string(num);
+}
+
+} // namespace
+
+GlossaryMatcher::GlossaryMatcher(const std::vector<std::string>& keys) {
+    auto owned = std::make_shared<OwnedTables>();
+
+    // Input classes: one per distinct folded byte used by any key
+    uint16_t nextClass = 1;
+    std::array<uint16_t, 256> foldedClass{};
+    for (const auto& key : keys) {
+        for (char c : key) {
+            auto& cls = foldedClass[foldCase(static_cast<unsigned char>(c))];
+            if (cls == 0) {
+                cls = nextClass++;
+            }
+        }
+    }
+    const uint32_t classes = nextClass;
+    for (size_t b = 0; b < 256; ++b) {
+        owned->classOf[b] = foldedClass[foldCase(static_cast<unsigned char>(b))];
+    }
+
+    // Trie of the folded keys
+    constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> trie(classes, NONE);
+    std::vector<std::vector<uint32_t>> ends(1);
+    owned->lengths.reserve(keys.size());
+    for (size_t k = 0; k < keys.size(); ++k) {
+        owned->lengths.push_back(static_cast<uint32_t>(keys[k].size()));
+        if (keys[k].empty()) {
+            continue;
+        }
+        uint32_t state = 0;
+        for (char c : keys[k]) {
+            const size_t slot = state * classes + owned->classOf[static_cast<unsigned char>(c)];
+            if (trie[slot] == NONE) {
+                trie[slot] = static_cast<uint32_t>(ends.size());
+                ends.emplace_back();
+                trie.resize(trie.size() + classes, NONE);
+            }
+            state = trie[slot];
+        }
+        ends[state].push_back(static_cast<uint32_t>(k));
+    }
+
+    // Breadth-first, fill missing transitions from the failure state and
+    // inherit its outputs, turning the trie into a DFA
+    const size_t stateCount = ends.size();
+    std::vector<uint32_t> fail(stateCount, 0);
+    std::deque<uint32_t> queue;
+    for (size_t c = 0; c < classes; ++c) {
+        uint32_t& child = trie[c];
+        if (child == NONE) {
+            child = 0;
+        } else {
+            queue.push_back(child);
+        }
+    }
+    while (!queue.empty()) {
+        const uint32_t state = queue.front();
+        queue.pop_front();
+        const auto& inherited = ends[fail[state]];
+        ends[state].insert(ends[state].end(), inherited.begin(), inherited.end());
+        for (size_t c = 0; c < classes; ++c) {
+            uint32_t& child = trie[state * classes + c];
+            const uint32_t viaFail = trie[fail[state] * classes + c];
+            if (child == NONE) {
+                child = viaFail;
+            } else {
+                fail[child] = viaFail;
+                queue.push_back(child);
+            }
+        }
+    }
+
+    owned->next = std::move(trie);
+    owned->outputStart.reserve(stateCount + 1);
+    for (const auto& keysHere : ends) {
+        owned->outputStart.push_back(static_cast<uint32_t>(owned->outputs.size()));
+        owned->outputs.insert(owned->outputs.end(), keysHere.begin(), keysHere.end());
+    }
+    owned->outputStart.push_back(static_cast<uint32_t>(owned->outputs.size()));
+
+    tables_ = {owned->classOf, classes, owned->next, owned->outputStart, owned->outputs, owned->lengths};
+    storage_ = std::move(owned);
+}
+
+std::span<const uint32_t> GlossaryMatcher::keysEndingAt(std::string_view key) const {
+    if (key.empty() || tables_.next.empty()) {
+        return {};
+    }
+    uint32_t state = 0;
+    for (char c : key) {
+        state = tables_.next[state * tables_.classes + tables_.classOf[static_cast<unsigned char>(c)]];
+    }
+    return tables_.outputs.subspan(tables_.outputStart[state], tables_.outputStart[state + 1] - tables_.outputStart[state]);
+}
+
+Result<std::unordered_map<std::string, std::string>> loadGlossaryJson(const std::string& path) {
+    using Mappings = std::unordered_map<std::string, std::string>;
+    if (!std::ifstream(path).is_open()) {
+        return Err<Mappings>(ErrorCode::FileNotFound, "Could not open file: " + path, "loadGlossaryJson");
+    }
+
+    Mappings mapping;
+    try {
+        // Multi-key format first, then the old flat one
+        auto glossaryEntries = JsonParser::parseGlossaryFile(path);
+        if (!glossaryEntries.empty()) {
+            for (const auto& entry : glossaryEntries) {
+                for (const auto& key : entry.keys) {
+                    mapping[key] = entry.value;
+                }
+            }
+        } else {
+            for (const auto& [key, value] : JsonParser::parseFile(path)) {
+                if (std::holds_alternative<std::string>(value)) {
+                    mapping[key] = std::get<std::string>(value);
+                } else if (std::holds_alternative<double>(value)) {
+                    mapping[key] = numberText(std::get<double>(value));
+                } else if (std::holds_alternative<bool>(value)) {
+                    std::cerr << "[" << getCurrentTime() << "] "
+                              << "Glossary.cpp loadGlossaryJson Boolean type detected for key: " << key << " in " << path << std::endl;
+                } else if (std::holds_alternative<std::nullptr_t>(value)) {
+                    std::cerr << "[" << getCurrentTime() << "] "
+                              << "Glossary.cpp loadGlossaryJson Null type detected for key: " << key << " in " << path << std::endl;
+                }
+            }
+        }
+    } catch (const std::exception& e) {
+        return Err<Mappings>(ErrorCode::InvalidFormat, std::string("JSON Error: ") + e.what(), path);
+    }
+
+    // Hyphen-stripped variants of hyphenated keys, unless already present
+    Mappings hyphenVariants;
+    for (const auto& [key, value] : mapping) {
+        if (key.find('-') != std::string::npos) {
+            std::string stripped = key;
+            stripped.erase(std::remove(stripped.begin(), stripped.end(), '-'), stripped.end());
+            if (mapping.find(stripped) == mapping.end()) {
+                hyphenVariants[stripped] = value;
+            }
+        }
+    }
+    mapping.insert(hyphenVariants.begin(), hyphenVariants.end());
+    return mapping;
+}
+
+Result<std::unordered_map<std::string, std::string>> mergeGlossaryFiles(const std::vector<std::string>& files,
+                                                                         bool strict) {
+    using Mappings = std::unordered_map<std::string, std::string>;
+    auto report = [](const Error& error) {
+        std::cerr << "[" << getCurrentTime() << "] "
+                  << "Glossary.cpp mergeGlossaryFiles " << error.message << " (" << error.context << ")" << std::endl;
+    };
+
+    Mappings merged;
+    for (const auto& file : files) {
+        if (GlossarySnapshot::isCompiled(file)) {
+            auto compiled = GlossarySnapshot::openCompiled(file);
+            if (!compiled) {
+                if (strict) {
+                    return std::unexpected(compiled.error());
+                }
+                report(compiled.error());
+                continue;
+            }
+            for (size_t i = 0; i < (*compiled)->size(); ++i) {
+                const GlossarySnapshot::Term t = (*compiled)->term(i);
+                merged.try_emplace(std::string(t.key), t.value);
+            }
+            continue;
+        }
+        auto fileMappings = loadGlossaryJson(file);
+        if (!fileMappings) {
+            if (strict) {
+                return std::unexpected(fileMappings.error());
+            }
+            // A missing file has always been skipped quietly
+            if (fileMappings.error().code != ErrorCode::FileNotFound) {
+                report(fileMappings.error());
+            }
+            continue;
+        }
+        merged.insert(fileMappings->begin(), fileMappings->end());
+    }
+    return merged;
+}
+
+std::shared_ptr<const GlossarySnapshot> GlossarySnapshot::build(const std::vector<std::string>& files) {
+    if (files.size() == 1 && isCompiled(files[0])) {
+        if (auto compiled = openCompiled(files[0])) {
+            return *compiled;
+        } else {
+            std::cerr << "[" << getCurrentTime() << "] "
+                      << "Glossary.cpp build " << compiled.error().message << " (" << compiled.error().context << ")"
+                      << std::endl;
+            return fromMappings(files, {});
+        }
+    }
+
+    auto merged = mergeGlossaryFiles(files, false);
+    return fromMappings(files, merged ? *merged : std::unordered_map<std::string, std::string>{});
+}
+
+std::shared_ptr<const GlossarySnapshot> GlossarySnapshot::fromMappings(
+    std::vector<std::string> files, const std::unordered_map<std::string, std::string>& mappings) {
+    auto owned = std::make_shared<OwnedTerms>();
+    owned->records.reserve(mappings.size());
+
+    // Many keys share a value (every spelling of a unit's callsign), so
+    // each distinct value is stored once
+    std::unordered_map<std::string_view, uint32_t> valueOffsets;
+    std::vector<std::string> keys;
+    keys.reserve(mappings.size());
+    for (const auto& [key, value] : mappings) {
+        TermRecord record{static_cast<uint32_t>(owned->strings.size()), static_cast<uint32_t>(key.size()), 0,
+                          static_cast<uint32_t>(value.size())};
+        owned->strings += key;
+        auto [interned, added] = valueOffsets.try_emplace(value, static_cast<uint32_t>(owned->strings.size()));
+        if (added) {
+            owned->strings += value;
+        }
+        record.valueOffset = interned->second;
+        owned->records.push_back(record);
+        keys.push_back(key);
+    }
+
+    std::shared_ptr<GlossarySnapshot> snapshot(new GlossarySnapshot());
+    snapshot->files_ = std::move(files);
+    snapshot->records_ = owned->records;
+    snapshot->strings_ = owned->strings;
+    snapshot->matcher_ = GlossaryMatcher(keys);
+    snapshot->storage_ = std::move(owned);
+    return snapshot;
+}
+
+std::optional<std::string_view> GlossarySnapshot::find(std::string_view key) const {
+    for (uint32_t index : matcher_.keysEndingAt(key)) {
+        const Term t = term(index);
+        if (t.key == key) {
+            return t.value;
+        }
+    }
+    return std::nullopt;
+}
+
+std::unordered_map<std::string, std::string> GlossarySnapshot::mappings() const {
+    std::unordered_map<std::string, std::string> result;
+    result.reserve(size());
+    for (size_t i = 0; i < size(); ++i) {
+        const Term t = term(i);
+        result.emplace(t.key, t.value);
+    }
+    return result;
+}
+
+void GlossarySnapshot::appendMatches(std::ostream& out, const std::string& text) const {
+    std::vector<bool> found(size(), false);
+    matcher_.scan(text, [&](size_t index, size_t begin, size_t end) {
+        if (index < found.size() && isWordBoundary(text, begin) && isWordBoundary(text, end)) {
+            found[index] = true;
+        }
+    });
+    for (size_t i = 0; i < found.size(); ++i) {
+        if (found[i]) {
+            const Term t = term(i);
+            out << ", \"" << t.key << "\":\"" << t.value << "\"";
+        }
+    }
+}
+
+GlossaryFileStamp GlossaryFileStamp::of(const std::string& path) {
+    std::error_code ec;
+    GlossaryFileStamp stamp;
+    stamp.size = std::filesystem::file_size(path, ec);
+    if (ec) {
+        return {};
+    }
+    stamp.mtime = std::filesystem::last_write_time(path, ec);
+    stamp.exists = !ec;
+    return stamp.exists ? stamp : GlossaryFileStamp{};
+}
+
+GlossarySet::GlossarySet(std::vector<std::string> files) : files_(std::move(files)) {
+    // Stamped before reading, so an edit made during the build is seen
+    // as a change by the next check
+    built_ = stamps();
+    current_.store(GlossarySnapshot::build(files_), std::memory_order_release);
+}
+
+std::vector<GlossaryFileStamp> GlossarySet::stamps() const {
+    std::vector<GlossaryFileStamp> result;
+    result.reserve(files_.size());
+    for (const auto& file : files_) {
+        result.push_back(GlossaryFileStamp::of(file));
+    }
+    return result;
+}
+
+bool GlossarySet::reloadIfChanged() {
+    auto now = stamps();
+    if (now == built_) {
+        pending_.clear();
+        return false;
+    }
+    if (now != pending_) {
+        pending_ = std::move(now);
+        return false;
+    }
+    current_.store(GlossarySnapshot::build(files_), std::memory_order_release);
+    built_ = std::move(now);
+    pending_.clear();
+    return true;
+}
+
+std::shared_ptr<GlossarySet> GlossaryCache::get(const std::vector<std::string>& files) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& set = sets_[files];
+    if (!set) {
+        set = std::make_shared<GlossarySet>(files);
+    }
+    return set;
+}
+
+size_t GlossaryCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sets_.size();
+}
+
+size_t GlossaryCache::reloadChanged() {
+    std::vector<std::shared_ptr<GlossarySet>> sets;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& [files, set] : sets_) {
+            sets.push_back(set);
+        }
+    }
+    size_t reloaded = 0;
+    for (const auto& set : sets) {
+        if (set->reloadIfChanged()) {
+            ++reloaded;
+            std::cout << "[" << getCurrentTime() << "] "
+                      << "Glossary.cpp reloadChanged Reloaded glossary (" << set->snapshot()->size() << " terms):";
+            for (const auto& file : set->files()) {
+                std::cout << " " << file;
+            }
+            std::cout << std::endl;
+        }
+    }
+    return reloaded;
+}
+
+GlossaryWatcher::GlossaryWatcher(GlossaryCache& cache, std::chrono::milliseconds interval)
+    : cache_(cache), interval_(interval), thread_([this] { run(); }) {}
+
+GlossaryWatcher::~GlossaryWatcher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    thread_.join();
+}
+
+void GlossaryWatcher::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!wake_.wait_for(lock, interval_, [this] { return stopping_; })) {
+        lock.unlock();
+        cache_.reloadChanged();
+        lock.lock();
+    }
+}
+
+} // namespace sdrtrunk
@@ -9,75 +9,370 @@
  * - Xing/VBRI/LAME headers with frame count
  * - Gapless playback metadata (encoder delay and padding)
  * - Corrupted or truncated files
+ *
+ * Durations come from the Xing/Info, LAME, VBRI or CBR frame headers of a
+ * memory-mapped file when possible; the full mpg123_scan() frame walk is
+ * only the fallback. Both the scan and the decoder borrow their handles
+ * from the thread-local pool in Mpg123Pool.cpp.
+ *
+ * It also decodes recordings to the 16 kHz mono float32 PCM that the
+ * local Whisper backend consumes, so audio is only decoded once. mpg123
+ * produces native-rate int16 and AudioConvert.cpp downmixes, converts and
+ * resamples it in one vectorized pass.
  */
 
 #include "../include/MP3Duration.h"
+#include "../include/AudioConvert.h"
+#include "../include/Mpg123Pool.h"
+#include "../include/RecordingFile.h"
 #include <mpg123.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
 
 namespace sdrtrunk {
 
-// RAII wrapper for mpg123 cleanup
-struct MPG123Deleter {
-    void operator()(mpg123_handle* mh) const {
-        if (mh) {
-            mpg123_close(mh);
-            mpg123_delete(mh);
+namespace {
+
+// MPEG audio frame header fields needed for duration arithmetic
+struct FrameHeader {
+    int versionRow = 0;       // 0 = MPEG-1, 1 = MPEG-2, 2 = MPEG-2.5
+    int layer = 0;            // 1, 2 or 3
+    int bitrateKbps = 0;
+    int sampleRate = 0;
+    bool mono = false;
+    size_t frameBytes = 0;
+    int samplesPerFrame = 0;
+};
+
+// [lsf][layer - 1][index]; index 0 (free format) and 15 are invalid
+constexpr int kBitrates[2][3][16] = {
+    {{0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448, 0},
+     {0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 0},
+     {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0}},
+    {{0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256, 0},
+     {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0},
+     {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0}},
+};
+
+constexpr int kSampleRates[3][3] = {
+    {44100, 48000, 32000},
+    {22050, 24000, 16000},
+    {11025, 12000, 8000},
+};
+
+std::optional<FrameHeader> parseFrameHeader(const unsigned char* p) {
+    if (p[0] != 0xFF || (p[1] & 0xE0) != 0xE0) {
+        return std::nullopt;
+    }
+    const int versionBits = (p[1] >> 3) & 0x3;
+    const int layerBits = (p[1] >> 1) & 0x3;
+    const int bitrateIndex = p[2] >> 4;
+    const int rateIndex = (p[2] >> 2) & 0x3;
+    if (versionBits == 1 || layerBits == 0 || bitrateIndex == 0 || bitrateIndex == 15 || rateIndex == 3) {
+        return std::nullopt;
+    }
+
+    FrameHeader h;
+    h.versionRow = versionBits == 3 ? 0 : (versionBits == 2 ? 1 : 2);
+    h.layer = 4 - layerBits;
+    const int lsf = h.versionRow == 0 ? 0 : 1;
+    h.bitrateKbps = kBitrates[lsf][h.layer - 1][bitrateIndex];
+    h.sampleRate = kSampleRates[h.versionRow][rateIndex];
+    h.mono = (p[3] >> 6) == 0x3;
+    const int padding = (p[2] >> 1) & 0x1;
+    const int bitrate = h.bitrateKbps * 1000;
+    int bytes = 0;
+    if (h.layer == 1) {
+        h.samplesPerFrame = 384;
+        bytes = (12 * bitrate / h.sampleRate + padding) * 4;
+    } else if (h.layer == 2) {
+        h.samplesPerFrame = 1152;
+        bytes = 144 * bitrate / h.sampleRate + padding;
+    } else {
+        h.samplesPerFrame = lsf ? 576 : 1152;
+        bytes = (lsf ? 72 : 144) * bitrate / h.sampleRate + padding;
+    }
+    h.frameBytes = static_cast<size_t>(bytes);
+    return h;
+}
+
+bool sameStream(const FrameHeader& a, const FrameHeader& b) {
+    return a.versionRow == b.versionRow && a.layer == b.layer && a.sampleRate == b.sampleRate;
+}
+
+// Average frame size in bytes, including the share of padded frames
+double averageFrameBytes(const FrameHeader& h) {
+    const double bytesPerSample = h.bitrateKbps * 1000.0 / 8.0 / h.sampleRate;
+    return bytesPerSample * h.samplesPerFrame;
+}
+
+uint32_t readBigEndian32(const unsigned char* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+// Bytes between a Layer III header and its Xing/Info tag
+size_t sideInfoBytes(const FrameHeader& h) {
+    if (h.versionRow == 0) {
+        return h.mono ? 17 : 32;
+    }
+    return h.mono ? 9 : 17;
+}
+
+// A frame at pos whose successor (if the file continues) is a frame of
+// the same stream; rules out 0xFFE sync patterns inside audio data
+std::optional<FrameHeader> confirmedFrameAt(std::span<const unsigned char> file, size_t pos, size_t end) {
+    if (pos + 4 > end) {
+        return std::nullopt;
+    }
+    auto h = parseFrameHeader(&file[pos]);
+    if (!h) {
+        return std::nullopt;
+    }
+    const size_t next = pos + h->frameBytes;
+    if (next + 4 > end) {
+        return h;
+    }
+    auto following = parseFrameHeader(&file[next]);
+    if (!following || !sameStream(*h, *following)) {
+        return std::nullopt;
+    }
+    return h;
+}
+
+// First confirmed frame at or after pos within a small search window
+std::optional<std::pair<size_t, FrameHeader>> findFrame(std::span<const unsigned char> file, size_t pos, size_t end) {
+    constexpr size_t kSearchWindow = 4096;
+    const size_t limit = std::min(end, pos + kSearchWindow);
+    for (; pos + 4 <= limit; ++pos) {
+        if (auto h = confirmedFrameAt(file, pos, end)) {
+            return std::make_pair(pos, *h);
         }
     }
-};
+    return std::nullopt;
+}
+
+Result<double> inconsistentHeader(const std::string& reason) {
+    return Err<double>(ErrorCode::InvalidFormat, reason);
+}
 
-// Initialize mpg123 library once
-class MPG123Initializer {
-public:
-    MPG123Initializer() {
-        if (mpg123_init() != MPG123_OK) {
-            initialized = false;
-        } else {
-            initialized = true;
+// Sample count from a Xing/VBRI frame count, checked against the audio size
+Result<double> durationFromFrameCount(const FrameHeader& first, uint64_t frames, uint64_t taggedBytes,
+                                      uint64_t audioBytes, uint64_t trimSamples) {
+    if (frames == 0) {
+        return inconsistentHeader("VBR header has no frame count");
+    }
+    if (taggedBytes > 0) {
+        const uint64_t diff = taggedBytes > audioBytes ? taggedBytes - audioBytes : audioBytes - taggedBytes;
+        if (static_cast<double>(diff) > 0.05 * static_cast<double>(audioBytes) + static_cast<double>(first.frameBytes)) {
+            return inconsistentHeader("VBR header byte count disagrees with file size");
         }
     }
+    const uint64_t samples = frames * static_cast<uint64_t>(first.samplesPerFrame);
+    if (trimSamples >= samples) {
+        return inconsistentHeader("LAME delay/padding exceed the stream length");
+    }
+    return static_cast<double>(samples - trimSamples) / first.sampleRate;
+}
 
-    ~MPG123Initializer() {
-        if (initialized) {
-            mpg123_exit();
+// [begin, end) of the audio frames, without ID3v2 and ID3v1 tags
+std::pair<size_t, size_t> audioRange(std::span<const unsigned char> file) {
+    size_t end = file.size();
+    if (end >= 128 && std::memcmp(&file[end - 128], "TAG", 3) == 0) {
+        end -= 128;  // ID3v1 trailer
+    }
+
+    // Skip an ID3v2 tag (syncsafe size, optional footer)
+    size_t pos = 0;
+    if (end >= 10 && std::memcmp(file.data(), "ID3", 3) == 0) {
+        const size_t tagSize = (static_cast<size_t>(file[6] & 0x7F) << 21) | (static_cast<size_t>(file[7] & 0x7F) << 14) |
+                               (static_cast<size_t>(file[8] & 0x7F) << 7) | static_cast<size_t>(file[9] & 0x7F);
+        pos = 10 + tagSize + ((file[5] & 0x10) ? 10 : 0);
+    }
+    return {pos, end};
+}
+
+} // namespace
+
+Result<double> parseMP3HeaderDuration(std::span<const unsigned char> file) {
+    auto [pos, end] = audioRange(file);
+
+    auto found = findFrame(file, pos, end);
+    if (!found) {
+        return inconsistentHeader("No MPEG audio frame found");
+    }
+    const size_t audioStart = found->first;
+    const FrameHeader first = found->second;
+    const uint64_t audioBytes = end - audioStart;
+    const unsigned char* frame = &file[audioStart];
+    const size_t frameAvail = std::min(first.frameBytes, end - audioStart);
+
+    // Xing (VBR) / Info (CBR) tag, optionally followed by a LAME tag
+    const size_t xing = 4 + sideInfoBytes(first);
+    if (first.layer == 3 && xing + 8 <= frameAvail &&
+        (std::memcmp(frame + xing, "Xing", 4) == 0 || std::memcmp(frame + xing, "Info", 4) == 0)) {
+        const uint32_t flags = readBigEndian32(frame + xing + 4);
+        size_t field = xing + 8;
+        uint64_t frames = 0;
+        uint64_t taggedBytes = 0;
+        if ((flags & 0x1) && field + 4 <= frameAvail) {
+            frames = readBigEndian32(frame + field);
+            field += 4;
+        }
+        if ((flags & 0x2) && field + 4 <= frameAvail) {
+            taggedBytes = readBigEndian32(frame + field);
+            field += 4;
         }
+        if (flags & 0x4) {
+            field += 100;  // seek TOC
+        }
+        if (flags & 0x8) {
+            field += 4;    // quality
+        }
+
+        // LAME extension: 12-bit encoder delay and padding at bytes 21-23
+        uint64_t trim = 0;
+        if (field + 24 <= frameAvail &&
+            (std::memcmp(frame + field, "LAME", 4) == 0 || std::memcmp(frame + field, "Lavc", 4) == 0 ||
+             std::memcmp(frame + field, "Lavf", 4) == 0)) {
+            const unsigned char* d = frame + field + 21;
+            const uint64_t delay = (static_cast<uint64_t>(d[0]) << 4) | (d[1] >> 4);
+            const uint64_t padding = (static_cast<uint64_t>(d[1] & 0x0F) << 8) | d[2];
+            trim = delay + padding;
+        }
+        return durationFromFrameCount(first, frames, taggedBytes, audioBytes, trim);
     }
 
-    bool isInitialized() const { return initialized; }
+    // Fraunhofer VBRI tag, always 32 bytes after the header
+    constexpr size_t vbri = 4 + 32;
+    if (vbri + 18 <= frameAvail && std::memcmp(frame + vbri, "VBRI", 4) == 0) {
+        const uint64_t taggedBytes = readBigEndian32(frame + vbri + 10);
+        const uint64_t frames = readBigEndian32(frame + vbri + 14);
+        return durationFromFrameCount(first, frames, taggedBytes, audioBytes, 0);
+    }
 
-private:
-    bool initialized;
-};
+    // No tag: constant bitrate is assumed only if the leading frames, and
+    // frames found near the middle and the end, all share one bitrate
+    constexpr int kLeadingFrames = 16;
+    size_t walk = audioStart;
+    for (int i = 0; i < kLeadingFrames && walk + 4 <= end; ++i) {
+        auto h = parseFrameHeader(&file[walk]);
+        if (!h || !sameStream(first, *h) || h->bitrateKbps != first.bitrateKbps) {
+            return inconsistentHeader("Variable bitrate stream without a Xing/VBRI header");
+        }
+        walk += h->frameBytes;
+    }
+    for (size_t probe : {audioStart + audioBytes / 2, end > 8 * first.frameBytes ? end - 8 * first.frameBytes : audioStart}) {
+        if (probe <= walk) {
+            continue;
+        }
+        auto h = findFrame(file, probe, end);
+        if (!h || !sameStream(first, h->second) || h->second.bitrateKbps != first.bitrateKbps) {
+            return inconsistentHeader("Variable bitrate stream without a Xing/VBRI header");
+        }
+    }
+
+    const double frames = std::round(static_cast<double>(audioBytes) / averageFrameBytes(first));
+    return frames * first.samplesPerFrame / first.sampleRate;
+}
 
 Result<double> getMP3Duration(const std::string& filepath) {
-    // Initialize mpg123 library (thread-safe singleton pattern)
-    static MPG123Initializer initializer;
-    if (!initializer.isInitialized()) {
-        return Err<double>(ErrorCode::SystemError, "Failed to initialize mpg123 library");
+    auto file = RecordingFile::open(filepath);
+    if (!file.has_value()) {
+        return std::unexpected(file.error());
     }
+    return getMP3Duration(file.value());
+}
 
-    // Create new mpg123 handle
-    int err = MPG123_OK;
-    std::unique_ptr<mpg123_handle, MPG123Deleter> mh(mpg123_new(nullptr, &err));
+Result<double> getMP3Duration(const RecordingFile& file) {
+    auto fast = parseMP3HeaderDuration(file.bytes());
+    if (fast.has_value() && fast.value() > 0.0 && fast.value() <= 86400.0) {
+        return fast;
+    }
+    return scanMP3Duration(file);
+}
 
-    if (!mh || err != MPG123_OK) {
-        return Err<double>(ErrorCode::SystemError,
-                          "Failed to create mpg123 handle: " + std::string(mpg123_plain_strerror(err)));
+Result<AudioMetadata> probeMP3Metadata(const RecordingFile& file) {
+    auto duration = getMP3Duration(file);
+    if (!duration.has_value()) {
+        return std::unexpected(duration.error());
     }
+    AudioMetadata metadata;
+    metadata.durationSeconds = duration.value();
 
-    // Enable gapless playback (uses LAME/Xing delay+padding when present)
-    mpg123_param(mh.get(), MPG123_ADD_FLAGS, MPG123_GAPLESS, 0.0);
+    const auto bytes = file.bytes();
+    const auto [pos, end] = audioRange(bytes);
+    if (auto found = findFrame(bytes, pos, end)) {
+        static constexpr const char* kVersions[] = {"MPEG-1", "MPEG-2", "MPEG-2.5"};
+        static constexpr const char* kLayers[] = {"Layer I", "Layer II", "Layer III"};
+        const FrameHeader& h = found->second;
+        metadata.sampleRate = h.sampleRate;
+        metadata.channels = h.mono ? 1 : 2;
+        metadata.bitrateKbps = h.bitrateKbps;
+        metadata.format = std::string(kVersions[h.versionRow]) + " " + kLayers[h.layer - 1];
+    }
+    return metadata;
+}
 
-    // Open the MP3 file
-    if (mpg123_open(mh.get(), filepath.c_str()) != MPG123_OK) {
-        return Err<double>(ErrorCode::FileNotFound,
-                          "Cannot open file: " + filepath + " - " + mpg123_strerror(mh.get()));
+std::vector<float> resamplePcm(std::span<const float> input, int inRate, int outRate) {
+    if (input.empty() || inRate <= 0 || outRate <= 0) {
+        return {};
+    }
+    if (inRate == outRate) {
+        return std::vector<float>(input.begin(), input.end());
     }
 
+    const double step = static_cast<double>(inRate) / outRate;
+    const size_t outCount = static_cast<size_t>(
+        std::floor(static_cast<double>(input.size() - 1) / step)) + 1;
+    std::vector<float> output(outCount);
+
+    for (size_t i = 0; i < outCount; ++i) {
+        const double pos = static_cast<double>(i) * step;
+        const size_t idx = static_cast<size_t>(pos);
+        const size_t next = std::min(idx + 1, input.size() - 1);
+        const float frac = static_cast<float>(pos - static_cast<double>(idx));
+        output[i] = input[idx] + (input[next] - input[idx]) * frac;
+    }
+    return output;
+}
+
+namespace {
+
+// Gapless playback uses LAME/Xing delay+padding when present
+constexpr long SCAN_FLAGS = MPG123_GAPLESS;
+// Gapless trimming; int16 output is negotiated per file and downmixed by
+// PolyphaseResampler
+constexpr long DECODE_FLAGS = MPG123_GAPLESS | MPG123_QUIET;
+
+// Open an already opened recording on a pooled handle
+Result<Mpg123Lease> openRecording(const RecordingFile& file, long flags) {
+#ifndef _WIN32
+    if (file.fd() >= 0) {
+        // The descriptor is shared by every stage reading the recording
+        if (::lseek(file.fd(), 0, SEEK_SET) != 0) {
+            return Err<Mpg123Lease>(ErrorCode::SystemError, "Cannot rewind " + file.path());
+        }
+        return openMpg123Fd(file.fd(), flags);
+    }
+#endif
+    return openMpg123File(file.path(), flags);
+}
+
+Result<double> scanStream(mpg123_handle* mh, const std::string& filepath) {
     // Scan all frames to build index for accurate duration
     // This is fast and doesn't decode to PCM
-    int scan_result = mpg123_scan(mh.get());
+    int scan_result = mpg123_scan(mh);
     if (scan_result != MPG123_OK && scan_result != MPG123_NEW_FORMAT) {
         // Some files might not scan perfectly but still have valid duration
         // Continue anyway unless it's a critical error
@@ -90,7 +385,7 @@ Result<double> getMP3Duration(const std::string& filepath) {
     long sample_rate = 0;
     int channels = 0;
     int encoding = 0;
-    if (mpg123_getformat(mh.get(), &sample_rate, &channels, &encoding) != MPG123_OK) {
+    if (mpg123_getformat(mh, &sample_rate, &channels, &encoding) != MPG123_OK) {
         return Err<double>(ErrorCode::InvalidFormat,
                           "Cannot determine MP3 format for: " + filepath);
     }
@@ -101,7 +396,7 @@ Result<double> getMP3Duration(const std::string& filepath) {
     }
 
     // Get total number of samples (gapless-aware when metadata present)
-    off_t total_samples = mpg123_length(mh.get());
+    off_t total_samples = mpg123_length(mh);
 
     if (total_samples <= 0) {
         // If length() fails, we could fall back to frame counting,
@@ -123,4 +418,96 @@ Result<double> getMP3Duration(const std::string& filepath) {
     return Ok(duration_seconds);
 }
 
-} // namespace sdrtrunk
\ No newline at end of file
+Result<PcmBuffer> decodeStream(mpg123_handle* mh, const std::string& filepath) {
+    long sample_rate = 0;
+    int channels = 0;
+    int encoding = 0;
+    if (mpg123_getformat(mh, &sample_rate, &channels, &encoding) != MPG123_OK || sample_rate <= 0) {
+        return Err<PcmBuffer>(ErrorCode::InvalidFormat,
+                              "Cannot determine MP3 format for: " + filepath);
+    }
+
+    // Ask mpg123 for int16 at the native rate and channel count; downmix,
+    // float conversion and resampling happen in one pass per chunk
+    mpg123_format_none(mh);
+    if (mpg123_format(mh, sample_rate, channels, MPG123_ENC_SIGNED_16) != MPG123_OK) {
+        return Err<PcmBuffer>(ErrorCode::InvalidFormat,
+                              "mpg123 cannot produce int16 output for: " + filepath);
+    }
+    const long native_rate = sample_rate;
+    PolyphaseResampler resampler(static_cast<int>(native_rate), WHISPER_SAMPLE_RATE);
+
+    PcmBuffer pcm;
+    pcm.sampleRate = WHISPER_SAMPLE_RATE;
+    off_t estimated = mpg123_length(mh);
+    if (estimated > 0) {
+        pcm.samples.reserve(static_cast<size_t>(estimated) * WHISPER_SAMPLE_RATE / static_cast<size_t>(native_rate) + 1);
+    }
+
+    constexpr size_t CHUNK_FRAMES = 4096;
+    std::vector<int16_t> chunk(CHUNK_FRAMES * 2);
+    for (;;) {
+        size_t done = 0;
+        int rc = mpg123_read(mh, reinterpret_cast<unsigned char*>(chunk.data()),
+                             chunk.size() * sizeof(int16_t), &done);
+        resampler.push(std::span<const int16_t>(chunk.data(), done / sizeof(int16_t)), channels, pcm.samples);
+
+        if (rc == MPG123_DONE) {
+            break;
+        }
+        if (rc == MPG123_NEW_FORMAT) {
+            mpg123_getformat(mh, &sample_rate, &channels, &encoding);
+            if (sample_rate != native_rate || encoding != MPG123_ENC_SIGNED_16 || channels <= 0) {
+                return Err<PcmBuffer>(ErrorCode::InvalidFormat,
+                                      "Unexpected output format change in: " + filepath);
+            }
+            continue;
+        }
+        if (rc != MPG123_OK) {
+            return Err<PcmBuffer>(ErrorCode::InvalidFormat,
+                                  "Decode error in: " + filepath + " - " + mpg123_strerror(mh));
+        }
+    }
+    resampler.finish(pcm.samples);
+
+    if (pcm.samples.empty()) {
+        return Err<PcmBuffer>(ErrorCode::InvalidFormat, "No audio decoded from: " + filepath);
+    }
+    return Ok(std::move(pcm));
+}
+
+} // namespace
+
+Result<double> scanMP3Duration(const std::string& filepath) {
+    auto lease = openMpg123File(filepath, SCAN_FLAGS);
+    if (!lease.has_value()) {
+        return std::unexpected(lease.error());
+    }
+    return scanStream(lease->get(), filepath);
+}
+
+Result<double> scanMP3Duration(const RecordingFile& file) {
+    auto lease = openRecording(file, SCAN_FLAGS);
+    if (!lease.has_value()) {
+        return std::unexpected(lease.error());
+    }
+    return scanStream(lease->get(), file.path());
+}
+
+Result<PcmBuffer> decodeMP3ToPcm(const std::string& filepath) {
+    auto lease = openMpg123File(filepath, DECODE_FLAGS);
+    if (!lease.has_value()) {
+        return std::unexpected(lease.error());
+    }
+    return decodeStream(lease->get(), filepath);
+}
+
+Result<PcmBuffer> decodeMP3ToPcm(const RecordingFile& file) {
+    auto lease = openRecording(file, DECODE_FLAGS);
+    if (!lease.has_value()) {
+        return std::unexpected(lease.error());
+    }
+    return decodeStream(lease->get(), file.path());
+}
+
+} // namespace sdrtrunk
@@ -0,0 +1,211 @@
+/**
+ * @file Mpg123Pool.cpp
+ * @brief Thread-local pool of configured libmpg123 handles
+ *
+ * Every duration scan and PCM decode used to call mpg123_new() and
+ * mpg123_delete(), which allocates the decoder tables and buffers each
+ * time. Handles are instead kept per worker thread, grouped by their
+ * flags, and only reopened for the next file.
+ */
+
+#include "../include/Mpg123Pool.h"
+#include <mpg123.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace sdrtrunk {
+
+namespace {
+
+// Idle handles kept per thread; workers rarely hold more than two at once
+constexpr size_t MAX_IDLE_HANDLES = 4;
+
+// Initialize mpg123 library once
+class MPG123Initializer {
+public:
+    MPG123Initializer() : initialized(mpg123_init() == MPG123_OK) {}
+
+    ~MPG123Initializer() {
+        if (initialized) {
+            mpg123_exit();
+        }
+    }
+
+    bool isInitialized() const { return initialized; }
+
+private:
+    bool initialized;
+};
+
+struct IdleHandle {
+    long flags;
+    mpg123_handle* handle;
+};
+
+// Handles are not tied to a thread; the pool is thread-local only so that
+// taking and returning one needs no locking
+struct ThreadPool {
+    std::vector<IdleHandle> idle;
+    size_t created = 0;
+    size_t reused = 0;
+
+    ~ThreadPool() {
+        for (const auto& entry : idle) {
+            mpg123_delete(entry.handle);
+        }
+    }
+};
+
+ThreadPool& threadPool() {
+    thread_local ThreadPool pool;
+    return pool;
+}
+
+Result<mpg123_handle*> acquireHandle(long flags) {
+    static MPG123Initializer initializer;
+    if (!initializer.isInitialized()) {
+        return Err<mpg123_handle*>(ErrorCode::SystemError, "Failed to initialize mpg123 library");
+    }
+
+    ThreadPool& pool = threadPool();
+    auto it = std::find_if(pool.idle.rbegin(), pool.idle.rend(),
+                           [flags](const IdleHandle& entry) { return entry.flags == flags; });
+    if (it != pool.idle.rend()) {
+        mpg123_handle* handle = it->handle;
+        pool.idle.erase(std::next(it).base());
+        ++pool.reused;
+        return Ok(handle);
+    }
+
+    int err = MPG123_OK;
+    mpg123_handle* handle = mpg123_new(nullptr, &err);
+    if (!handle || err != MPG123_OK) {
+        if (handle) {
+            mpg123_delete(handle);
+        }
+        return Err<mpg123_handle*>(ErrorCode::SystemError,
+                                   "Failed to create mpg123 handle: " + std::string(mpg123_plain_strerror(err)));
+    }
+    if (flags != 0 && mpg123_param(handle, MPG123_ADD_FLAGS, flags, 0.0) != MPG123_OK) {
+        std::string message = "Failed to configure mpg123 handle: " + std::string(mpg123_strerror(handle));
+        mpg123_delete(handle);
+        return Err<mpg123_handle*>(ErrorCode::SystemError, message);
+    }
+    ++pool.created;
+    return Ok(handle);
+}
+
+} // namespace
+
+Mpg123Lease::Mpg123Lease(Mpg123Lease&& other) noexcept
+    : handle_(std::exchange(other.handle_, nullptr)),
+      flags_(other.flags_),
+      ownedFd_(std::exchange(other.ownedFd_, -1)) {}
+
+Mpg123Lease& Mpg123Lease::operator=(Mpg123Lease&& other) noexcept {
+    if (this != &other) {
+        release();
+        handle_ = std::exchange(other.handle_, nullptr);
+        flags_ = other.flags_;
+        ownedFd_ = std::exchange(other.ownedFd_, -1);
+    }
+    return *this;
+}
+
+Mpg123Lease::~Mpg123Lease() {
+    release();
+}
+
+void Mpg123Lease::release() {
+    if (!handle_) {
+        return;
+    }
+    mpg123_close(handle_);
+#ifndef _WIN32
+    if (ownedFd_ >= 0) {
+        ::close(ownedFd_);
+    }
+#endif
+    ownedFd_ = -1;
+
+    // Output formats persist across opens; decodeMP3ToPcm narrows them
+    mpg123_format_all(handle_);
+
+    ThreadPool& pool = threadPool();
+    if (pool.idle.size() < MAX_IDLE_HANDLES) {
+        pool.idle.push_back({flags_, handle_});
+    } else {
+        mpg123_delete(handle_);
+    }
+    handle_ = nullptr;
+}
+
+Result<Mpg123Lease> openMpg123File(const std::string& filepath, long flags) {
+    auto handle = acquireHandle(flags);
+    if (!handle.has_value()) {
+        return std::unexpected(handle.error());
+    }
+    Mpg123Lease lease(handle.value(), flags);
+
+#ifdef _WIN32
+    if (mpg123_open(lease.get(), filepath.c_str()) != MPG123_OK) {
+        return Err<Mpg123Lease>(ErrorCode::FileNotFound,
+                                "Cannot open file: " + filepath + " - " + mpg123_strerror(lease.get()));
+    }
+#else
+    int fd = ::open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return Err<Mpg123Lease>(ErrorCode::FileNotFound, "Cannot open file: " + filepath);
+    }
+    lease.ownedFd_ = fd;
+    if (mpg123_open_fd(lease.get(), fd) != MPG123_OK) {
+        return Err<Mpg123Lease>(ErrorCode::FileNotFound,
+                                "Cannot open file: " + filepath + " - " + mpg123_strerror(lease.get()));
+    }
+#endif
+    return lease;
+}
+
+Result<Mpg123Lease> openMpg123Fd(int fd, long flags) {
+    auto handle = acquireHandle(flags);
+    if (!handle.has_value()) {
+        return std::unexpected(handle.error());
+    }
+    Mpg123Lease lease(handle.value(), flags);
+    if (mpg123_open_fd(lease.get(), fd) != MPG123_OK) {
+        return Err<Mpg123Lease>(ErrorCode::FileNotFound,
+                                "Cannot open file descriptor " + std::to_string(fd) + " - " +
+                                    mpg123_strerror(lease.get()));
+    }
+    return lease;
+}
+
+Result<Mpg123Lease> openMpg123Feed(long flags) {
+    auto handle = acquireHandle(flags);
+    if (!handle.has_value()) {
+        return std::unexpected(handle.error());
+    }
+    Mpg123Lease lease(handle.value(), flags);
+    if (mpg123_open_feed(lease.get()) != MPG123_OK) {
+        return Err<Mpg123Lease>(ErrorCode::SystemError,
+                                "Cannot open mpg123 feed - " + std::string(mpg123_strerror(lease.get())));
+    }
+    return lease;
+}
+
+Mpg123PoolStats mpg123ThreadPoolStats() {
+    const ThreadPool& pool = threadPool();
+    Mpg123PoolStats stats;
+    stats.created = pool.created;
+    stats.reused = pool.reused;
+    stats.idle = pool.idle.size();
+    return stats;
+}
+
+} // namespace sdrtrunk
@@ -0,0 +1,297 @@
+/**
+ * @file PcmStream.cpp
+ * @brief Bounded-memory streaming decode and the process-wide decode budget
+ *
+ * decodeMP3ToPcm() holds a whole recording as float PCM, 64 KB per second
+ * of audio. Long conventional-channel recordings and many concurrent
+ * workers make that unbounded, so long recordings are instead decoded a
+ * block at a time through mpg123's feed API, and every decode reserves
+ * its working set against DecodeMemoryBudget first.
+ */
+
+#include "../include/PcmStream.h"
+#include "../include/MP3Duration.h"
+#include "../include/RecordingFile.h"
+
+#include <mpg123.h>
+#include <algorithm>
+#include <utility>
+
+namespace sdrtrunk {
+
+namespace {
+
+// Same gapless trimming as decodeMP3ToPcm
+constexpr long STREAM_FLAGS = MPG123_GAPLESS | MPG123_QUIET;
+
+constexpr size_t FEED_BYTES = 16 * 1024;
+constexpr size_t READ_FRAMES = 4096;
+// One read at 8 kHz doubles to 16 kHz; the rest covers the filter flush
+constexpr size_t BLOCK_SLACK = READ_FRAMES * 2 + 2 * PolyphaseResampler::TAPS_PER_PHASE;
+constexpr size_t MAX_IDLE_BLOCKS = 8;
+
+} // namespace
+
+DecodeMemoryBudget::Reservation::Reservation(Reservation&& other) noexcept
+    : budget_(std::exchange(other.budget_, nullptr)), bytes_(std::exchange(other.bytes_, 0)) {}
+
+DecodeMemoryBudget::Reservation& DecodeMemoryBudget::Reservation::operator=(Reservation&& other) noexcept {
+    if (this != &other) {
+        release();
+        budget_ = std::exchange(other.budget_, nullptr);
+        bytes_ = std::exchange(other.bytes_, 0);
+    }
+    return *this;
+}
+
+DecodeMemoryBudget::Reservation::~Reservation() {
+    release();
+}
+
+void DecodeMemoryBudget::Reservation::release() {
+    if (budget_) {
+        budget_->release(bytes_);
+    }
+    budget_ = nullptr;
+    bytes_ = 0;
+}
+
+DecodeMemoryBudget& DecodeMemoryBudget::instance() {
+    static DecodeMemoryBudget budget;
+    return budget;
+}
+
+void DecodeMemoryBudget::setCapBytes(size_t capBytes) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cap_ = capBytes;
+    }
+    released_.notify_all();
+}
+
+size_t DecodeMemoryBudget::capBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cap_;
+}
+
+bool DecodeMemoryBudget::fits(size_t bytes) const {
+    return cap_ == 0 || reserved_ == 0 || reserved_ + bytes <= cap_;
+}
+
+DecodeMemoryBudget::Reservation DecodeMemoryBudget::grant(size_t bytes) {
+    reserved_ += bytes;
+    peak_ = std::max(peak_, reserved_);
+    return Reservation(this, bytes);
+}
+
+DecodeMemoryBudget::Reservation DecodeMemoryBudget::reserve(size_t bytes) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    released_.wait(lock, [this, bytes] { return fits(bytes); });
+    return grant(bytes);
+}
+
+std::optional<DecodeMemoryBudget::Reservation> DecodeMemoryBudget::tryReserve(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!fits(bytes)) {
+        return std::nullopt;
+    }
+    return grant(bytes);
+}
+
+void DecodeMemoryBudget::release(size_t bytes) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        reserved_ -= bytes;
+    }
+    released_.notify_all();
+}
+
+size_t DecodeMemoryBudget::reservedBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return reserved_;
+}
+
+size_t DecodeMemoryBudget::peakBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return peak_;
+}
+
+size_t wholeDecodeBytes(double seconds) {
+    return seconds > 0.0 ? static_cast<size_t>(seconds * WHISPER_SAMPLE_RATE) * sizeof(float) : 0;
+}
+
+bool exceedsDecodeBudget(double seconds) {
+    const size_t cap = DecodeMemoryBudget::instance().capBytes();
+    return cap > 0 && wholeDecodeBytes(seconds) > cap;
+}
+
+Result<BudgetedPcm> decodeWithinBudget(const RecordingFile& file, double durationSeconds) {
+    if (durationSeconds <= 0.0) {
+        durationSeconds = getMP3Duration(file).value_or(0.0);
+    }
+    BudgetedPcm budgeted;
+    if (durationSeconds > 0.0) {
+        budgeted.reservation = DecodeMemoryBudget::instance().reserve(wholeDecodeBytes(durationSeconds));
+    }
+    auto decoded = decodeMP3ToPcm(file);
+    if (!decoded.has_value()) {
+        return std::unexpected(decoded.error());
+    }
+    budgeted.pcm = std::move(decoded.value());
+    if (durationSeconds <= 0.0) {
+        budgeted.reservation = DecodeMemoryBudget::instance().reserve(budgeted.pcm.samples.size() * sizeof(float));
+    }
+    return budgeted;
+}
+
+Result<BudgetedPcm> decodeWithinBudget(const std::string& path, double durationSeconds) {
+    auto file = RecordingFile::open(path);
+    if (!file.has_value()) {
+        return std::unexpected(file.error());
+    }
+    return decodeWithinBudget(file.value(), durationSeconds);
+}
+
+PcmBlockPool& PcmBlockPool::instance() {
+    static PcmBlockPool pool;
+    return pool;
+}
+
+std::vector<float> PcmBlockPool::acquire() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!idle_.empty()) {
+            std::vector<float> block = std::move(idle_.back());
+            idle_.pop_back();
+            return block;
+        }
+        ++created_;
+    }
+    std::vector<float> block;
+    block.reserve(PCM_BLOCK_SAMPLES + BLOCK_SLACK);
+    return block;
+}
+
+void PcmBlockPool::release(std::vector<float>&& block) {
+    if (block.capacity() < PCM_BLOCK_SAMPLES + BLOCK_SLACK) {
+        return;
+    }
+    block.clear();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (idle_.size() < MAX_IDLE_BLOCKS) {
+        idle_.push_back(std::move(block));
+    }
+}
+
+size_t PcmBlockPool::idle() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return idle_.size();
+}
+
+size_t PcmBlockPool::created() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return created_;
+}
+
+PcmStream::PcmStream(Mpg123Lease lease, std::span<const unsigned char> input, std::string path)
+    : lease_(std::move(lease)), input_(input), path_(std::move(path)),
+      scratch_(READ_FRAMES * 2), buffer_(PcmBlockPool::instance().acquire()) {}
+
+PcmStream::~PcmStream() {
+    PcmBlockPool::instance().release(std::move(buffer_));
+}
+
+size_t PcmStream::workingSetBytes() {
+    return (PCM_BLOCK_SAMPLES + BLOCK_SLACK) * sizeof(float) + READ_FRAMES * 2 * sizeof(int16_t);
+}
+
+Result<PcmStream> PcmStream::open(const RecordingFile& file) {
+    auto lease = openMpg123Feed(STREAM_FLAGS);
+    if (!lease.has_value()) {
+        return std::unexpected(lease.error());
+    }
+    mpg123_handle* mh = lease->get();
+
+    // The format is only known once the first frame has been fed, so
+    // int16 is allowed at every rate up front
+    mpg123_format_none(mh);
+    const long* rates = nullptr;
+    size_t rateCount = 0;
+    mpg123_rates(&rates, &rateCount);
+    for (size_t i = 0; i < rateCount; ++i) {
+        mpg123_format(mh, rates[i], MPG123_MONO | MPG123_STEREO, MPG123_ENC_SIGNED_16);
+    }
+    // Lets gapless trimming find the end of the stream
+    mpg123_set_filesize(mh, static_cast<off_t>(file.size()));
+
+    return PcmStream(std::move(lease.value()), file.bytes(), file.path());
+}
+
+Result<std::span<const float>> PcmStream::next() {
+    if (emitted_ > 0) {
+        buffer_.erase(buffer_.begin(), buffer_.begin() + static_cast<std::ptrdiff_t>(emitted_));
+        emitted_ = 0;
+    }
+    while (buffer_.size() < PCM_BLOCK_SAMPLES && !finished_) {
+        auto more = decodeMore();
+        if (!more.has_value()) {
+            return std::unexpected(more.error());
+        }
+    }
+    emitted_ = std::min(buffer_.size(), PCM_BLOCK_SAMPLES);
+    decoded_ += emitted_;
+    return std::span<const float>(buffer_.data(), emitted_);
+}
+
+Result<bool> PcmStream::decodeMore() {
+    mpg123_handle* mh = lease_.get();
+    size_t done = 0;
+    int rc = mpg123_read(mh, reinterpret_cast<unsigned char*>(scratch_.data()),
+                         scratch_.size() * sizeof(int16_t), &done);
+    if (done > 0 && resampler_) {
+        resampler_->push(std::span<const int16_t>(scratch_.data(), done / sizeof(int16_t)), channels_, buffer_);
+    }
+
+    switch (rc) {
+    case MPG123_OK:
+        return Ok(true);
+    case MPG123_NEW_FORMAT: {
+        long rate = 0;
+        int channels = 0;
+        int encoding = 0;
+        mpg123_getformat(mh, &rate, &channels, &encoding);
+        if (rate <= 0 || channels <= 0 || encoding != MPG123_ENC_SIGNED_16 ||
+            (resampler_ && rate != nativeRate_)) {
+            return Err<bool>(ErrorCode::InvalidFormat, "Unexpected output format change in: " + path_);
+        }
+        if (!resampler_) {
+            resampler_.emplace(static_cast<int>(rate), WHISPER_SAMPLE_RATE);
+            nativeRate_ = rate;
+        }
+        channels_ = channels;
+        return Ok(true);
+    }
+    case MPG123_NEED_MORE:
+        if (fed_ < input_.size()) {
+            const size_t slice = std::min(FEED_BYTES, input_.size() - fed_);
+            if (mpg123_feed(mh, input_.data() + fed_, slice) != MPG123_OK) {
+                return Err<bool>(ErrorCode::InvalidFormat,
+                                 "Decode error in: " + path_ + " - " + mpg123_strerror(mh));
+            }
+            fed_ += slice;
+            return Ok(true);
+        }
+        [[fallthrough]];
+    case MPG123_DONE:
+        if (!resampler_) {
+            return Err<bool>(ErrorCode::InvalidFormat, "No audio decoded from: " + path_);
+        }
+        resampler_->finish(buffer_);
+        finished_ = true;
+        return Ok(false);
+    default:
+        return Err<bool>(ErrorCode::InvalidFormat, "Decode error in: " + path_ + " - " + mpg123_strerror(mh));
+    }
+}
+
+} // namespace sdrtrunk
@@ -0,0 +1,141 @@
+/**
+ * @file RecordingFile.cpp
+ * @brief One open, one fstat and one mapping per recording
+ */
+
+#include "../include/RecordingFile.h"
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#ifdef _WIN32
+#include <filesystem>
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace sdrtrunk {
+
+Result<RecordingFile> RecordingFile::open(const std::string& filepath) {
+    RecordingFile file;
+    file.path_ = filepath;
+
+#ifdef _WIN32
+    std::error_code ec;
+    auto size = std::filesystem::file_size(filepath, ec);
+    std::ifstream in(filepath, std::ios::binary);
+    if (ec || !in) {
+        return Err<RecordingFile>(ErrorCode::FileNotFound, "Cannot open file: " + filepath);
+    }
+    file.buffer_.resize(static_cast<size_t>(size));
+    in.read(reinterpret_cast<char*>(file.buffer_.data()), static_cast<std::streamsize>(size));
+    file.buffer_.resize(static_cast<size_t>(in.gcount()));
+    file.data_ = file.buffer_.data();
+    file.size_ = file.buffer_.size();
+    file.identity_.size = file.size_;
+#else
+    file.fd_ = ::open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file.fd_ < 0) {
+        return Err<RecordingFile>(errno == EACCES ? ErrorCode::PermissionDenied : ErrorCode::FileNotFound,
+                                  "Cannot open file: " + filepath + " - " + std::strerror(errno));
+    }
+    struct stat st {};
+    if (::fstat(file.fd_, &st) != 0 || !S_ISREG(st.st_mode)) {
+        return Err<RecordingFile>(ErrorCode::InvalidPath, "Not a regular file: " + filepath);
+    }
+    file.size_ = static_cast<size_t>(st.st_size);
+    file.identity_.device = static_cast<uint64_t>(st.st_dev);
+    file.identity_.inode = static_cast<uint64_t>(st.st_ino);
+    file.identity_.size = static_cast<uint64_t>(st.st_size);
+    file.identity_.mtimeNs = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+    if (file.size_ == 0) {
+        return file;
+    }
+
+    void* addr = ::mmap(nullptr, file.size_, PROT_READ, MAP_PRIVATE, file.fd_, 0);
+    if (addr != MAP_FAILED) {
+        file.data_ = static_cast<const unsigned char*>(addr);
+        file.mapped_ = true;
+        return file;
+    }
+
+    // Filesystems without mmap support get one pread() of the whole file
+    file.buffer_.resize(file.size_);
+    size_t done = 0;
+    while (done < file.size_) {
+        ssize_t n = ::pread(file.fd_, file.buffer_.data() + done, file.size_ - done, static_cast<off_t>(done));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        done += static_cast<size_t>(n);
+    }
+    file.buffer_.resize(done);
+    file.data_ = file.buffer_.data();
+    file.size_ = done;
+#endif
+    return file;
+}
+
+RecordingFile::RecordingFile(RecordingFile&& other) noexcept
+    : path_(std::move(other.path_)),
+      fd_(std::exchange(other.fd_, -1)),
+      data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      mapped_(std::exchange(other.mapped_, false)),
+      buffer_(std::move(other.buffer_)),
+      identity_(std::exchange(other.identity_, {})) {}
+
+RecordingFile& RecordingFile::operator=(RecordingFile&& other) noexcept {
+    if (this != &other) {
+        reset();
+        path_ = std::move(other.path_);
+        fd_ = std::exchange(other.fd_, -1);
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        mapped_ = std::exchange(other.mapped_, false);
+        buffer_ = std::move(other.buffer_);
+        identity_ = std::exchange(other.identity_, {});
+    }
+    return *this;
+}
+
+RecordingFile::~RecordingFile() {
+    reset();
+}
+
+void RecordingFile::reset() {
+#ifndef _WIN32
+    if (mapped_) {
+        ::munmap(const_cast<unsigned char*>(data_), size_);
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+#endif
+    fd_ = -1;
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+    buffer_.clear();
+    identity_ = {};
+}
+
+bool RecordingFile::hasGrown() const {
+#ifdef _WIN32
+    std::error_code ec;
+    auto size = std::filesystem::file_size(path_, ec);
+    return !ec && size != size_;
+#else
+    struct stat st {};
+    return ::fstat(fd_, &st) == 0 && static_cast<size_t>(st.st_size) != size_;
+#endif
+}
+
+} // namespace sdrtrunk
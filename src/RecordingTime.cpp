@@ -0,0 +1,183 @@
+/**
+ * @file RecordingTime.cpp
+ * @brief Local wall-clock to unix time without mktime()
+ *
+ * SDRTrunk names recordings by local wall-clock time. The date
+ * arithmetic is constexpr (RecordingTime.h); only the zone's standard UTC
+ * offset depends on the time zone, and it is constant for at least a
+ * whole DST period. Each thread keeps the period it last resolved, so the
+ * zone database (or localtime_r() where the standard library has no
+ * tzdb) is consulted about twice a year per worker.
+ */
+
+#include "../include/RecordingTime.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <ctime>
+#include <version>
+
+namespace sdrtrunk {
+
+namespace {
+
+#if defined(__cpp_lib_chrono) && __cpp_lib_chrono >= 201907L
+#define SDRTRUNK_HAVE_TZDB 1
+#endif
+
+constexpr int64_t DAY_SECONDS = 86400;
+
+// Bumped by reloadLocalTimeZone(); a cached period from an older
+// generation is ignored
+std::atomic<uint64_t> zoneGeneration{1};
+
+// A span of unix time with one standard UTC offset
+struct OffsetPeriod {
+    int64_t begin;  // first second
+    int64_t end;    // first second after
+    int64_t offset; // local standard time minus UTC
+};
+
+// Wall-clock seconds a period converts unambiguously: those that are
+// neither repeated nor skipped at either of its ends
+struct WallClockPeriod {
+    uint64_t generation = 0;
+    int64_t wallBegin = 0;
+    int64_t wallEnd = 0;
+    int64_t offset = 0;
+};
+
+thread_local WallClockPeriod cachedPeriod;
+
+#ifdef SDRTRUNK_HAVE_TZDB
+
+OffsetPeriod periodAt(int64_t unixSeconds) {
+    const auto info = std::chrono::current_zone()->get_info(std::chrono::sys_seconds(std::chrono::seconds(unixSeconds)));
+    // Zones without DST have one period spanning all time; a year either
+    // side keeps the arithmetic on its ends in range
+    constexpr int64_t YEAR = 366 * DAY_SECONDS;
+    return {std::max<int64_t>(info.begin.time_since_epoch().count(), unixSeconds - YEAR),
+            std::min<int64_t>(info.end.time_since_epoch().count(), unixSeconds + YEAR),
+            info.offset.count() - std::chrono::duration_cast<std::chrono::seconds>(info.save).count()};
+}
+
+int64_t offsetAt(int64_t unixSeconds) {
+    return periodAt(unixSeconds).offset;
+}
+
+#else
+
+int64_t offsetAt(int64_t unixSeconds) {
+    const auto t = static_cast<std::time_t>(unixSeconds);
+    std::tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &t);
+#else
+    localtime_r(&t, &local);
+#endif
+    const int64_t wallClock = daysFromCivil(local.tm_year + 1900, static_cast<unsigned>(local.tm_mon + 1),
+                                            static_cast<unsigned>(local.tm_mday)) * DAY_SECONDS +
+                              local.tm_hour * 3600 + local.tm_min * 60 + local.tm_sec;
+    if (local.tm_isdst <= 0) {
+        return wallClock - unixSeconds;
+    }
+    // mktime() reads a tm_isdst = 0 time with the offset the zone uses
+    // outside DST; only DST-period cache misses get here
+    local.tm_isdst = 0;
+    return wallClock - static_cast<int64_t>(std::mktime(&local));
+}
+
+// First second from `from` in direction `step` whose offset differs from
+// `offset`, searching up to a year; zones change standard offset rarely
+// and never within a week of the last change
+int64_t findTransition(int64_t from, int64_t offset, int64_t step) {
+    constexpr int64_t WEEK = 7 * DAY_SECONDS;
+    int64_t same = from;
+    for (int64_t probe = from + step * WEEK; std::abs(probe - from) <= 53 * WEEK; probe += step * WEEK) {
+        if (offsetAt(probe) != offset) {
+            // Bisect between the last matching second and this one
+            int64_t differs = probe;
+            while (std::abs(differs - same) > 1) {
+                const int64_t mid = same + (differs - same) / 2;
+                (offsetAt(mid) == offset ? same : differs) = mid;
+            }
+            return step > 0 ? differs : same;
+        }
+        same = probe;
+    }
+    return from + step * 53 * WEEK;
+}
+
+OffsetPeriod periodAt(int64_t unixSeconds) {
+    const int64_t offset = offsetAt(unixSeconds);
+    return {findTransition(unixSeconds, offset, -1), findTransition(unixSeconds, offset, 1), offset};
+}
+
+#endif
+
+// The unix time of a wall-clock second, by the rules documented on
+// localWallClockToUnix(); assumes no two offset changes within a day
+int64_t resolveWallClock(int64_t wallClock) {
+    const int64_t before = offsetAt(wallClock - DAY_SECONDS);
+    const int64_t after = offsetAt(wallClock + DAY_SECONDS);
+    const int64_t early = wallClock - before;
+    const int64_t late = wallClock - after;
+    const bool earlyValid = offsetAt(early) == before;
+    const bool lateValid = offsetAt(late) == after;
+    if (earlyValid && lateValid) {
+        return std::min(early, late);
+    }
+    if (lateValid) {
+        return late;
+    }
+    return early;
+}
+
+WallClockPeriod wallClockPeriodAt(int64_t unixSeconds, uint64_t generation) {
+    const OffsetPeriod period = periodAt(unixSeconds);
+    const int64_t previous = offsetAt(period.begin - 1);
+    const int64_t next = offsetAt(period.end);
+    return {generation, period.begin + std::max(period.offset, previous), period.end + std::min(period.offset, next),
+            period.offset};
+}
+
+} // namespace
+
+int64_t localWallClockToUnix(int64_t wallClockSeconds) {
+    const uint64_t generation = zoneGeneration.load(std::memory_order_relaxed);
+    const WallClockPeriod& cached = cachedPeriod;
+    if (cached.generation == generation && wallClockSeconds >= cached.wallBegin && wallClockSeconds < cached.wallEnd) {
+        return wallClockSeconds - cached.offset;
+    }
+
+    const int64_t unixSeconds = resolveWallClock(wallClockSeconds);
+    WallClockPeriod period = wallClockPeriodAt(unixSeconds, generation);
+    // Repeated and skipped hours sit outside every period's range, so they
+    // are resolved each time rather than replacing the cache
+    if (wallClockSeconds >= period.wallBegin && wallClockSeconds < period.wallEnd) {
+        cachedPeriod = period;
+    }
+    return unixSeconds;
+}
+
+std::optional<int64_t> recordingUnixTime(std::string_view date, std::string_view time) {
+    const auto wallClock = parseRecordingWallClock(date, time);
+    if (!wallClock) {
+        return std::nullopt;
+    }
+    return localWallClockToUnix(*wallClock);
+}
+
+void reloadLocalTimeZone() {
+#ifdef SDRTRUNK_HAVE_TZDB
+    std::chrono::reload_tzdb();
+#elif defined(_WIN32)
+    _tzset();
+#else
+    tzset();
+#endif
+    zoneGeneration.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace sdrtrunk
@@ -0,0 +1,125 @@
+/**
+ * @file Reenrich.cpp
+ * @brief Bulk re-enrichment of stored transcriptions (--reenrich)
+ *
+ * A glossary edit only affects the v2transcription column, which is the
+ * stored transcription run through generateV2Transcription(). Redoing it
+ * is pure CPU work per row, so batches are split across a thread pool,
+ * and the database only sees one keyset-paged read and one transaction
+ * of changed rows per batch. A batch's write overlaps the next batch's
+ * enrichment.
+ */
+
+#include "../include/Reenrich.h"
+#include "../include/RecordingTime.h"
+#include "../include/ThreadPool.h"
+
+#include <algorithm>
+#include <future>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace sdrtrunk {
+
+namespace {
+
+constexpr int64_t DAY_SECONDS = 86400;
+
+using Updates = std::vector<std::pair<sqlite3_int64, std::string>>;
+
+// The v2transcription of each row; empty where there was no text to enrich
+std::vector<std::string> enrichBatch(const std::vector<StoredTranscription>& batch,
+                                     const TalkgroupProfiles& talkgroupFiles, ThreadPool* pool,
+                                     size_t threads) {
+    std::vector<std::string> enriched(batch.size());
+    auto enrichRange = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            enriched[i] = generateV2Transcription(batch[i].transcription, batch[i].talkgroupID, batch[i].radioID,
+                                                  talkgroupFiles);
+        }
+    };
+    if (!pool || batch.size() < 2) {
+        enrichRange(0, batch.size());
+        return enriched;
+    }
+
+    // One contiguous slice per worker; each writes only its own slots
+    const size_t slice = (batch.size() + threads - 1) / threads;
+    std::vector<std::future<void>> slices;
+    for (size_t begin = 0; begin < batch.size(); begin += slice) {
+        slices.push_back(pool->enqueue(enrichRange, begin, std::min(begin + slice, batch.size())));
+    }
+    for (auto& done : slices) {
+        done.get();
+    }
+    return enriched;
+}
+
+} // namespace
+
+Result<TranscriptionFilter> reenrichFilter(std::optional<int> talkgroupID, const std::string& fromDate,
+                                           const std::string& toDate) {
+    TranscriptionFilter filter;
+    filter.talkgroupID = talkgroupID;
+    if (!fromDate.empty()) {
+        const auto wallClock = parseRecordingWallClock(fromDate, "000000");
+        if (!wallClock) {
+            return Err<TranscriptionFilter>(ErrorCode::InvalidFormat, "Expected YYYYMMDD: " + fromDate, "--from");
+        }
+        filter.fromUnixtime = localWallClockToUnix(*wallClock);
+    }
+    if (!toDate.empty()) {
+        const auto wallClock = parseRecordingWallClock(toDate, "000000");
+        if (!wallClock) {
+            return Err<TranscriptionFilter>(ErrorCode::InvalidFormat, "Expected YYYYMMDD: " + toDate, "--to");
+        }
+        // Through the end of that day: before midnight starting the next
+        filter.toUnixtime = localWallClockToUnix(*wallClock + DAY_SECONDS);
+    }
+    return filter;
+}
+
+ReenrichStats reenrichTranscriptions(DatabaseManager& db, const TalkgroupProfiles& talkgroupFiles,
+                                     const ReenrichOptions& options, const std::atomic<bool>* cancel) {
+    const size_t threads = std::max<size_t>(1, options.threads);
+    const size_t batchSize = std::max<size_t>(1, options.batchSize);
+    std::unique_ptr<ThreadPool> pool;
+    if (threads > 1) {
+        pool = std::make_unique<ThreadPool>(threads);
+    }
+
+    ReenrichStats stats;
+    std::future<size_t> writing;
+    auto batch = db.readTranscriptions(options.filter, 0, batchSize);
+    while (!batch.empty() && !(cancel && cancel->load())) {
+        auto enriched = enrichBatch(batch, talkgroupFiles, pool.get(), threads);
+        Updates updates;
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (enriched[i].empty()) {
+                ++stats.failed;
+            } else if (enriched[i] == batch[i].v2transcription) {
+                ++stats.unchanged;
+            } else {
+                updates.emplace_back(batch[i].id, std::move(enriched[i]));
+            }
+        }
+        stats.scanned += batch.size();
+
+        // The previous batch's write has to finish before the next read,
+        // which shares the connection; this batch's write then runs while
+        // the next one is enriched
+        if (writing.valid()) {
+            stats.updated += writing.get();
+        }
+        batch = db.readTranscriptions(options.filter, batch.back().id, batchSize);
+        writing = std::async(std::launch::async,
+                             [&db, updates = std::move(updates)] { return db.updateV2Transcriptions(updates); });
+    }
+    if (writing.valid()) {
+        stats.updated += writing.get();
+    }
+    return stats;
+}
+
+} // namespace sdrtrunk
@@ -0,0 +1,162 @@
+/**
+ * @file SdrTrunkFilename.cpp
+ * @brief Single-pass SDRTrunk filename parser
+ *
+ * Replaces the std::regex patterns that extractFileInfo() and
+ * extractTalkgroupIdFromFilename() compiled on every call. Everything is
+ * string_view searches and std::from_chars, so parsing a name does not
+ * touch the heap.
+ */
+
+#include "../include/SdrTrunkFilename.h"
+
+#include <algorithm>
+#include <charconv>
+
+namespace sdrtrunk {
+
+namespace {
+
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// The digits at pos as an int, moving pos past them; nullopt when there
+// are no digits or they overflow
+std::optional<int> readNumber(std::string_view text, size_t& pos) {
+    if (pos >= text.size() || !isDigit(text[pos])) {
+        return std::nullopt;
+    }
+    int value = 0;
+    const char* begin = text.data() + pos;
+    auto [end, ec] = std::from_chars(begin, text.data() + text.size(), value);
+    pos += static_cast<size_t>(end - begin);
+    if (ec != std::errc()) {
+        while (pos < text.size() && isDigit(text[pos])) {
+            ++pos;
+        }
+        return std::nullopt;
+    }
+    return value;
+}
+
+// regex_search for prefix(\d+): the first occurrence of prefix that is
+// followed by a digit
+size_t findNumberAfter(std::string_view text, std::string_view prefix, size_t from = 0) {
+    for (size_t pos = text.find(prefix, from); pos != std::string_view::npos; pos = text.find(prefix, pos + 1)) {
+        const size_t digits = pos + prefix.size();
+        if (digits < text.size() && isDigit(text[digits])) {
+            return digits;
+        }
+    }
+    return std::string_view::npos;
+}
+
+std::optional<int> numberAfter(std::string_view text, std::string_view prefix) {
+    size_t pos = findNumberAfter(text, prefix);
+    if (pos == std::string_view::npos) {
+        return std::nullopt;
+    }
+    return readNumber(text, pos);
+}
+
+// TO_P52197 or the legacy TO_P_52198
+std::optional<int> patchNumber(std::string_view text) {
+    for (size_t pos = text.find("TO_P"); pos != std::string_view::npos; pos = text.find("TO_P", pos + 1)) {
+        size_t digits = pos + 4;
+        if (digits < text.size() && text[digits] == '_') {
+            ++digits;
+        }
+        if (digits < text.size() && isDigit(text[digits])) {
+            return readNumber(text, digits);
+        }
+    }
+    return std::nullopt;
+}
+
+// Members of [52198--51426__56881]; any non-digits separate them
+void readPatchMembers(std::string_view text, size_t pos, SdrTrunkFilename& parsed) {
+    while (pos < text.size() && text[pos] != ']') {
+        if (!isDigit(text[pos])) {
+            ++pos;
+            continue;
+        }
+        auto member = readNumber(text, pos);
+        if (member && parsed.patchMemberCount < MAX_PATCH_MEMBERS) {
+            parsed.patchMembers[parsed.patchMemberCount++] = *member;
+        }
+    }
+}
+
+} // namespace
+
+SdrTrunkFilename parseSdrTrunkFilename(std::string_view filename) {
+    SdrTrunkFilename parsed;
+    parsed.filename = filename;
+    if (filename.size() >= 8) {
+        parsed.date = filename.substr(0, 8);
+    }
+    if (filename.size() >= 15) {
+        parsed.time = filename.substr(9, 6);
+    }
+
+    // Name between the timestamp and "__TO_", after an optional separator
+    const size_t toPos = filename.find("__TO_");
+    if (toPos != std::string_view::npos && toPos > 15) {
+        const size_t nameStart = filename[15] == '_' ? 16 : 15;
+        if (nameStart < toPos) {
+            parsed.name = filename.substr(nameStart, toPos - nameStart);
+        }
+    }
+
+    if (filename.find("TO_P") != std::string_view::npos) {
+        parsed.patchGroup = patchNumber(filename);
+        if (size_t bracket = findNumberAfter(filename, "["); bracket != std::string_view::npos) {
+            readPatchMembers(filename, bracket, parsed);
+            size_t first = bracket;
+            parsed.talkgroup = readNumber(filename, first);
+        } else {
+            parsed.talkgroup = parsed.patchGroup;
+        }
+    }
+    if (!parsed.talkgroup) {
+        parsed.talkgroup = numberAfter(filename, "TO_");
+    }
+
+    // _V2 after the talkgroup, ended by the next field or the extension
+    if (size_t to = filename.find("TO_"); to != std::string_view::npos) {
+        for (size_t pos = findNumberAfter(filename, "_V", to); pos != std::string_view::npos;
+             pos = findNumberAfter(filename, "_V", pos)) {
+            size_t end = pos;
+            auto version = readNumber(filename, end);
+            if (version && (end == filename.size() || filename[end] == '_' || filename[end] == '.')) {
+                parsed.version = *version;
+                break;
+            }
+        }
+    }
+
+    parsed.radioId = numberAfter(filename, "_FROM_");
+    return parsed;
+}
+
+std::vector<int> recordingTalkgroups(const SdrTrunkFilename& parsed) {
+    std::vector<int> talkgroups;
+    auto add = [&talkgroups](int talkgroup) {
+        if (std::ranges::find(talkgroups, talkgroup) == talkgroups.end()) {
+            talkgroups.push_back(talkgroup);
+        }
+    };
+    if (parsed.talkgroup) {
+        add(*parsed.talkgroup);
+    }
+    for (int member : parsed.members()) {
+        add(member);
+    }
+    if (parsed.patchGroup) {
+        add(*parsed.patchGroup);
+    }
+    return talkgroups;
+}
+
+} // namespace sdrtrunk
@@ -0,0 +1,146 @@
+/**
+ * @file TalkgroupProfiles.cpp
+ * @brief Deduplicated TALKGROUP_FILES settings in an interval table
+ *
+ * ConfigSingleton::initialize() used to copy a key's whole TalkgroupFiles
+ * (glossary file list, prompt, decode profile) into a hash map once per ID
+ * the key expanded to, so "1-65535" meant 65,535 entries. Now equal
+ * settings are stored once, and each key's ranges become entries of a
+ * sorted table of disjoint intervals that refer to them.
+ */
+
+#include "../include/TalkgroupProfiles.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+
+namespace sdrtrunk {
+
+std::vector<TalkgroupRange> parseTalkgroupRanges(const std::string& idString) {
+    std::vector<TalkgroupRange> ranges;
+    std::stringstream ss(idString);
+    std::string token;
+    while (std::getline(ss, token, ',')) {
+        const size_t dash = token.find('-');
+        if (dash == std::string::npos) {
+            const int id = std::stoi(token);
+            ranges.push_back({id, id});
+            continue;
+        }
+        const int first = std::stoi(token.substr(0, dash));
+        const int last = std::stoi(token.substr(dash + 1));
+        if (first <= last) {
+            ranges.push_back({first, last});
+        }
+    }
+    return ranges;
+}
+
+void TalkgroupProfiles::assign(const std::vector<TalkgroupRange>& ranges, TalkgroupFiles files) {
+    if (ranges.empty()) {
+        return;
+    }
+    // A configuration has one profile per TALKGROUP_FILES key at most, so
+    // a scan finds an equal one quickly enough
+    auto existing = std::ranges::find_if(profiles_, [&files](const auto& profile) { return *profile == files; });
+    std::shared_ptr<const TalkgroupFiles> profile;
+    if (existing != profiles_.end()) {
+        profile = *existing;
+    } else {
+        profile = std::make_shared<const TalkgroupFiles>(std::move(files));
+        profiles_.push_back(profile);
+    }
+
+    // Merge the key's own ranges first so "1,2,3,...,500" is one insert
+    auto sorted = ranges;
+    std::ranges::sort(sorted, {}, &TalkgroupRange::first);
+    TalkgroupRange pending = sorted.front();
+    for (const auto& range : sorted) {
+        if (static_cast<int64_t>(range.first) <= static_cast<int64_t>(pending.last) + 1) {
+            pending.last = std::max(pending.last, range.last);
+        } else {
+            insert(pending, profile);
+            pending = range;
+        }
+    }
+    insert(pending, profile);
+
+    // Rejoin neighbours that ended up with the same profile, e.g. after a
+    // hole in a range was given that range's settings again
+    std::vector<Interval> joined;
+    joined.reserve(intervals_.size());
+    for (auto& interval : intervals_) {
+        if (!joined.empty() && joined.back().profile == interval.profile &&
+            static_cast<int64_t>(joined.back().last) + 1 == interval.first) {
+            joined.back().last = interval.last;
+        } else {
+            joined.push_back(std::move(interval));
+        }
+    }
+    intervals_ = std::move(joined);
+
+    talkgroupCount_ = 0;
+    for (const auto& interval : intervals_) {
+        talkgroupCount_ += static_cast<size_t>(static_cast<int64_t>(interval.last) - interval.first + 1);
+    }
+
+    // Drop profiles every talkgroup has been moved off
+    std::erase_if(profiles_, [](const auto& stored) { return stored.use_count() == 1; });
+}
+
+void TalkgroupProfiles::insert(const TalkgroupRange& range, const std::shared_ptr<const TalkgroupFiles>& profile) {
+    // Intervals overlapping range are cut back to the parts outside it
+    std::vector<Interval> updated;
+    updated.reserve(intervals_.size() + 2);
+    auto it = std::ranges::lower_bound(intervals_, range.first, {}, &Interval::last);
+    updated.insert(updated.end(), intervals_.begin(), it);
+    std::optional<Interval> tail;
+    for (; it != intervals_.end() && it->first <= range.last; ++it) {
+        if (it->first < range.first) {
+            updated.push_back({it->first, range.first - 1, it->profile});
+        }
+        if (it->last > range.last) {
+            tail = Interval{range.last + 1, it->last, it->profile};
+        }
+    }
+    updated.push_back({range.first, range.last, profile});
+    if (tail) {
+        updated.push_back(std::move(*tail));
+    }
+    updated.insert(updated.end(), it, intervals_.end());
+    intervals_ = std::move(updated);
+}
+
+size_t TalkgroupProfiles::locate(int talkgroupID) const {
+    auto it = std::ranges::upper_bound(intervals_, talkgroupID, {}, &Interval::first);
+    if (it == intervals_.begin() || std::prev(it)->last < talkgroupID) {
+        return intervals_.size();
+    }
+    return static_cast<size_t>(std::prev(it) - intervals_.begin());
+}
+
+const TalkgroupFiles* TalkgroupProfiles::lookup(int talkgroupID) const {
+    const size_t index = locate(talkgroupID);
+    return index < intervals_.size() ? intervals_[index].profile.get() : nullptr;
+}
+
+TalkgroupProfiles::const_iterator TalkgroupProfiles::begin() const {
+    return intervals_.empty() ? end() : const_iterator(&intervals_, 0, intervals_.front().first);
+}
+
+TalkgroupProfiles::const_iterator TalkgroupProfiles::find(int talkgroupID) const {
+    const size_t index = locate(talkgroupID);
+    return index < intervals_.size() ? const_iterator(&intervals_, index, talkgroupID) : end();
+}
+
+const TalkgroupFiles& TalkgroupProfiles::at(int talkgroupID) const {
+    const TalkgroupFiles* files = lookup(talkgroupID);
+    if (!files) {
+        throw std::out_of_range("Talkgroup not configured: " + std::to_string(talkgroupID));
+    }
+    return *files;
+}
+
+} // namespace sdrtrunk
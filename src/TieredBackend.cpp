@@ -0,0 +1,138 @@
+/**
+ * @file TieredBackend.cpp
+ * @brief Draft-then-escalate transcription with compute accounting
+ */
+
+#include "../include/TieredBackend.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <utility>
+
+#include "../include/ConfigSingleton.h"
+#include "../include/debugUtils.h"
+#include "../include/jsonParser.h"
+
+namespace sdrtrunk {
+
+TranscriptionConfidence parseTranscriptionConfidence(std::string_view json) {
+    TranscriptionConfidence confidence;
+    size_t start = json.find('{');
+    if (start == std::string_view::npos) {
+        return confidence;
+    }
+    try {
+        auto object = JsonParser::parseString(std::string(json.substr(start)));
+        if (auto it = object.find("avg_logprob"); it != object.end() && std::holds_alternative<double>(it->second)) {
+            confidence.avgLogprob = std::get<double>(it->second);
+        }
+        if (auto it = object.find("no_speech_prob"); it != object.end() && std::holds_alternative<double>(it->second)) {
+            confidence.noSpeechProb = std::get<double>(it->second);
+        }
+    } catch (const std::exception&) {
+        // Unparseable responses carry no confidence
+    }
+    return confidence;
+}
+
+TieredBackend::TieredBackend(std::shared_ptr<TranscriptionBackend> draft,
+                             std::shared_ptr<TranscriptionBackend> full,
+                             TierThresholds thresholds)
+    : draft_(std::move(draft)), full_(std::move(full)), thresholds_(thresholds) {}
+
+std::string TieredBackend::name() const {
+    return "tiered(" + draft_->name() + " -> " + full_->name() + ")";
+}
+
+bool TieredBackend::shouldEscalate(const TranscriptionConfidence& confidence) const {
+    // A draft that reports nothing cannot vouch for itself
+    if (!confidence.avgLogprob && !confidence.noSpeechProb) {
+        return true;
+    }
+    if (confidence.avgLogprob && *confidence.avgLogprob < thresholds_.minAvgLogprob) {
+        return true;
+    }
+    if (confidence.noSpeechProb && *confidence.noSpeechProb > thresholds_.maxNoSpeechProb) {
+        return true;
+    }
+    return false;
+}
+
+double TieredBackend::estimateFullSeconds(double audioSeconds) const {
+    std::lock_guard<std::mutex> lock(rtfMutex_);
+    if (fullAudioSeconds_ <= 0.0) {
+        return 0.0;  // No full-model run measured yet
+    }
+    return audioSeconds * fullWallSeconds_ / fullAudioSeconds_;
+}
+
+void TieredBackend::recordFullRun(double audioSeconds, double wallSeconds) {
+    std::lock_guard<std::mutex> lock(rtfMutex_);
+    fullAudioSeconds_ += audioSeconds;
+    fullWallSeconds_ += wallSeconds;
+}
+
+Result<std::string> TieredBackend::transcribe(const TranscriptionRequest& request) {
+    using Clock = std::chrono::steady_clock;
+    auto secondsSince = [](Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    };
+
+    // Decode once for both passes, and only when they take samples
+    TranscriptionRequest shared = request;
+    BudgetedPcm decoded;
+    if (!shared.pcm && consumesPcm()) {
+        auto pcm = decodeRequestAudio(request);
+        if (pcm.has_value()) {
+            decoded = std::move(pcm.value());
+            shared.pcm = &decoded.pcm;
+        }
+    }
+    double audioSeconds = shared.pcm ? shared.pcm->durationSeconds() : request.durationSeconds;
+
+    // The draft keeps its own cheap settings; DECODE_PROFILE is for the
+    // model whose accuracy it describes
+    TranscriptionRequest draftRequest = shared;
+    draftRequest.decodeProfile = nullptr;
+
+    TierOutcome outcome;
+    outcome.tiered = true;
+    auto draftStart = Clock::now();
+    auto draft = draft_->transcribe(draftRequest);
+    outcome.draftSeconds = secondsSince(draftStart);
+
+    if (draft.has_value() && !shouldEscalate(parseTranscriptionConfidence(draft.value()))) {
+        outcome.savedSeconds = std::max(0.0, estimateFullSeconds(audioSeconds) - outcome.draftSeconds);
+        if (request.tierOutcome) {
+            *request.tierOutcome = outcome;
+        }
+        return draft;
+    }
+
+    if (ConfigSingleton::getInstance().isDebugFileProcessor()) {
+        std::cout << "[" << getCurrentTime() << "] "
+                  << "TieredBackend.cpp transcribe Escalating " << request.filePath << " to " << full_->name()
+                  << (draft.has_value() ? " (low confidence)" : " (draft failed: " + draft.error().toString() + ")")
+                  << std::endl;
+    }
+
+    outcome.escalated = true;
+    auto fullStart = Clock::now();
+    auto full = full_->transcribe(shared);
+    outcome.fullSeconds = secondsSince(fullStart);
+    if (full.has_value()) {
+        recordFullRun(audioSeconds, outcome.fullSeconds);
+    }
+    if (request.tierOutcome) {
+        *request.tierOutcome = outcome;
+    }
+
+    // A failed full pass still leaves the draft as the best answer
+    if (!full.has_value() && draft.has_value()) {
+        return draft;
+    }
+    return full;
+}
+
+} // namespace sdrtrunk
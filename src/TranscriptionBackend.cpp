@@ -0,0 +1,49 @@
+/**
+ * @file TranscriptionBackend.cpp
+ * @brief Adapters exposing the existing remote and Python engines as backends
+ */
+
+#include "../include/TranscriptionBackend.h"
+#include "../include/curlHelper.h"
+#include "../include/fasterWhisper.h"
+#include "../include/RecordingFile.h"
+
+namespace sdrtrunk {
+
+Result<BudgetedPcm> decodeRequestAudio(const TranscriptionRequest& request) {
+    return request.file ? decodeWithinBudget(*request.file, request.durationSeconds)
+                        : decodeWithinBudget(request.filePath, request.durationSeconds);
+}
+
+Result<std::string> OpenAIBackend::transcribe(const TranscriptionRequest& request) {
+    std::string response = request.file ? curl_transcribe_audio(*request.file, apiKey_, request.prompt)
+                                        : curl_transcribe_audio(request.filePath, apiKey_, request.prompt);
+    if (response.empty()) {
+        return Err<std::string>(ErrorCode::NetworkError, "Empty response from OpenAI API", request.filePath);
+    }
+    return response;
+}
+
+Result<std::string> FasterWhisperBackend::transcribe(const TranscriptionRequest& request) {
+    LocalTranscribeOptions options;
+    options.model = model_;
+    options.pcm = request.pcm;
+    options.profile = request.decodeProfile;
+    options.file = request.file;
+    auto result = local_transcribe_audio(request.filePath, options);
+    if (!result.has_value()) {
+        return Err<std::string>(ErrorCode::TranscriptionFailed, result.error(), request.filePath);
+    }
+    return result.value();
+}
+
+bool FasterWhisperBackend::consumesPcm() const {
+    // Only the embedded interpreter takes samples; the script fallback reads the file
+#ifdef USE_PYBIND11
+    return true;
+#else
+    return false;
+#endif
+}
+
+} // namespace sdrtrunk
@@ -0,0 +1,109 @@
+/**
+ * @file TranscriptionRouter.cpp
+ * @brief Per-recording routing between local and remote transcription
+ */
+
+#include "../include/TranscriptionRouter.h"
+
+#include <iostream>
+#include <utility>
+
+#include "../include/ConfigSingleton.h"
+#include "../include/debugUtils.h"
+
+namespace sdrtrunk {
+
+const char* routeToString(Route route) {
+    return route == Route::Local ? "local" : "remote";
+}
+
+TranscriptionRouter::TranscriptionRouter(std::shared_ptr<TranscriptionBackend> local,
+                                         std::shared_ptr<TranscriptionBackend> remote,
+                                         RoutingRules rules,
+                                         HeadroomFn remoteHeadroom)
+    : local_(std::move(local)),
+      remote_(std::move(remote)),
+      rules_(std::move(rules)),
+      remoteHeadroom_(std::move(remoteHeadroom)) {}
+
+Route TranscriptionRouter::choose(const TranscriptionRequest& request) const {
+    bool limited = false;
+    Route route = preferredRoute(request, limited);
+    if (route == Route::Local && limited && localInFlight_.load() >= rules_.localMaxInFlight) {
+        return Route::Remote;
+    }
+    return route;
+}
+
+Route TranscriptionRouter::preferredRoute(const TranscriptionRequest& request, bool& limited) const {
+    limited = false;
+    if (!remote_) {
+        return Route::Local;
+    }
+    if (!local_) {
+        return Route::Remote;
+    }
+
+    if (rules_.remoteTalkgroups.contains(request.talkgroupId)) {
+        return Route::Remote;
+    }
+    if (rules_.localTalkgroups.contains(request.talkgroupId)) {
+        return Route::Local;
+    }
+
+    // Without API headroom a remote request would only sleep in the rate
+    // limiter, so the local queue is the faster option
+    bool remoteAvailable = !remoteHeadroom_ || remoteHeadroom_() >= rules_.remoteMinHeadroom;
+    if (!remoteAvailable) {
+        return Route::Local;
+    }
+
+    if (rules_.localMaxDurationSeconds > 0.0 && request.durationSeconds > rules_.localMaxDurationSeconds) {
+        return Route::Remote;
+    }
+    limited = rules_.localMaxInFlight > 0;
+    return Route::Local;
+}
+
+bool TranscriptionRouter::tryAcquireLocalSlot() {
+    int taken = localInFlight_.load();
+    while (taken < rules_.localMaxInFlight) {
+        if (localInFlight_.compare_exchange_weak(taken, taken + 1)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+Result<std::string> TranscriptionRouter::transcribe(const TranscriptionRequest& request) {
+    // The slot is taken as part of the decision, so concurrent workers
+    // cannot all see a free slot and overfill the local queue
+    bool limited = false;
+    Route route = preferredRoute(request, limited);
+    if (route == Route::Local) {
+        if (!limited) {
+            ++localInFlight_;
+        } else if (!tryAcquireLocalSlot()) {
+            route = Route::Remote;
+        }
+    }
+    if (ConfigSingleton::getInstance().isDebugFileProcessor()) {
+        std::cout << "[" << getCurrentTime() << "] "
+                  << "TranscriptionRouter.cpp transcribe " << request.filePath
+                  << " (TG " << request.talkgroupId << ", " << request.durationSeconds << " s, "
+                  << localInFlight_.load() << " local in flight) -> " << routeToString(route) << std::endl;
+    }
+
+    if (route == Route::Remote) {
+        return remote_->transcribe(request);
+    }
+
+    // Releases the slot taken above once the local backend returns
+    struct InFlightGuard {
+        std::atomic<int>& count;
+        ~InFlightGuard() { --count; }
+    } guard{localInFlight_};
+    return local_->transcribe(request);
+}
+
+} // namespace sdrtrunk
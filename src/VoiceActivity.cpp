@@ -0,0 +1,312 @@
+/**
+ * @file VoiceActivity.cpp
+ * @brief Energy / zero-crossing / spectral-flatness voice-activity gate
+ *
+ * Runs on the 16 kHz PCM from decodeMP3ToPcm() so key-ups, dead air and
+ * encrypted noise can be dropped before they cost a transcription. The
+ * energy and zero-crossing kernels are vectorized: SSE2 is the x86-64
+ * baseline, AVX2 is selected at runtime on GCC/Clang builds, and NEON is
+ * used on ARM64. Spectral flatness uses a small radix-2 FFT and is only
+ * computed for frames that pass the cheaper tests.
+ */
+
+#include "../include/VoiceActivity.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <complex>
+#include <memory>
+#include <numbers>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SDRTRUNK_VAD_X86 1
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define SDRTRUNK_VAD_AVX2 1
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define SDRTRUNK_VAD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace sdrtrunk {
+
+namespace {
+
+float sumOfSquaresScalar(const float* x, size_t n) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        sum += x[i] * x[i];
+    }
+    return sum;
+}
+
+// Counts sign changes between x[i - 1] and x[i] for i in [begin, n)
+size_t zeroCrossingsScalar(const float* x, size_t begin, size_t n) {
+    size_t count = 0;
+    for (size_t i = std::max<size_t>(begin, 1); i < n; ++i) {
+        count += static_cast<size_t>((x[i] < 0.0f) != (x[i - 1] < 0.0f));
+    }
+    return count;
+}
+
+#ifdef SDRTRUNK_VAD_X86
+
+float sumOfSquaresSse2(const float* x, size_t n) {
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128 a = _mm_loadu_ps(x + i);
+        __m128 b = _mm_loadu_ps(x + i + 4);
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(a, a));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(b, b));
+    }
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, _mm_add_ps(acc0, acc1));
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sumOfSquaresScalar(x + i, n - i);
+}
+
+size_t zeroCrossingsSse2(const float* x, size_t n) {
+    const __m128 zero = _mm_setzero_ps();
+    size_t count = 0;
+    size_t i = 1;
+    for (; i + 4 <= n; i += 4) {
+        __m128 cur = _mm_cmplt_ps(_mm_loadu_ps(x + i), zero);
+        __m128 prev = _mm_cmplt_ps(_mm_loadu_ps(x + i - 1), zero);
+        count += static_cast<size_t>(std::popcount(static_cast<unsigned>(_mm_movemask_ps(_mm_xor_ps(cur, prev)))));
+    }
+    return count + zeroCrossingsScalar(x, i, n);
+}
+
+#ifdef SDRTRUNK_VAD_AVX2
+
+__attribute__((target("avx2,fma")))
+float sumOfSquaresAvx2(const float* x, size_t n) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256 a = _mm256_loadu_ps(x + i);
+        __m256 b = _mm256_loadu_ps(x + i + 8);
+        acc0 = _mm256_fmadd_ps(a, a, acc0);
+        acc1 = _mm256_fmadd_ps(b, b, acc1);
+    }
+    __m256 acc = _mm256_add_ps(acc0, acc1);
+    __m128 half = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, half);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sumOfSquaresScalar(x + i, n - i);
+}
+
+__attribute__((target("avx2")))
+size_t zeroCrossingsAvx2(const float* x, size_t n) {
+    const __m256 zero = _mm256_setzero_ps();
+    size_t count = 0;
+    size_t i = 1;
+    for (; i + 8 <= n; i += 8) {
+        __m256 cur = _mm256_cmp_ps(_mm256_loadu_ps(x + i), zero, _CMP_LT_OQ);
+        __m256 prev = _mm256_cmp_ps(_mm256_loadu_ps(x + i - 1), zero, _CMP_LT_OQ);
+        count += static_cast<size_t>(std::popcount(static_cast<unsigned>(_mm256_movemask_ps(_mm256_xor_ps(cur, prev)))));
+    }
+    return count + zeroCrossingsScalar(x, i, n);
+}
+
+bool hasAvx2() {
+    static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return supported;
+}
+
+#endif // SDRTRUNK_VAD_AVX2
+
+#endif // SDRTRUNK_VAD_X86
+
+#ifdef SDRTRUNK_VAD_NEON
+
+float sumOfSquaresNeon(const float* x, size_t n) {
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        float32x4_t a = vld1q_f32(x + i);
+        float32x4_t b = vld1q_f32(x + i + 4);
+        acc0 = vfmaq_f32(acc0, a, a);
+        acc1 = vfmaq_f32(acc1, b, b);
+    }
+    return vaddvq_f32(vaddq_f32(acc0, acc1)) + sumOfSquaresScalar(x + i, n - i);
+}
+
+size_t zeroCrossingsNeon(const float* x, size_t n) {
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    uint32x4_t acc = vdupq_n_u32(0);
+    size_t i = 1;
+    for (; i + 4 <= n; i += 4) {
+        uint32x4_t cur = vcltq_f32(vld1q_f32(x + i), zero);
+        uint32x4_t prev = vcltq_f32(vld1q_f32(x + i - 1), zero);
+        acc = vaddq_u32(acc, vshrq_n_u32(veorq_u32(cur, prev), 31));
+    }
+    return static_cast<size_t>(vaddvq_u32(acc)) + zeroCrossingsScalar(x, i, n);
+}
+
+#endif // SDRTRUNK_VAD_NEON
+
+// Hann window, twiddles and bit-reversal table for one FFT size
+struct FftPlan {
+    size_t size = 0;
+    std::vector<float> window;
+    std::vector<std::complex<float>> twiddles;
+    std::vector<size_t> bitReverse;
+
+    explicit FftPlan(size_t n) : size(n), window(n), twiddles(n / 2), bitReverse(n) {
+        const double twoPi = 2.0 * std::numbers::pi;
+        for (size_t i = 0; i < n; ++i) {
+            window[i] = static_cast<float>(0.5 - 0.5 * std::cos(twoPi * static_cast<double>(i) / static_cast<double>(n)));
+        }
+        for (size_t k = 0; k < n / 2; ++k) {
+            double angle = -twoPi * static_cast<double>(k) / static_cast<double>(n);
+            twiddles[k] = {static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle))};
+        }
+        const int bits = std::countr_zero(n);
+        for (size_t i = 0; i < n; ++i) {
+            size_t reversed = 0;
+            for (int b = 0; b < bits; ++b) {
+                reversed |= ((i >> b) & 1u) << (bits - 1 - b);
+            }
+            bitReverse[i] = reversed;
+        }
+    }
+};
+
+const FftPlan& fftPlan(size_t n) {
+    // Frames within a recording share one size, so one cached plan per
+    // worker thread is enough
+    thread_local std::unique_ptr<FftPlan> plan;
+    if (!plan || plan->size != n) {
+        plan = std::make_unique<FftPlan>(n);
+    }
+    return *plan;
+}
+
+} // namespace
+
+namespace vad {
+
+float sumOfSquares(std::span<const float> x) {
+#if defined(SDRTRUNK_VAD_AVX2)
+    if (hasAvx2()) {
+        return sumOfSquaresAvx2(x.data(), x.size());
+    }
+    return sumOfSquaresSse2(x.data(), x.size());
+#elif defined(SDRTRUNK_VAD_X86)
+    return sumOfSquaresSse2(x.data(), x.size());
+#elif defined(SDRTRUNK_VAD_NEON)
+    return sumOfSquaresNeon(x.data(), x.size());
+#else
+    return sumOfSquaresScalar(x.data(), x.size());
+#endif
+}
+
+size_t zeroCrossings(std::span<const float> x) {
+#if defined(SDRTRUNK_VAD_AVX2)
+    if (hasAvx2()) {
+        return zeroCrossingsAvx2(x.data(), x.size());
+    }
+    return zeroCrossingsSse2(x.data(), x.size());
+#elif defined(SDRTRUNK_VAD_X86)
+    return zeroCrossingsSse2(x.data(), x.size());
+#elif defined(SDRTRUNK_VAD_NEON)
+    return zeroCrossingsNeon(x.data(), x.size());
+#else
+    return zeroCrossingsScalar(x.data(), 1, x.size());
+#endif
+}
+
+bool powerSpectrum(std::span<const float> x, std::vector<float>& power) {
+    const size_t n = x.size();
+    if (n < 4 || !std::has_single_bit(n)) {
+        return false;
+    }
+    const FftPlan& plan = fftPlan(n);
+
+    thread_local std::vector<std::complex<float>> buffer;
+    buffer.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        buffer[plan.bitReverse[i]] = {x[i] * plan.window[i], 0.0f};
+    }
+
+    // Iterative radix-2 Cooley-Tukey
+    for (size_t len = 2; len <= n; len <<= 1) {
+        const size_t half = len / 2;
+        const size_t stride = n / len;
+        for (size_t start = 0; start < n; start += len) {
+            for (size_t k = 0; k < half; ++k) {
+                std::complex<float> t = plan.twiddles[k * stride] * buffer[start + k + half];
+                buffer[start + k + half] = buffer[start + k] - t;
+                buffer[start + k] += t;
+            }
+        }
+    }
+
+    power.resize(n / 2 + 1);
+    for (size_t k = 0; k <= n / 2; ++k) {
+        power[k] = std::norm(buffer[k]);
+    }
+    return true;
+}
+
+double spectralFlatness(std::span<const float> x) {
+    thread_local std::vector<float> power;
+    if (!powerSpectrum(x, power)) {
+        return 1.0;
+    }
+
+    constexpr double epsilon = 1e-12;
+    const size_t bins = x.size() / 2;
+    double logSum = 0.0;
+    double sum = 0.0;
+    for (size_t k = 1; k <= bins; ++k) {
+        double value = static_cast<double>(power[k]);
+        logSum += std::log(value + epsilon);
+        sum += value;
+    }
+    double arithmetic = sum / static_cast<double>(bins);
+    if (arithmetic < epsilon) {
+        return 1.0;
+    }
+    return std::exp(logSum / static_cast<double>(bins)) / (arithmetic + epsilon);
+}
+
+} // namespace vad
+
+VadResult analyzeVoiceActivity(std::span<const float> samples, const VadConfig& config) {
+    VadResult result;
+    if (config.frameSamples < 4) {
+        return result;
+    }
+    // Flatness needs a power-of-two frame
+    const size_t frame = std::bit_floor(static_cast<size_t>(config.frameSamples));
+    const double minMeanSquare = std::pow(10.0, config.energyThresholdDb / 10.0);
+
+    for (size_t offset = 0; offset + frame <= samples.size(); offset += frame) {
+        std::span<const float> x = samples.subspan(offset, frame);
+        ++result.frames;
+
+        double meanSquare = static_cast<double>(vad::sumOfSquares(x)) / static_cast<double>(frame);
+        if (meanSquare < minMeanSquare) {
+            continue;
+        }
+        double zcr = static_cast<double>(vad::zeroCrossings(x)) / static_cast<double>(frame - 1);
+        if (zcr > config.maxZeroCrossingRate) {
+            continue;
+        }
+        if (vad::spectralFlatness(x) > config.maxSpectralFlatness) {
+            continue;
+        }
+        ++result.speechFrames;
+    }
+    return result;
+}
+
+} // namespace sdrtrunk
@@ -0,0 +1,217 @@
+/**
+ * @file WhisperCppBackend.cpp
+ * @brief Native local transcription using whisper.cpp
+ *
+ * The ggml model is loaded once into a shared whisper_context. Decoder
+ * state (KV cache, mel buffers) lives in whisper_state objects that are
+ * created on demand and recycled, one per concurrently transcribing
+ * worker, so parallel mode scales with the thread pool instead of
+ * queueing behind a single interpreter.
+ */
+
+#include "../include/WhisperCppBackend.h"
+
+#include <chrono>
+#include <iostream>
+#include <string_view>
+#include <utility>
+
+#include "../include/debugUtils.h"
+
+#ifdef USE_WHISPER_CPP
+#include <whisper.h>
+#endif
+
+namespace sdrtrunk {
+
+#ifdef USE_WHISPER_CPP
+
+namespace {
+
+// whisper.cpp segments carry a leading space and sometimes trailing newlines
+std::string_view trimSegment(std::string_view text) {
+    constexpr std::string_view whitespace = " \t\n\r\f\v";
+    size_t start = text.find_first_not_of(whitespace);
+    if (start == std::string_view::npos) {
+        return {};
+    }
+    size_t end = text.find_last_not_of(whitespace);
+    return text.substr(start, end - start + 1);
+}
+
+} // namespace
+
+Result<std::unique_ptr<WhisperCppBackend>> WhisperCppBackend::create(const WhisperCppConfig& config) {
+    if (config.modelPath.empty()) {
+        return Err<std::unique_ptr<WhisperCppBackend>>(ErrorCode::ConfigError,
+                                                       "WHISPER_CPP_MODEL is not set");
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    whisper_context_params cparams = whisper_context_default_params();
+    whisper_context* ctx = whisper_init_from_file_with_params_no_state(config.modelPath.c_str(), cparams);
+    if (!ctx) {
+        return Err<std::unique_ptr<WhisperCppBackend>>(ErrorCode::FileNotFound,
+                                                       "Failed to load whisper.cpp model: " + config.modelPath);
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    std::cout << "[" << getCurrentTime() << "] "
+              << "WhisperCppBackend.cpp create Loaded " << config.modelPath
+              << " in " << elapsed.count() << " ms" << std::endl;
+
+    return std::unique_ptr<WhisperCppBackend>(new WhisperCppBackend(ctx, config));
+}
+
+WhisperCppBackend::WhisperCppBackend(whisper_context* ctx, WhisperCppConfig config)
+    : ctx_(ctx), config_(std::move(config)) {}
+
+WhisperCppBackend::~WhisperCppBackend() {
+    for (whisper_state* state : allStates_) {
+        whisper_free_state(state);
+    }
+    whisper_free(ctx_);
+}
+
+whisper_state* WhisperCppBackend::acquireState() {
+    {
+        std::lock_guard<std::mutex> lock(statesMutex_);
+        if (!idleStates_.empty()) {
+            whisper_state* state = idleStates_.back();
+            idleStates_.pop_back();
+            return state;
+        }
+    }
+
+    // Allocate outside the lock; state creation is the expensive part
+    whisper_state* state = whisper_init_state(ctx_);
+    if (state) {
+        std::lock_guard<std::mutex> lock(statesMutex_);
+        allStates_.push_back(state);
+    }
+    return state;
+}
+
+void WhisperCppBackend::releaseState(whisper_state* state) {
+    std::lock_guard<std::mutex> lock(statesMutex_);
+    idleStates_.push_back(state);
+}
+
+Result<std::string> WhisperCppBackend::transcribe(const TranscriptionRequest& request) {
+    // Reuse samples decoded earlier in the pipeline when available
+    BudgetedPcm decoded;
+    const PcmBuffer* pcm = request.pcm;
+    if (!pcm) {
+        auto result = decodeRequestAudio(request);
+        if (!result.has_value()) {
+            return std::unexpected(result.error());
+        }
+        decoded = std::move(result.value());
+        pcm = &decoded.pcm;
+    }
+    if (pcm->sampleRate != WHISPER_SAMPLE_RATE) {
+        return Err<std::string>(ErrorCode::InvalidFormat,
+                                "whisper.cpp requires 16 kHz PCM, got " + std::to_string(pcm->sampleRate) + " Hz");
+    }
+
+    whisper_state* state = acquireState();
+    if (!state) {
+        return Err<std::string>(ErrorCode::ResourceExhausted, "Failed to allocate whisper.cpp state");
+    }
+
+    // A talkgroup DECODE_PROFILE overrides the configured beam; its VAD
+    // settings have no whisper.cpp equivalent and are ignored
+    const DecodeProfile* profile = request.decodeProfile;
+    const int beamSize = profile ? profile->beamSize : config_.beamSize;
+    whisper_full_params params = whisper_full_default_params(
+        beamSize > 1 ? WHISPER_SAMPLING_BEAM_SEARCH : WHISPER_SAMPLING_GREEDY);
+    params.n_threads = config_.threads;
+    params.language = config_.language.c_str();
+    params.beam_search.beam_size = beamSize;
+    if (profile) {
+        params.beam_search.patience = static_cast<float>(profile->patience);
+        params.greedy.best_of = profile->bestOf;
+        params.temperature = static_cast<float>(profile->temperature);
+    }
+    params.initial_prompt = request.prompt.empty() ? nullptr : request.prompt.c_str();
+    params.no_context = true;
+    params.print_progress = false;
+    params.print_realtime = false;
+    params.print_special = false;
+    params.print_timestamps = false;
+
+    int rc = whisper_full_with_state(ctx_, state, params, pcm->samples.data(),
+                                     static_cast<int>(pcm->samples.size()));
+
+    std::string text;
+    double logprobSum = 0.0;
+    int textTokens = 0;
+    if (rc == 0) {
+        const whisper_token eot = whisper_token_eot(ctx_);
+        const int segments = whisper_full_n_segments_from_state(state);
+        for (int i = 0; i < segments; ++i) {
+            std::string_view segment = trimSegment(whisper_full_get_segment_text_from_state(state, i));
+            if (segment.empty()) {
+                continue;
+            }
+            if (!text.empty()) {
+                text += ' ';
+            }
+            text += segment;
+
+            // Average log-probability over text tokens, as faster-whisper reports
+            const int tokens = whisper_full_n_tokens_from_state(state, i);
+            for (int j = 0; j < tokens; ++j) {
+                whisper_token_data token = whisper_full_get_token_data_from_state(state, i, j);
+                if (token.id < eot) {
+                    logprobSum += static_cast<double>(token.plog);
+                    ++textTokens;
+                }
+            }
+        }
+    }
+    releaseState(state);
+
+    if (rc != 0) {
+        return Err<std::string>(ErrorCode::TranscriptionFailed,
+                                "whisper_full failed with code " + std::to_string(rc) + " for " + request.filePath);
+    }
+    if (textTokens == 0) {
+        // Nothing heard; report it as fasterWhisper.py does so that a
+        // tiered draft escalates instead of passing as fully confident
+        std::string json = makeTranscriptionJson(text);
+        json.pop_back();
+        json += ",\"no_speech_prob\":1.0}";
+        return json;
+    }
+    return makeTranscriptionJson(text, logprobSum / textTokens);
+}
+
+#else
+
+Result<std::unique_ptr<WhisperCppBackend>> WhisperCppBackend::create(const WhisperCppConfig&) {
+    return Err<std::unique_ptr<WhisperCppBackend>>(ErrorCode::ConfigError,
+                                                   "Built without whisper.cpp support (USE_WHISPER_CPP=OFF)");
+}
+
+WhisperCppBackend::WhisperCppBackend(whisper_context* ctx, WhisperCppConfig config)
+    : ctx_(ctx), config_(std::move(config)) {}
+
+WhisperCppBackend::~WhisperCppBackend() = default;
+
+whisper_state* WhisperCppBackend::acquireState() {
+    return nullptr;
+}
+
+void WhisperCppBackend::releaseState(whisper_state*) {
+}
+
+Result<std::string> WhisperCppBackend::transcribe(const TranscriptionRequest&) {
+    return Err<std::string>(ErrorCode::ConfigError,
+                            "Built without whisper.cpp support (USE_WHISPER_CPP=OFF)");
+}
+
+#endif
+
+} // namespace sdrtrunk
@@ -1,4 +1,5 @@
 #include "../include/commandLineParser.h"
+#include <charconv>
 #include <iostream>
 #include <cstring>
 #include <cstdlib>
@@ -12,7 +13,13 @@ void printHelp() {
     std::cout << "  -c, --config <path>  Configuration path (Optional, default is './config.yaml')\n";
     std::cout << "  -l, --local          Set this to enable local transcription via faster-whisper\n";
     std::cout << "  -p, --parallel       Enable parallel file processing (uses MAX_THREADS from config)\n";
-    std::cout << "  -h, --help           Display this help message\n";
+    std::cout << "  -h, --help           Display this help message\n\n";
+    std::cout << "Re-enrichment (after a glossary change; the filters need --reenrich):\n";
+    std::cout << "  --reenrich           Redo v2transcription of stored recordings from their stored\n";
+    std::cout << "                       transcription and exit; no audio or API calls\n";
+    std::cout << "  --talkgroup <id>     Only recordings of this talkgroup\n";
+    std::cout << "  --from <YYYYMMDD>    Only recordings from this local date on\n";
+    std::cout << "  --to <YYYYMMDD>      Only recordings up to and including this local date\n";
 }
 
 CommandLineArgs parseCommandLine(int argc, char* argv[]) {
@@ -21,6 +28,7 @@ CommandLineArgs parseCommandLine(int argc, char* argv[]) {
     args.localFlag = false;
     args.parallelFlag = false;
     args.helpFlag = false;
+    args.reenrichFlag = false;
 
     // Map of option handlers - options that take no arguments
     std::map<std::string, std::function<void()>> simpleHandlers = {
@@ -29,13 +37,25 @@ CommandLineArgs parseCommandLine(int argc, char* argv[]) {
         {"-l", [&](){ args.localFlag = true; }},
         {"--local", [&](){ args.localFlag = true; }},
         {"-p", [&](){ args.parallelFlag = true; }},
-        {"--parallel", [&](){ args.parallelFlag = true; }}
+        {"--parallel", [&](){ args.parallelFlag = true; }},
+        {"--reenrich", [&](){ args.reenrichFlag = true; }}
     };
 
     // Map of option handlers - options that require an argument
     std::map<std::string, std::function<void(const std::string&)>> argHandlers = {
         {"-c", [&](const std::string& path){ args.configPath = path; }},
-        {"--config", [&](const std::string& path){ args.configPath = path; }}
+        {"--config", [&](const std::string& path){ args.configPath = path; }},
+        {"--talkgroup", [&](const std::string& id){
+            int talkgroup = 0;
+            auto [end, ec] = std::from_chars(id.data(), id.data() + id.size(), talkgroup);
+            if (ec != std::errc() || end != id.data() + id.size()) {
+                std::cerr << "Error: --talkgroup expects a number, got " << id << "\n";
+                exit(1);
+            }
+            args.reenrichTalkgroup = talkgroup;
+        }},
+        {"--from", [&](const std::string& date){ args.reenrichFrom = date; }},
+        {"--to", [&](const std::string& date){ args.reenrichTo = date; }}
     };
 
     for (int i = 1; i < argc; i++) {
@@ -65,6 +85,13 @@ CommandLineArgs parseCommandLine(int argc, char* argv[]) {
             exit(1);
         }
     }
-    
+
+    // The filters only mean something to a re-enrichment run
+    if (!args.reenrichFlag && (args.reenrichTalkgroup || !args.reenrichFrom.empty() || !args.reenrichTo.empty())) {
+        std::cerr << "Error: --talkgroup, --from and --to require --reenrich\n";
+        printHelp();
+        exit(1);
+    }
+
     return args;
 }
\ No newline at end of file
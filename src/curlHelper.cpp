@@ -1,11 +1,16 @@
 // Standard Library Headers
+#include <algorithm>
 #include <chrono>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <deque>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <regex>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <thread>
@@ -15,12 +20,16 @@
 #include "../include/curlHelper.h"
 #include "../include/debugUtils.h"
 #include "../include/ConfigSingleton.h"
+#include "../include/RecordingFile.h"
 
 ConfigSingleton &config = ConfigSingleton::getInstance();
 const std::string API_URL = "https://api.openai.com/v1/audio/transcriptions";
 std::deque<std::chrono::steady_clock::time_point> requestTimestamps;
 std::deque<std::chrono::steady_clock::time_point> errorTimestamps;
 int apiErrorCount = 0;
+// Guards requestTimestamps/errorTimestamps; parallel workers and the
+// hybrid router read and update them concurrently
+std::mutex rateLimitMutex;
 
 // Callback function to write the CURL response to a string
 size_t WriteCallback(void *contents, size_t size, size_t nmemb, void *userp)
@@ -36,18 +45,47 @@ void setupCurlHeaders(CURL *curl, struct curl_slist *&headers, const std::string
     curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
 }
 
-// Setup CURL post fields
-void setupCurlPostFields(CURL *curl, curl_mime *&mime, const std::string &file_path, const std::string &prompt)
+// Streams an already open recording into the upload without copying it
+struct MimeUpload
 {
-    curl_mimepart *part;
-    mime = curl_mime_init(curl);
+    std::span<const unsigned char> data;
+    size_t offset = 0;
+};
 
-    // Add the file
-    part = curl_mime_addpart(mime);
-    curl_mime_name(part, "file");
-    curl_mime_filedata(part, file_path.c_str());
+static size_t readMimeUpload(char *buffer, size_t size, size_t nitems, void *arg)
+{
+    auto *upload = static_cast<MimeUpload *>(arg);
+    size_t count = std::min(size * nitems, upload->data.size() - upload->offset);
+    if (count == 0)
+    {
+        return 0;
+    }
+    std::memcpy(buffer, upload->data.data() + upload->offset, count);
+    upload->offset += count;
+    return count;
+}
+
+// Rewinds the upload when curl resends the body
+static int seekMimeUpload(void *arg, curl_off_t offset, int origin)
+{
+    auto *upload = static_cast<MimeUpload *>(arg);
+    if (origin != SEEK_SET || offset < 0 || static_cast<size_t>(offset) > upload->data.size())
+    {
+        return CURL_SEEKFUNC_CANTSEEK;
+    }
+    upload->offset = static_cast<size_t>(offset);
+    return CURL_SEEKFUNC_OK;
+}
+
+static void freeMimeUpload(void *arg)
+{
+    delete static_cast<MimeUpload *>(arg);
+}
 
-    // Add other data fields
+// Add the fields that accompany the file
+static void addTranscriptionFields(curl_mime *mime, const std::string &prompt)
+{
+    curl_mimepart *part;
     part = curl_mime_addpart(mime);
     curl_mime_name(part, "model");
     curl_mime_data(part, "whisper-1", CURL_ZERO_TERMINATED);
@@ -72,6 +110,34 @@ void setupCurlPostFields(CURL *curl, curl_mime *&mime, const std::string &file_p
     }
 }
 
+// Setup CURL post fields
+void setupCurlPostFields(CURL *curl, curl_mime *&mime, const std::string &file_path, const std::string &prompt)
+{
+    mime = curl_mime_init(curl);
+
+    // Add the file
+    curl_mimepart *part = curl_mime_addpart(mime);
+    curl_mime_name(part, "file");
+    curl_mime_filedata(part, file_path.c_str());
+
+    addTranscriptionFields(mime, prompt);
+}
+
+// Setup CURL post fields from a recording that is already open
+void setupCurlPostFields(CURL *curl, curl_mime *&mime, const sdrtrunk::RecordingFile &file, const std::string &prompt)
+{
+    mime = curl_mime_init(curl);
+
+    // The API needs the file name to recognize the format
+    curl_mimepart *part = curl_mime_addpart(mime);
+    curl_mime_name(part, "file");
+    curl_mime_filename(part, std::filesystem::path(file.path()).filename().string().c_str());
+    curl_mime_data_cb(part, static_cast<curl_off_t>(file.size()), readMimeUpload, seekMimeUpload, freeMimeUpload,
+                      new MimeUpload{file.bytes()});
+
+    addTranscriptionFields(mime, prompt);
+}
+
 // Make a CURL request and return the response
 std::string makeCurlRequest(CURL *curl, curl_mime *mime)
 {
@@ -113,41 +179,16 @@ bool containsApiError(const std::string &response)
     return false;
 }
 
-// Check file existence and readability
-void checkFileValidity(const std::string &file_path)
-{
-    // if (ConfigSingleton::getInstance().isDebugCurlHelper())
-    // {
-    //     std::cout << "[" << getCurrentTime() << "] curlHelper.cpp checkFileValidity Checking if file exists." << std::endl;
-    // }
-    if (!std::filesystem::exists(file_path))
-    {
-        throw std::runtime_error("[" + getCurrentTime() + "]" + " curlHelper.cpp checkFileValidity File does not exist: " + file_path);
-        std::cout.flush();
-    }
-
-    std::ifstream file(file_path);
-    // if (ConfigSingleton::getInstance().isDebugCurlHelper())
-    // {
-    //     std::cout << "[" << getCurrentTime() << "] curlHelper.cpp checkFileValidity Checking if file is readable." << std::endl;
-    // }
-    if (!file.good())
-    {
-        throw std::runtime_error("[" + getCurrentTime() + "]" + " curlHelper.cpp checkFileValidity Cannot read file: " + file_path);
-        std::cout.flush();
-    }
-    file.close();
-}
-
 // Handle rate limiting
 void handleRateLimiting()
 {
     std::chrono::seconds rateLimitWindow(config.getRateLimitWindowSeconds());
-    int maxRequestsPerMinute = config.getMaxRequestsPerMinute();
+    size_t maxRequestsPerMinute = static_cast<size_t>(config.getMaxRequestsPerMinute());
     // if (ConfigSingleton::getInstance().isDebugCurlHelper())
     // {
     //     std::cout << "[" << getCurrentTime() << "] curlHelper.cpp Entered handleRateLimiting" << std::endl;
     // }
+    std::unique_lock<std::mutex> lock(rateLimitMutex);
     auto now = std::chrono::steady_clock::now();
     // if (ConfigSingleton::getInstance().isDebugCurlHelper())
     // {
@@ -169,21 +210,58 @@ void handleRateLimiting()
     // {
     //     std::cout << "[" << getCurrentTime() << "] curlHelper.cpp handleRateLimiting maxRequestsPerMinute: " << maxRequestsPerMinute << std::endl;
     // }
-    if (requestTimestamps.size() >= maxRequestsPerMinute)
+    while (maxRequestsPerMinute > 0 && requestTimestamps.size() >= maxRequestsPerMinute)
     {
         auto sleep_duration = rateLimitWindow - (now - requestTimestamps.front());
         if (ConfigSingleton::getInstance().isDebugCurlHelper())
         {
             std::cout << "[" << getCurrentTime() << "] curlHelper.cpp handleRateLimiting requestTimestamps.size: " << requestTimestamps.size() << std::endl;
-            std::cout << "[" << getCurrentTime() << "] curlHelper.cpp handleRateLimiting Rate limit reached, sleeping for " << sleep_duration.count() << " seconds." << std::endl;
+            std::cout << "[" << getCurrentTime() << "] curlHelper.cpp handleRateLimiting Rate limit reached, sleeping for " << std::chrono::duration_cast<std::chrono::seconds>(sleep_duration).count() << " seconds." << std::endl;
         }
+        // Sleep without the lock so headroom queries are not blocked
+        lock.unlock();
         std::this_thread::sleep_for(sleep_duration);
+        lock.lock();
+        now = std::chrono::steady_clock::now();
+        while (!requestTimestamps.empty() && (now - requestTimestamps.front() > rateLimitWindow))
+        {
+            requestTimestamps.pop_front();
+        }
     }
+
+    // Record this request so the window reflects actual usage
+    requestTimestamps.push_back(now);
+}
+
+int remoteRequestHeadroom()
+{
+    std::chrono::seconds rateLimitWindow(config.getRateLimitWindowSeconds());
+    int maxRequestsPerMinute = config.getMaxRequestsPerMinute();
+    std::lock_guard<std::mutex> lock(rateLimitMutex);
+    auto now = std::chrono::steady_clock::now();
+    int used = 0;
+    for (auto it = requestTimestamps.rbegin(); it != requestTimestamps.rend() && now - *it <= rateLimitWindow; ++it)
+    {
+        ++used;
+    }
+    return maxRequestsPerMinute - used;
 }
 
 // Transcribe audio using CURL
 std::string curl_transcribe_audio(const std::string &file_path, const std::string &OPENAI_API_KEY, const std::string &prompt)
 {
+    auto file = sdrtrunk::RecordingFile::open(file_path);
+    if (!file.has_value())
+    {
+        throw std::runtime_error("[" + getCurrentTime() + "]" + " curlHelper.cpp curl_transcribe_audio " + file.error().toString());
+    }
+    return curl_transcribe_audio(file.value(), OPENAI_API_KEY, prompt);
+}
+
+// Transcribe an already open recording using CURL
+std::string curl_transcribe_audio(const sdrtrunk::RecordingFile &file, const std::string &OPENAI_API_KEY, const std::string &prompt)
+{
+    const std::string &file_path = file.path();
     int maxRetries = config.getMaxRetries();
     int maxRequestsPerMinute = config.getMaxRequestsPerMinute();
     // std::chrono::seconds errorWindow(config.getErrorWindowSeconds());
@@ -191,7 +269,6 @@ std::string curl_transcribe_audio(const std::string &file_path, const std::strin
     {
         std::cout << "[" << getCurrentTime() << "] curlHelper.cpp curl_transcribe_audio called with file path: " << file_path << std::endl;
     }
-    checkFileValidity(file_path);
     // if (ConfigSingleton::getInstance().isDebugCurlHelper())
     // {
     //     std::cout << "[" << getCurrentTime() << "] curlHelper.cpp curl_transcribe_audio Entering retry loop." << std::endl;
@@ -222,7 +299,7 @@ std::string curl_transcribe_audio(const std::string &file_path, const std::strin
             setupCurlHeaders(curl, headers, OPENAI_API_KEY);
 
             curl_mime *mime;
-            setupCurlPostFields(curl, mime, file_path, prompt);
+            setupCurlPostFields(curl, mime, file, prompt);
 
             curl_easy_setopt(curl, CURLOPT_URL, API_URL.c_str());
             curl_easy_setopt(curl, CURLOPT_MIMEPOST, mime);
@@ -250,6 +327,7 @@ std::string curl_transcribe_audio(const std::string &file_path, const std::strin
 
             if (containsApiError(response))
             {
+                std::lock_guard<std::mutex> lock(rateLimitMutex);
                 if (ConfigSingleton::getInstance().isDebugCurlHelper()) {
                     std::cout << "[" << getCurrentTime() << "] curlHelper.cpp curl_transcribe_audio API error detected in response." << std::endl;
                     std::cout << "[" << getCurrentTime() << "] curlHelper.cpp curl_transcribe_audio apiErrorCount: " << apiErrorCount << std::endl;
@@ -1,3 +1,4 @@
+#include <atomic>
 #include <iostream>
 #include <string>
 #include <filesystem>
@@ -6,11 +7,18 @@
 #include <thread>
 #include <chrono>
 #include <expected>
+#include <optional>
+#include <future>
 #include <mutex>
+#include "debugUtils.h"
+#include "fasterWhisper.h"
 #include "security.h"
+#include "MP3Duration.h"
+#include "PcmStream.h"
 
 #ifdef USE_PYBIND11
 #include <pybind11/embed.h>
+#include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 namespace py = pybind11;
 #else
@@ -37,6 +45,25 @@ std::string trim(const std::string &str)
     return (start == std::string::npos || end == std::string::npos) ? "" : str.substr(start, end - start + 1);
 }
 
+// Resolve the path handed to Python. A recording the pipeline already
+// opened has passed Security::isPathSafe() and is used as is; anything
+// else must exist and is canonicalized to prevent directory traversal.
+static std::expected<std::filesystem::path, std::string> resolve_input_path(const std::string &mp3FilePath,
+                                                                            const LocalTranscribeOptions &options)
+{
+    if (options.file) {
+        return std::filesystem::path(options.file->path());
+    }
+    if (!std::filesystem::exists(mp3FilePath)) {
+        return std::unexpected("Input file does not exist: " + mp3FilePath);
+    }
+    try {
+        return std::filesystem::canonical(mp3FilePath);
+    } catch (const std::filesystem::filesystem_error& e) {
+        return std::unexpected("Failed to get canonical path: " + std::string(e.what()));
+    }
+}
+
 #ifdef USE_PYBIND11
 
 // Global Python interpreter guard - initialized once
@@ -45,7 +72,7 @@ static std::unique_ptr<py::scoped_interpreter> python_guard;
 static std::unique_ptr<py::gil_scoped_release> gil_release;
 static py::module_ faster_whisper_module;
 static std::once_flag python_init_flag;
-static bool python_initialized = false;
+static std::atomic<bool> python_initialized{false};
 // Serialize all Python transcription calls — ctranslate2 releases the GIL
 // during CUDA operations, so the GIL alone is insufficient for thread safety
 static std::mutex transcribe_mutex;
@@ -54,8 +81,9 @@ void initialize_python_if_needed()
 {
     std::call_once(python_init_flag, []() {
         try {
-            // Initialize Python interpreter (acquires GIL)
-            python_guard = std::make_unique<py::scoped_interpreter>();
+            // Initialize Python interpreter (acquires GIL). Python's signal
+            // handlers are skipped so SIGINT/SIGTERM keep reaching main.cpp
+            python_guard = std::make_unique<py::scoped_interpreter>(false);
 
             // Scope Python objects so they're destroyed while GIL is held
             {
@@ -96,25 +124,109 @@ void initialize_python_if_needed()
     });
 }
 
-std::expected<std::string, std::string> local_transcribe_audio(const std::string &mp3FilePath)
+// Model warm-up runs once on a background thread; local transcriptions wait
+// on this future instead of paying interpreter start + model load inline
+static std::once_flag warmup_flag;
+static std::shared_future<std::string> model_ready;
+
+void start_model_warmup(const std::string& draftModel)
 {
-    // Validate the input file path
-    if (!std::filesystem::exists(mp3FilePath)) {
-        return std::unexpected("Input file does not exist: " + mp3FilePath);
+    std::call_once(warmup_flag, [draftModel]() {
+        model_ready = std::async(std::launch::async, [draftModel]() -> std::string {
+            auto start = std::chrono::steady_clock::now();
+            try {
+                initialize_python_if_needed();
+                {
+                    py::gil_scoped_acquire acquire;
+                    faster_whisper_module.attr("get_model")();
+                    // Every tiered recording is drafted with this model
+                    if (!draftModel.empty()) {
+                        faster_whisper_module.attr("get_model")(draftModel);
+                    }
+                }
+            } catch (const py::error_already_set& e) {
+                return "Failed to load Whisper model: " + std::string(e.what());
+            } catch (const std::exception& e) {
+                return e.what();
+            }
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start);
+            std::cout << "[" << getCurrentTime() << "] "
+                      << "fasterWhisper.cpp start_model_warmup Local model ready in "
+                      << elapsed.count() << " ms" << std::endl;
+            return {};
+        }).share();
+    });
+}
+
+std::expected<void, std::string> wait_for_model_ready()
+{
+    start_model_warmup();
+    const std::string &error = model_ready.get();
+    if (!error.empty()) {
+        return std::unexpected(error);
     }
-    
-    // Get canonical path to prevent directory traversal
-    std::filesystem::path safePath;
-    try {
-        safePath = std::filesystem::canonical(mp3FilePath);
-    } catch (const std::filesystem::filesystem_error& e) {
-        return std::unexpected("Failed to get canonical path: " + std::string(e.what()));
+    return {};
+}
+
+// Wrap decoded PCM in a numpy array without copying. The capsule takes
+// ownership of the sample vector and frees it when Python drops the array.
+// Must be called with the GIL held.
+static py::array_t<float> to_numpy(sdrtrunk::PcmBuffer &&pcm)
+{
+    auto *samples = new std::vector<float>(std::move(pcm.samples));
+    py::capsule owner(samples, [](void *p) { delete static_cast<std::vector<float> *>(p); });
+    return py::array_t<float>({static_cast<py::ssize_t>(samples->size())},
+                              {static_cast<py::ssize_t>(sizeof(float))},
+                              samples->data(), owner);
+}
+
+// Read-only numpy view of samples decoded earlier in the pipeline, which
+// the caller keeps alive until local_transcribe_audio() returns. The
+// module's transcribe() is done with its input by then. The no-op capsule
+// base makes pybind11 reference the samples instead of copying them.
+// Must be called with the GIL held.
+static py::array_t<float> borrow_numpy(const sdrtrunk::PcmBuffer &pcm)
+{
+    py::capsule base(pcm.samples.data(), [](void *) {});
+    py::array_t<float> view({static_cast<py::ssize_t>(pcm.samples.size())},
+                            {static_cast<py::ssize_t>(sizeof(float))},
+                            pcm.samples.data(), base);
+    view.attr("setflags")(false);
+    return view;
+}
+
+std::expected<std::string, std::string> local_transcribe_audio(const std::string &mp3FilePath,
+                                                               const LocalTranscribeOptions &options)
+{
+    auto resolved = resolve_input_path(mp3FilePath, options);
+    if (!resolved.has_value()) {
+        return std::unexpected(resolved.error());
+    }
+    const std::filesystem::path &safePath = resolved.value();
+
+    // Decode once in C++, outside the GIL and the model lock, so Python gets
+    // 16 kHz mono float32 samples instead of re-opening and decoding the file.
+    // Samples decoded earlier in the pipeline are lent to Python as they are;
+    // a decode here holds its size against the process decode budget until
+    // this call returns.
+    std::optional<sdrtrunk::Result<sdrtrunk::BudgetedPcm>> pcm;
+    if (!options.pcm) {
+        pcm = options.file ? sdrtrunk::decodeWithinBudget(*options.file)
+                           : sdrtrunk::decodeWithinBudget(safePath.string());
+        if (!pcm->has_value()) {
+            std::cerr << "fasterWhisper.cpp local_transcribe_audio C++ decode failed, passing path to Python: "
+                      << pcm->error().toString() << std::endl;
+        }
     }
-    
-    try {
-        // Ensure Python is initialized
-        initialize_python_if_needed();
 
+    // Hold until the background warm-up has loaded the model
+    auto ready = wait_for_model_ready();
+    if (!ready.has_value()) {
+        return std::unexpected(ready.error());
+    }
+
+    try {
         // Serialize transcription calls — ctranslate2 releases the GIL during
         // CUDA ops, so concurrent Python transcribe() calls race on model state
         std::lock_guard<std::mutex> lock(transcribe_mutex);
@@ -122,8 +234,25 @@ std::expected<std::string, std::string> local_transcribe_audio(const std::string
         // Acquire GIL for thread safety
         py::gil_scoped_acquire acquire;
 
-        // Call the transcribe function from the Python module
-        py::object result = faster_whisper_module.attr("transcribe")(safePath.string());
+        py::object audio = options.pcm        ? py::object(borrow_numpy(*options.pcm))
+                           : pcm->has_value() ? py::object(to_numpy(std::move(pcm->value().pcm)))
+                                              : py::object(py::str(safePath.string()));
+
+        // Call the transcribe function from the Python module; unset
+        // keyword arguments fall back to the module constants
+        py::dict kwargs;
+        if (!options.model.empty()) {
+            kwargs["model_size"] = options.model;
+        }
+        if (options.profile) {
+            kwargs["beam_size"] = options.profile->beamSize;
+            kwargs["patience"] = options.profile->patience;
+            kwargs["best_of"] = options.profile->bestOf;
+            kwargs["temperature"] = options.profile->temperature;
+            kwargs["vad_threshold"] = options.profile->vadThreshold;
+            kwargs["min_silence_duration_ms"] = options.profile->minSilenceDurationMs;
+        }
+        py::object result = faster_whisper_module.attr("transcribe")(audio, **kwargs);
 
         // Convert result to string
         std::string transcription = py::str(result);
@@ -162,25 +291,40 @@ void cleanup_python()
 
 #else
 
+// The subprocess fallback loads the model per invocation; nothing to warm up
+void start_model_warmup(const std::string&)
+{
+}
+
+std::expected<void, std::string> wait_for_model_ready()
+{
+    return {};
+}
+
 // Fallback implementation using process execution
-std::expected<std::string, std::string> local_transcribe_audio(const std::string &mp3FilePath)
+std::expected<std::string, std::string> local_transcribe_audio(const std::string &mp3FilePath,
+                                                               const LocalTranscribeOptions &options)
 {
-    // Validate the input file path
-    if (!std::filesystem::exists(mp3FilePath)) {
-        return std::unexpected("Input file does not exist: " + mp3FilePath);
+    auto resolved = resolve_input_path(mp3FilePath, options);
+    if (!resolved.has_value()) {
+        return std::unexpected(resolved.error());
     }
-    
-    // Get canonical path to prevent directory traversal
-    std::filesystem::path safePath;
-    try {
-        safePath = std::filesystem::canonical(mp3FilePath);
-    } catch (const std::filesystem::filesystem_error& e) {
-        return std::unexpected("Failed to get canonical path: " + std::string(e.what()));
-    }
-    
+    const std::filesystem::path &safePath = resolved.value();
+
     // Use escaped shell argument for safety
     std::string escapedPath = Security::escapeShellArg(safePath.string());
     std::string command = "python fasterWhisper.py " + escapedPath;
+    if (!options.model.empty()) {
+        command += " " + Security::escapeShellArg(options.model);
+    }
+    if (options.profile) {
+        command += " --beam-size " + std::to_string(options.profile->beamSize) +
+                   " --patience " + std::to_string(options.profile->patience) +
+                   " --best-of " + std::to_string(options.profile->bestOf) +
+                   " --temperature " + std::to_string(options.profile->temperature) +
+                   " --vad-threshold " + std::to_string(options.profile->vadThreshold) +
+                   " --min-silence-duration-ms " + std::to_string(options.profile->minSilenceDurationMs);
+    }
 
     std::array<char, 128> buffer;
     std::string result;
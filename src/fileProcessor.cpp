@@ -6,10 +6,12 @@
 #include <cstdio>
 #include <ctime>
 #include <fstream>
+#include <future>
 #include <iostream>
 #include <iomanip>
 #include <memory>
-#include <regex>
+#include <mutex>
+#include <optional>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -26,16 +28,27 @@
 #endif
 
 // Project-Specific Headers
+#include "../include/AudioFingerprint.h"
+#include "../include/ChunkedBackend.h"
 #include "../include/ConfigSingleton.h"
 #include "../include/curlHelper.h"
+#include "../include/DatabaseManager.h"
 #include "../include/debugUtils.h"
 #include "../include/FileData.h"
 #include "../include/fileProcessor.h"
 #include "../include/globalFlags.h"
 #include "../include/MP3Duration.h"
+#include "../include/PcmStream.h"
+#include "../include/RecordingFile.h"
+#include "../include/RecordingTime.h"
+#include "../include/SdrTrunkFilename.h"
 #include "../include/Result.h"
 #include "../include/transcriptionProcessor.h"
 #include "../include/fasterWhisper.h"
+#include "../include/TieredBackend.h"
+#include "../include/TranscriptionRouter.h"
+#include "../include/VoiceActivity.h"
+#include "../include/WhisperCppBackend.h"
 
 bool isFileBeingWrittenTo(const std::string &filePath)
 {
@@ -46,6 +59,12 @@ bool isFileBeingWrittenTo(const std::string &filePath)
     return size1 != size2;
 }
 
+bool isFileBeingWrittenTo(const sdrtrunk::RecordingFile &file)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(500)); // Wait for 500 ms
+    return file.hasGrown();
+}
+
 bool isFileLocked(const std::string &filePath)
 {
     return std::filesystem::exists(filePath + ".lock");
@@ -80,17 +99,34 @@ void find_and_move_mp3_without_txt(const std::string &directoryToMonitor)
     }
 }
 
-// Using libmpg123 for accurate MP3 duration extraction
-std::string getMP3Duration(const std::string &mp3FilePath)
+// Using libmpg123 for accurate MP3 duration extraction. Files already
+// probed, unchanged since, are answered from the audio_metadata table.
+static std::string getMP3Duration(const sdrtrunk::RecordingFile &file, DatabaseManager *db)
 {
-    // Use libmpg123 for sample-accurate duration with gapless support
-    auto result = sdrtrunk::getMP3Duration(mp3FilePath);
-
-    if (result.has_value()) {
+    auto formatDuration = [](double seconds) {
         // Return duration as string with 6 decimal places to match ffprobe format
         char buffer[32];
-        snprintf(buffer, sizeof(buffer), "%.6f", result.value());
+        snprintf(buffer, sizeof(buffer), "%.6f", seconds);
         return std::string(buffer);
+    };
+
+    if (db)
+    {
+        if (auto cached = db->findAudioMetadata(file.identity()))
+        {
+            return formatDuration(cached->durationSeconds);
+        }
+    }
+
+    // Use libmpg123 for sample-accurate duration with gapless support
+    auto result = sdrtrunk::probeMP3Metadata(file);
+
+    if (result.has_value()) {
+        if (db)
+        {
+            db->storeAudioMetadata(file.identity(), result.value());
+        }
+        return formatDuration(result->durationSeconds);
     }
 
     // Log error if debug enabled
@@ -252,26 +288,23 @@ std::string getMP3DurationLegacy(const std::string &mp3FilePath)
     return "";  // Should never reach here, but ensures all paths return
 }
 
+// Local recording time as unix seconds; 0 when the fields do not parse
 int64_t generateUnixTimestamp(const std::string &date, const std::string &time)
 {
-    std::tm tm = {};
-    std::string dateTime = date + time;
-    std::istringstream ss(dateTime);
-    ss >> std::get_time(&tm, "%Y%m%d%H%M%S"); // Parse the combined string
-    auto tp = std::chrono::system_clock::from_time_t(std::mktime(&tm));
-    return std::chrono::duration_cast<std::chrono::seconds>(tp.time_since_epoch()).count();
+    return sdrtrunk::recordingUnixTime(date, time).value_or(0);
 }
 
 // Checks if the file should be skipped
-bool skipFile(const std::string &file_path)
+static bool skipFile(const sdrtrunk::RecordingFile &file)
 {
-    return isFileBeingWrittenTo(file_path) || isFileLocked(file_path);
+    return isFileBeingWrittenTo(file) || isFileLocked(file.path());
 }
 
 // Validates the duration of the MP3 file
-float validateDuration(const std::string &file_path, FileData &fileData)
+static float validateDuration(const sdrtrunk::RecordingFile &file, FileData &fileData, DatabaseManager *db)
 {
-    std::string durationStr = getMP3Duration(file_path);
+    const std::string &file_path = file.path();
+    std::string durationStr = ::getMP3Duration(file, db);
     if (ConfigSingleton::getInstance().isDebugFileProcessor())
     {
         std::cout << "[" << getCurrentTime() << "] "
@@ -339,148 +372,247 @@ float validateDuration(const std::string &file_path, FileData &fileData)
 //   P-group multi _:    __TO_P52197_[52198__52199]...        -> 52198
 int extractTalkgroupIdFromFilename(const std::string &filename)
 {
-    std::smatch match;
+    return sdrtrunk::parseSdrTrunkFilename(filename).talkgroup.value_or(0);
+}
 
-    if (filename.find("TO_P") != std::string::npos)
-    {
-        // P-group with brackets: extract first number inside [ ]
-        // Matches [52198] and [52198--51426] and [52198__52199] alike
-        std::regex rgx_bracket("\\[(\\d+)");
-        if (std::regex_search(filename, match, rgx_bracket) && match.size() > 1)
-        {
-            return std::stoi(match[1].str());
-        }
+// Transcribes the audio file
+std::string transcribeAudio(const std::string &file_path, const std::string &OPENAI_API_KEY, const std::string &prompt = "")
+{
+    return curl_transcribe_audio(file_path, OPENAI_API_KEY, prompt);
+}
 
-        // P-group without brackets: TO_P52197 or legacy TO_P_52198
-        std::regex rgx_talkgroup_P("TO_P_?(\\d+)");
-        if (std::regex_search(filename, match, rgx_talkgroup_P) && match.size() > 1)
-        {
-            return std::stoi(match[1].str());
+// Load a whisper.cpp model; null (and logged) if it cannot be loaded
+static std::shared_ptr<sdrtrunk::WhisperCppBackend> loadWhisperCppBackend(const std::string &modelPath, int beamSize)
+{
+    sdrtrunk::WhisperCppConfig whisperConfig;
+    whisperConfig.modelPath = modelPath;
+    whisperConfig.threads = ConfigSingleton::getInstance().getWhisperCppThreads();
+    whisperConfig.beamSize = beamSize;
+    auto created = sdrtrunk::WhisperCppBackend::create(whisperConfig);
+    if (!created.has_value()) {
+        std::cerr << "[" << getCurrentTime() << "] "
+                  << "fileProcessor.cpp loadWhisperCppBackend " << created.error().toString() << std::endl;
+        return nullptr;
+    }
+    return std::move(created.value());
+}
+
+// Local engine selected by LOCAL_BACKEND, wrapped in a draft/full
+// TieredBackend when TIERED_TRANSCRIPTION is on
+static std::shared_ptr<sdrtrunk::TranscriptionBackend> makeEngineBackend()
+{
+    const auto &config = ConfigSingleton::getInstance();
+    std::shared_ptr<sdrtrunk::TranscriptionBackend> full;
+    std::shared_ptr<sdrtrunk::TranscriptionBackend> draft;
+    if (config.getLocalBackend() == "whisper.cpp") {
+        full = loadWhisperCppBackend(config.getWhisperCppModelPath(), sdrtrunk::WhisperCppConfig{}.beamSize);
+        if (config.isTieredTranscription() && !config.getWhisperCppDraftModelPath().empty()) {
+            draft = loadWhisperCppBackend(config.getWhisperCppDraftModelPath(), 1);
+        }
+    } else {
+        full = std::make_shared<sdrtrunk::FasterWhisperBackend>();
+        if (config.isTieredTranscription() && !config.getTierDraftModel().empty()) {
+            draft = std::make_shared<sdrtrunk::FasterWhisperBackend>(config.getTierDraftModel());
         }
     }
+    if (!full || !draft) {
+        return full;
+    }
+    return std::make_shared<sdrtrunk::TieredBackend>(draft, full, config.getTierThresholds());
+}
 
-    // Standard: TO_digits (also handles _V2 suffix since \d+ stops at _)
-    std::regex rgx_talkgroup("TO_(\\d+)");
-    if (std::regex_search(filename, match, rgx_talkgroup) && match.size() > 1)
-    {
-        return std::stoi(match[1].str());
+// Local backend wrapped in a ChunkedBackend when the engine takes PCM:
+// recordings of at least CHUNK_THRESHOLD_SECONDS are split into parallel
+// chunks if the engine runs calls in parallel, and recordings too large
+// to decode whole under DECODE_MEMORY_CAP_MB are always streamed
+static std::shared_ptr<sdrtrunk::TranscriptionBackend> makeLocalBackend()
+{
+    auto engine = makeEngineBackend();
+    if (!engine) {
+        return engine;
     }
+    const auto &chunking = ConfigSingleton::getInstance().getChunkingConfig();
+    if (!engine->consumesPcm()) {
+        if (chunking.thresholdSeconds > 0.0) {
+            std::cerr << "[" << getCurrentTime() << "] "
+                      << "fileProcessor.cpp makeLocalBackend " << engine->name()
+                      << " reads whole files; CHUNK_THRESHOLD_SECONDS is ignored" << std::endl;
+        }
+        return engine;
+    }
+    if (chunking.thresholdSeconds > 0.0 && !engine->transcribesConcurrently()) {
+        std::cerr << "[" << getCurrentTime() << "] "
+                  << "fileProcessor.cpp makeLocalBackend " << engine->name()
+                  << " transcribes one call at a time; CHUNK_THRESHOLD_SECONDS is ignored" << std::endl;
+    }
+    return std::make_shared<sdrtrunk::ChunkedBackend>(engine, chunking);
+}
 
-    return 0;
+// Local backend, built on first use and shared by all pool workers;
+// null if the model could not be loaded
+static std::shared_ptr<sdrtrunk::TranscriptionBackend> getLocalBackend()
+{
+    static const std::shared_ptr<sdrtrunk::TranscriptionBackend> backend = makeLocalBackend();
+    return backend;
 }
 
-// Transcribes the audio file
-std::string transcribeAudio(const std::string &file_path, const std::string &OPENAI_API_KEY, const std::string &prompt = "")
+// Backend warm-up runs once on a background thread; workers reaching
+// getLocalBackend() first wait on its static instead of loading inline
+static std::once_flag localWarmupFlag;
+static std::shared_future<void> localBackendReady;
+
+void startLocalBackendWarmup()
 {
-    return curl_transcribe_audio(file_path, OPENAI_API_KEY, prompt);
+    std::call_once(localWarmupFlag, []() {
+        localBackendReady = std::async(std::launch::async, []() {
+            auto start = std::chrono::steady_clock::now();
+            if (!getLocalBackend()) {
+                std::cerr << "[" << getCurrentTime() << "] "
+                          << "fileProcessor.cpp startLocalBackendWarmup Local backend failed to load" << std::endl;
+                return;
+            }
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start);
+            std::cout << "[" << getCurrentTime() << "] "
+                      << "fileProcessor.cpp startLocalBackendWarmup Local model ready in "
+                      << elapsed.count() << " ms" << std::endl;
+        }).share();
+    });
 }
 
-// Transcribe the audio file locally with whisper.cpp
-std::string transcribeAudioLocal(const std::string &file_path)
+// Hybrid router, built once so its in-flight accounting spans all workers
+static sdrtrunk::TranscriptionRouter &getTranscriptionRouter(const std::string &OPENAI_API_KEY)
 {
-    auto result = local_transcribe_audio(file_path);
-    if (result.has_value()) {
-        return result.value();
-    } else {
-        std::cerr << "[ERROR] Failed to transcribe " << file_path << ": " << result.error() << std::endl;
-        return "";  // Return empty string on error
-    }
+    static std::unique_ptr<sdrtrunk::TranscriptionRouter> router;
+    static std::once_flag buildFlag;
+    std::call_once(buildFlag, [&OPENAI_API_KEY]() {
+        router = std::make_unique<sdrtrunk::TranscriptionRouter>(
+            getLocalBackend(),
+            std::make_shared<sdrtrunk::OpenAIBackend>(OPENAI_API_KEY),
+            ConfigSingleton::getInstance().getRoutingRules(),
+            remoteRequestHeadroom);
+    });
+    return *router;
 }
 
-// Extracts information from the filename and transcription
-void extractFileInfo(FileData &fileData, const std::string &filename, const std::string &transcription)
+// Transcribe through the hybrid router when HYBRID_ROUTING is enabled,
+// otherwise with the backend chosen by --local
+static std::string transcribeRecording(const sdrtrunk::TranscriptionRequest &request, const std::string &OPENAI_API_KEY)
 {
-    std::smatch match;
-    std::string talkgroupID, radioID;
-    int defaultID = 1234567; // Default integer value for NBFM usage
+    if (ConfigSingleton::getInstance().isHybridRouting()) {
+        auto result = getTranscriptionRouter(OPENAI_API_KEY).transcribe(request);
+        if (result.has_value()) {
+            return result.value();
+        }
+        std::cerr << "[ERROR] Failed to transcribe " << request.filePath << ": " << result.error().toString() << std::endl;
+        return "";
+    }
+    if (gLocalFlag) {
+        auto backend = getLocalBackend();
+        if (!backend) {
+            std::cerr << "[ERROR] Failed to transcribe " << request.filePath << ": local backend unavailable" << std::endl;
+            return "";
+        }
+        auto result = backend->transcribe(request);
+        if (result.has_value()) {
+            return result.value();
+        }
+        std::cerr << "[ERROR] Failed to transcribe " << request.filePath << ": " << result.error().toString() << std::endl;
+        return "";
+    }
+    if (request.file) {
+        return curl_transcribe_audio(*request.file, OPENAI_API_KEY, request.prompt);
+    }
+    return transcribeAudio(request.filePath, OPENAI_API_KEY, request.prompt);
+}
 
-    // Regular expression for radioID
-    std::regex rgx_radio("_FROM_(\\d+)");
+bool streamsRecording(const sdrtrunk::TranscriptionBackend *localBackend, double durationSeconds)
+{
+    return sdrtrunk::exceedsDecodeBudget(durationSeconds) ||
+           (localBackend && localBackend->streamsRecording(durationSeconds));
+}
 
-    // Extract talkgroup ID — handle all SDRTrunk P-group variants
-    bool tgFound = false;
-    if (filename.find("TO_P") != std::string::npos)
+// Voice activity of a long recording, decoded one PcmStream block at a
+// time instead of whole
+static sdrtrunk::Result<sdrtrunk::VadResult> streamVoiceActivity(const sdrtrunk::RecordingFile &recording, const sdrtrunk::VadConfig &config)
+{
+    auto stream = sdrtrunk::PcmStream::open(recording);
+    if (!stream.has_value())
     {
-        // P-group with brackets: first number inside [ ] is the primary talkgroup
-        // Handles [52198], [52198--51426--56881], [52198__52199]
-        std::regex rgx_bracket("\\[(\\d+)");
-        if (std::regex_search(filename, match, rgx_bracket) && match.size() > 1)
-        {
-            talkgroupID = match[1].str();
-            tgFound = true;
-        }
-        else
-        {
-            // P-group without brackets: TO_P52197 or legacy TO_P_52198
-            std::regex rgx_talkgroup_P("TO_P_?(\\d+)");
-            if (std::regex_search(filename, match, rgx_talkgroup_P) && match.size() > 1)
-            {
-                talkgroupID = match[1].str();
-                tgFound = true;
-            }
-        }
+        return std::unexpected(stream.error());
     }
-    if (!tgFound)
+    auto reservation = sdrtrunk::DecodeMemoryBudget::instance().reserve(sdrtrunk::PcmStream::workingSetBytes());
+    sdrtrunk::VadResult total;
+    for (;;)
     {
-        // Standard: TO_digits (handles _V2 suffix since \d+ stops at _)
-        std::regex rgx_talkgroup("TO_(\\d+)");
-        if (std::regex_search(filename, match, rgx_talkgroup) && match.size() > 1)
+        auto block = stream->next();
+        if (!block.has_value())
         {
-            talkgroupID = match[1].str();
+            return std::unexpected(block.error());
         }
-        else
+        if (block->empty())
         {
-            talkgroupID = std::to_string(defaultID);
+            return total;
         }
+        auto result = sdrtrunk::analyzeVoiceActivity(block.value(), config);
+        total.frames += result.frames;
+        total.speechFrames += result.speechFrames;
     }
+}
 
-    // Use a single regex search for radioID
-    if (std::regex_search(filename, match, rgx_radio) && match.size() > 1)
-    {
-        radioID = match[1].str();
-    }
-    else
+// Transcription of a recently stored recording with the same audio, e.g.
+// the same call from another simulcast site or a patched talkgroup
+static std::optional<StoredFingerprint> findDuplicateRecording(DatabaseManager &db, const sdrtrunk::AudioFingerprint &fingerprint, int64_t unixtime)
+{
+    const auto &config = ConfigSingleton::getInstance().getFingerprintConfig();
+    for (auto &candidate : db.findFingerprintsNear(unixtime, config.windowSeconds))
     {
-        radioID = std::to_string(defaultID); // Set to default value
-    }
-    // Extract variables from filename
-    std::string date = filename.substr(0, 8);
-    std::string time = filename.substr(9, 6);
-
-    // Extract talkgroup name: text between timestamp (pos 15) and "__TO_"
-    // New SDRTrunk format has underscore separator: 20260208_121343_Name
-    // Old format runs name directly after time:      20250715_112349Name
-    std::string talkgroupName;
-    auto toPos = filename.find("__TO_");
-    if (toPos != std::string::npos && toPos > 15) {
-        size_t nameStart = 15;
-        // Skip leading underscore separator if present
-        if (nameStart < filename.size() && filename[nameStart] == '_') {
-            nameStart++;
-        }
-        if (nameStart < toPos) {
-            talkgroupName = filename.substr(nameStart, toPos - nameStart);
+        auto stored = sdrtrunk::AudioFingerprint::deserialize(candidate.fingerprint);
+        if (sdrtrunk::isNearDuplicate(fingerprint, stored, config))
+        {
+            return std::move(candidate);
         }
     }
+    return std::nullopt;
+}
+
+// Extracts information from the filename and transcription
+void extractFileInfo(FileData &fileData, const std::string &filename, const std::string &transcription)
+{
+    extractFileInfo(fileData, sdrtrunk::parseSdrTrunkFilename(filename), transcription);
+}
+
+void extractFileInfo(FileData &fileData, const sdrtrunk::SdrTrunkFilename &parsed, const std::string &transcription)
+{
+    int defaultID = 1234567; // Default integer value for NBFM usage
+    const int talkgroupID = parsed.talkgroup.value_or(defaultID);
+    const int radioID = parsed.radioId.value_or(defaultID);
+    const std::string date(parsed.date);
+    const std::string time(parsed.time);
 
     std::cout << "[" << getCurrentTime() << "] "
               << "fileProcessor.cpp extractFileInfo RID: " << radioID << std::endl;
     std::cout << "[" << getCurrentTime() << "] "
               << "fileProcessor.cpp extractFileInfo TGID: " << talkgroupID << std::endl;
-    fileData.radioID = RadioId(std::stoi(radioID));
-    fileData.talkgroupID = TalkgroupId(std::stoi(talkgroupID));
-    fileData.talkgroupName = talkgroupName;
+    fileData.radioID = RadioId(radioID);
+    fileData.talkgroupID = TalkgroupId(talkgroupID);
+    fileData.talkgroups = sdrtrunk::recordingTalkgroups(parsed);
+    fileData.talkgroupName = std::string(parsed.name);
     fileData.date = date;
     fileData.time = time;
-    // Parse timestamp properly
-    std::tm tm = {};
-    std::istringstream ss(date + time);
-    ss >> std::get_time(&tm, "%Y%m%d%H%M%S");
-    fileData.timestamp = std::chrono::system_clock::from_time_t(std::mktime(&tm));
-    fileData.filename = FilePath(std::filesystem::path(filename));
+    fileData.timestamp = std::chrono::system_clock::time_point(
+        std::chrono::seconds(sdrtrunk::recordingUnixTime(parsed.date, parsed.time).value_or(0)));
+    fileData.filename = FilePath(std::filesystem::path(parsed.filename));
     fileData.transcription = Transcription(transcription);
 
-    // Retrieve the talkgroupFiles map from ConfigSingleton
+    // Recordings dropped before transcription have nothing to post-process
+    if (!fileData.skipReason.empty())
+    {
+        fileData.v2transcription = Transcription(std::string());
+        return;
+    }
+
+    // Retrieve the talkgroup profiles from ConfigSingleton
     const auto &talkgroupFiles = ConfigSingleton::getInstance().getTalkgroupFiles();
     fileData.v2transcription = Transcription(generateV2Transcription(
         transcription,
@@ -533,7 +665,7 @@ void moveFiles(const FileData &fileData, const std::string &directoryToMonitor)
 }
 
 // The refactored processFile function
-FileData processFile(const std::filesystem::path &path, const std::string &directoryToMonitor, const std::string &OPENAI_API_KEY)
+FileData processFile(const std::filesystem::path &path, const std::string &directoryToMonitor, const std::string &OPENAI_API_KEY, DatabaseManager *db)
 {
     try
     {
@@ -552,8 +684,17 @@ FileData processFile(const std::filesystem::path &path, const std::string &direc
             std::cout << "[" << getCurrentTime() << "] "
                       << "fileProcessor.cpp processFile Processing file: " << file_path << std::endl;
         }
-        bool shouldSkip = skipFile(file_path);
-        float duration = validateDuration(file_path, fileData);
+
+        // Opened once; every stage below reads this mapping
+        auto recording = sdrtrunk::RecordingFile::open(file_path);
+        if (!recording.has_value())
+        {
+            std::cerr << "[" << getCurrentTime() << "] "
+                      << "fileProcessor.cpp processFile " << recording.error().toString() << std::endl;
+            return FileData();
+        }
+        bool shouldSkip = skipFile(recording.value());
+        float duration = validateDuration(recording.value(), fileData, db);
         if (ConfigSingleton::getInstance().isDebugFileProcessor())
         {
             std::cout << "[" << getCurrentTime() << "] "
@@ -573,30 +714,141 @@ FileData processFile(const std::filesystem::path &path, const std::string &direc
         }
         fileData.filepath = FilePath(std::filesystem::path(file_path));
 
-        // Look up per-talkgroup prompt before transcription
+        // Parsed once; every stage below reads these fields
+        const std::string filename = path.filename().string();
+        const sdrtrunk::SdrTrunkFilename parsedName = sdrtrunk::parseSdrTrunkFilename(filename);
+
+        // Look up per-talkgroup prompt and decode profile before transcription
         std::string prompt;
-        int tgId = extractTalkgroupIdFromFilename(path.filename().string());
+        const sdrtrunk::DecodeProfile *decodeProfile = nullptr;
+        int tgId = parsedName.talkgroup.value_or(0);
         if (tgId > 0) {
-            auto it = ConfigSingleton::getInstance().getTalkgroupFiles().find(tgId);
-            if (it != ConfigSingleton::getInstance().getTalkgroupFiles().end()) {
-                prompt = it->second.prompt;
+            if (const auto *files = ConfigSingleton::getInstance().getTalkgroupFiles().lookup(tgId)) {
+                prompt = files->prompt;
+                if (files->decodeProfile) {
+                    decodeProfile = &*files->decodeProfile;
+                }
+            }
+        }
+
+        // Recordings the local backend will stream in chunks, or too large
+        // to decode whole under the cap, are only ever streamed; whole
+        // decodes hold their size against the process decode budget for as
+        // long as the samples are kept
+        std::shared_ptr<sdrtrunk::TranscriptionBackend> localBackend;
+        if (gLocalFlag || ConfigSingleton::getInstance().isHybridRouting())
+        {
+            localBackend = getLocalBackend();
+        }
+        const bool streamed = streamsRecording(localBackend.get(), duration);
+        sdrtrunk::DecodeMemoryBudget::Reservation pcmReservation;
+        auto decodeWhole = [&]() -> sdrtrunk::Result<sdrtrunk::PcmBuffer> {
+            auto decoded = sdrtrunk::decodeWithinBudget(recording.value(), duration);
+            if (!decoded.has_value())
+            {
+                return std::unexpected(decoded.error());
+            }
+            pcmReservation = std::move(decoded->reservation);
+            return std::move(decoded->pcm);
+        };
+
+        // Drop key-ups, dead air and encrypted noise before they cost a
+        // transcription. Decode failures fail open and transcribe as usual.
+        sdrtrunk::PcmBuffer pcm;
+        bool havePcm = false;
+        if (ConfigSingleton::getInstance().isVadEnabled())
+        {
+            const auto &vadConfig = ConfigSingleton::getInstance().getVadConfig();
+            sdrtrunk::Result<sdrtrunk::VadResult> vad;
+            if (streamed)
+            {
+                vad = streamVoiceActivity(recording.value(), vadConfig);
+            }
+            else if (auto decoded = decodeWhole(); decoded.has_value())
+            {
+                pcm = std::move(decoded.value());
+                havePcm = true;
+                vad = sdrtrunk::analyzeVoiceActivity(pcm.samples, vadConfig);
+            }
+            else
+            {
+                vad = std::unexpected(decoded.error());
+            }
+            if (vad.has_value())
+            {
+                fileData.speechRatio = vad->speechRatio();
+                if (fileData.speechRatio < vadConfig.minSpeechRatio)
+                {
+                    std::cout << "[" << getCurrentTime() << "] "
+                              << "fileProcessor.cpp processFile VAD skipped " << filename
+                              << " speech ratio " << fileData.speechRatio << std::endl;
+                    fileData.skipReason = "vad";
+                    extractFileInfo(fileData, parsedName, "");
+                    moveFiles(fileData, directoryToMonitor);
+                    return fileData;
+                }
+            }
+            else
+            {
+                std::cerr << "[" << getCurrentTime() << "] "
+                          << "fileProcessor.cpp processFile VAD decode failed: " << vad.error().toString() << std::endl;
             }
         }
 
+        // Simulcast sites and patched talkgroups deliver the same call more
+        // than once; reuse the transcription of a copy already stored
+        const bool fingerprinting = db && ConfigSingleton::getInstance().isFingerprintDedup() && !parsedName.time.empty() && !streamed;
+        sdrtrunk::AudioFingerprint fingerprint;
+        int64_t unixtime = 0;
         std::string transcription;
-        if (gLocalFlag)
+        if (fingerprinting)
         {
-            std::cout << "[" << getCurrentTime() << "] "
-                      << "fileProcessor.cpp processFile gLocalFlag " << gLocalFlag << std::endl;
-            transcription = transcribeAudioLocal(file_path);
+            if (!havePcm)
+            {
+                auto decoded = decodeWhole();
+                if (decoded.has_value())
+                {
+                    pcm = std::move(decoded.value());
+                    havePcm = true;
+                }
+            }
+            if (havePcm)
+            {
+                fingerprint = sdrtrunk::computeFingerprint(pcm.samples);
+                unixtime = generateUnixTimestamp(std::string(parsedName.date), std::string(parsedName.time));
+                if (auto duplicate = findDuplicateRecording(*db, fingerprint, unixtime))
+                {
+                    std::cout << "[" << getCurrentTime() << "] "
+                              << "fileProcessor.cpp processFile " << filename
+                              << " duplicates " << duplicate->filename << ", reusing its transcription" << std::endl;
+                    fileData.duplicateOf = duplicate->filename;
+                    transcription = std::move(duplicate->transcription);
+                }
+            }
         }
-        else
+
+        if (fileData.duplicateOf.empty())
         {
             std::cout << "[" << getCurrentTime() << "] "
                       << "fileProcessor.cpp processFile gLocalFlag " << gLocalFlag << std::endl;
-            transcription = transcribeAudio(file_path, OPENAI_API_KEY, prompt);
+            sdrtrunk::TranscriptionRequest request;
+            request.filePath = file_path;
+            request.prompt = prompt;
+            request.talkgroupId = tgId;
+            request.durationSeconds = duration;
+            request.pcm = havePcm ? &pcm : nullptr;
+            request.decodeProfile = decodeProfile;
+            request.tierOutcome = &fileData.tierOutcome;
+            request.file = &recording.value();
+            transcription = transcribeRecording(request, OPENAI_API_KEY);
+        }
+        // A duplicate's call is already fingerprinted under its original;
+        // another row would only grow the cluster later lookups compare
+        if (fileData.duplicateOf.empty() && !fingerprint.landmarks.empty() && !transcription.empty())
+        {
+            db->insertFingerprint(filename, tgId, unixtime, fingerprint.serialize(), transcription);
         }
-        extractFileInfo(fileData, path.filename().string(), transcription);
+        extractFileInfo(fileData, parsedName, transcription);
 
         saveTranscription(fileData);
         moveFiles(fileData, directoryToMonitor);
@@ -0,0 +1,68 @@
+/**
+ * @file glossaryCompiler.cpp
+ * @brief glossary-compiler: JSON glossaries to one compiled glossary
+ *
+ *   glossary-compiler statewide-units.json callsigns.json -o statewide.glossary
+ *
+ * The inputs are merged the way a talkgroup's GLOSSARY list is, first
+ * file wins, and may be flat or multi-key JSON or compiled glossaries.
+ * List the output in GLOSSARY on its own and the daemon maps it at
+ * startup instead of parsing JSON.
+ */
+
+#include "../include/Glossary.h"
+
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+void printUsage() {
+    std::cout << "Compile JSON glossaries into a file the transcriber maps at startup\n";
+    std::cout << "Usage: glossary-compiler <glossary.json>... -o <output>\n\n";
+    std::cout << "Inputs are merged in order; for a key in several files the first wins.\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> inputs;
+    std::string output;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-h") == 0 || std::strcmp(argv[i], "--help") == 0) {
+            printUsage();
+            return 0;
+        }
+        if (std::strcmp(argv[i], "-o") == 0 || std::strcmp(argv[i], "--output") == 0) {
+            if (i + 1 >= argc) {
+                std::cerr << "Missing path after " << argv[i] << "\n";
+                return 1;
+            }
+            output = argv[++i];
+            continue;
+        }
+        inputs.emplace_back(argv[i]);
+    }
+    if (inputs.empty() || output.empty()) {
+        printUsage();
+        return 1;
+    }
+
+    // Unlike the daemon, which skips a bad file, a compile fails on one
+    auto merged = sdrtrunk::mergeGlossaryFiles(inputs, true);
+    if (!merged) {
+        std::cerr << merged.error().toString() << "\n";
+        return 1;
+    }
+
+    const auto snapshot = sdrtrunk::GlossarySnapshot::fromMappings(inputs, *merged);
+    auto written = snapshot->writeCompiled(output);
+    if (!written) {
+        std::cerr << written.error().toString() << "\n";
+        return 1;
+    }
+    std::cout << "Wrote " << snapshot->size() << " terms (" << *written << " bytes) to " << output << "\n";
+    return 0;
+}
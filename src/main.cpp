@@ -1,4 +1,5 @@
 // Standard Library Headers
+#include <algorithm>
 #include <chrono>
 #include <csignal>
 #include <cstdlib>
@@ -22,6 +23,9 @@
 #include "../include/fileProcessor.h"
 #include "../include/fasterWhisper.h"
 #include "../include/globalFlags.h"
+#include "../include/Glossary.h"
+#include "../include/PcmStream.h"
+#include "../include/Reenrich.h"
 #include "../include/ThreadPool.h"
 #include "../include/yamlParser.h"
 
@@ -50,6 +54,8 @@ std::optional<YamlNode> loadConfig(const std::string &configPath);
 
 void processDirectory(const std::string &directoryToMonitor, const YamlNode &config, DatabaseManager &dbManager);
 
+int reenrichDatabase(const CommandLineArgs &args);
+
 std::optional<YamlNode> loadConfig(const std::string &configPath)
 {
     if (!std::filesystem::exists(configPath))
@@ -86,7 +92,20 @@ void insertFileData(DatabaseManager &dbManager, const FileData &fileData)
                 fileData.filename.get().string(),
                 fileData.filepath.get().string(),
                 fileData.transcription.get(),
-                fileData.v2transcription.get());
+                fileData.v2transcription.get(),
+                fileData.skipReason,
+                fileData.speechRatio,
+                fileData.duplicateOf,
+                fileData.talkgroups);
+            if (fileData.tierOutcome.tiered)
+            {
+                dbManager.recordTierOutcome(
+                    fileData.talkgroupID.get(),
+                    fileData.tierOutcome.escalated,
+                    fileData.tierOutcome.draftSeconds,
+                    fileData.tierOutcome.fullSeconds,
+                    fileData.tierOutcome.savedSeconds);
+            }
         }
         catch (const std::exception &e)
         {
@@ -134,10 +153,10 @@ void processDirectory(const std::string &directoryToMonitor, const YamlNode &con
 
         for (const auto &path : mp3Files)
         {
-            futures.push_back(pool.enqueue([path, &directoryToMonitor, &OPENAI_API_KEY]() {
+            futures.push_back(pool.enqueue([path, &directoryToMonitor, &OPENAI_API_KEY, &dbManager]() {
                 try
                 {
-                    return processFile(path, directoryToMonitor, OPENAI_API_KEY);
+                    return processFile(path, directoryToMonitor, OPENAI_API_KEY, &dbManager);
                 }
                 catch (const std::runtime_error &e)
                 {
@@ -165,7 +184,7 @@ void processDirectory(const std::string &directoryToMonitor, const YamlNode &con
             FileData fileData;
             try
             {
-                fileData = processFile(path, directoryToMonitor, OPENAI_API_KEY);
+                fileData = processFile(path, directoryToMonitor, OPENAI_API_KEY, &dbManager);
             }
             catch (const std::runtime_error &e)
             {
@@ -181,6 +200,39 @@ void processDirectory(const std::string &directoryToMonitor, const YamlNode &con
     }
 }
 
+// --reenrich: rebuild v2transcription of stored recordings with the
+// current glossaries, then exit
+int reenrichDatabase(const CommandLineArgs &args)
+{
+    auto filter = sdrtrunk::reenrichFilter(args.reenrichTalkgroup, args.reenrichFrom, args.reenrichTo);
+    if (!filter)
+    {
+        std::cerr << "[" << getCurrentTime() << "] "
+                  << "main.cpp reenrichDatabase " << filter.error().toString() << std::endl;
+        return 1;
+    }
+
+    DatabaseManager dbManager(ConfigSingleton::getInstance().getDatabasePath());
+    dbManager.createTable();
+
+    sdrtrunk::ReenrichOptions options;
+    options.filter = *filter;
+    // Nothing here waits on the API, so use every core
+    options.threads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::cout << "[" << getCurrentTime() << "] "
+              << "main.cpp reenrichDatabase Re-enriching stored transcriptions on " << options.threads << " threads" << std::endl;
+    const auto started = std::chrono::steady_clock::now();
+    const auto stats = sdrtrunk::reenrichTranscriptions(
+        dbManager, ConfigSingleton::getInstance().getTalkgroupFiles(), options, &g_shutdown_requested);
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    std::cout << "[" << getCurrentTime() << "] "
+              << "main.cpp reenrichDatabase " << stats.scanned << " recordings in " << elapsed << " s: "
+              << stats.updated << " updated, " << stats.unchanged << " unchanged, " << stats.failed << " without text"
+              << (g_shutdown_requested ? " (interrupted)" : "") << std::endl;
+    return 0;
+}
+
 int main(int argc, char *argv[])
 {
     // Set up signal handlers for graceful shutdown
@@ -226,6 +278,42 @@ int main(int argc, char *argv[])
               << "=======================================" << std::endl;
 
     ConfigSingleton::getInstance().initialize(config);
+    sdrtrunk::DecodeMemoryBudget::instance().setCapBytes(
+        static_cast<size_t>(std::max(0, ConfigSingleton::getInstance().getDecodeMemoryCapMb())) * 1024 * 1024);
+
+    if (args.reenrichFlag)
+    {
+        return reenrichDatabase(args);
+    }
+
+    // Glossary edits are picked up in the background; workers keep using
+    // the snapshot they started with
+    std::optional<sdrtrunk::GlossaryWatcher> glossaryWatcher;
+    if (ConfigSingleton::getInstance().getGlossaryReloadSeconds() > 0)
+    {
+        glossaryWatcher.emplace(ConfigSingleton::getInstance().getGlossaries(),
+                                std::chrono::seconds(ConfigSingleton::getInstance().getGlossaryReloadSeconds()));
+    }
+
+    // Load the local model in the background while the DB is opened,
+    // migrated and the first directory scan runs; local work waits on it.
+    // Hybrid routing builds a local backend without --local, so it warms
+    // up too. whisper.cpp models are loaded when the backend is built.
+    const bool localBackendUsed = gLocalFlag || ConfigSingleton::getInstance().isHybridRouting();
+    if (localBackendUsed)
+    {
+        std::cout << "[" << getCurrentTime() << "] "
+                  << "main.cpp Starting local model warm-up in background" << std::endl;
+        if (ConfigSingleton::getInstance().getLocalBackend() == "whisper.cpp")
+        {
+            startLocalBackendWarmup();
+        }
+        else
+        {
+            const auto &config = ConfigSingleton::getInstance();
+            start_model_warmup(config.isTieredTranscription() ? config.getTierDraftModel() : "");
+        }
+    }
 
     std::string databasePath = ConfigSingleton::getInstance().getDatabasePath();
     DatabaseManager dbManager(databasePath);
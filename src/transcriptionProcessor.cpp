@@ -2,7 +2,6 @@
 #include <algorithm>
 #include <cctype>
 #include <deque>
-#include <fstream>
 #include <functional>
 #include <iostream>
 #include <regex>
@@ -14,7 +13,6 @@
 // Project-Specific Headers
 #include "../include/ConfigSingleton.h"
 #include "../include/debugUtils.h"
-#include "../include/jsonParser.h"
 #include "../include/yamlParser.h"
 
 
@@ -26,39 +24,28 @@ void insertMappings(std::stringstream &orderedJsonStr, const std::string &actual
 std::unordered_set<int> parseTalkgroupIDs(const std::string &idString)
 {
     std::unordered_set<int> ids;
-    std::stringstream ss(idString);
-    std::string token;
-    while (std::getline(ss, token, ','))
+    for (const auto &range : sdrtrunk::parseTalkgroupRanges(idString))
     {
-        size_t dash = token.find('-');
-        if (dash != std::string::npos)
+        for (int i = range.first; i <= range.last; ++i)
         {
-            int start = std::stoi(token.substr(0, dash));
-            int end = std::stoi(token.substr(dash + 1));
-            for (int i = start; i <= end; ++i)
-            {
-                ids.insert(i);
-            }
-        }
-        else
-        {
-            ids.insert(std::stoi(token));
+            ids.insert(i);
         }
     }
     return ids;
 }
 
 // Function to read talkgroup-specific file mappings from config.yaml
-std::unordered_map<int, TalkgroupFiles> readTalkgroupFileMappings(const std::string &configFilePath)
+sdrtrunk::TalkgroupProfiles readTalkgroupFileMappings(const std::string &configFilePath)
 {
     YamlNode config = YamlParser::loadFile(configFilePath);
-    std::unordered_map<int, TalkgroupFiles> mappings;
+    sdrtrunk::TalkgroupProfiles mappings;
+    sdrtrunk::GlossaryCache glossaries;
 
     const YamlNode &tgFilesNode = config["TALKGROUP_FILES"];
     auto tgKeys = tgFilesNode.getKeys();
     for (const auto &tgKey : tgKeys)
     {
-        auto ids = parseTalkgroupIDs(tgKey);
+        auto ranges = sdrtrunk::parseTalkgroupRanges(tgKey);
         TalkgroupFiles files;
         const YamlNode &tgNode = tgFilesNode[tgKey];
         const YamlNode &glossaryNode = tgNode["GLOSSARY"];
@@ -68,6 +55,7 @@ std::unordered_map<int, TalkgroupFiles> readTalkgroupFileMappings(const std::str
         {
             files.glossaryFiles = std::get<std::vector<std::string>>(glossaryNode.getValue());
         }
+        files.glossary = glossaries.get(files.glossaryFiles);
 
         // Parse optional PROMPT field
         try {
@@ -76,10 +64,7 @@ std::unordered_map<int, TalkgroupFiles> readTalkgroupFileMappings(const std::str
             }
         } catch (...) {}
 
-        for (int id : ids)
-        {
-            mappings[id] = files;
-        }
+        mappings.assign(ranges, std::move(files));
     }
     return mappings;
 }
@@ -89,6 +74,24 @@ std::string generateV2Transcription(
     int talkgroupID,
     int radioID,
     const std::unordered_map<int, TalkgroupFiles> &talkgroupFiles)
+{
+    auto it = talkgroupFiles.find(talkgroupID);
+    return generateV2Transcription(transcription, radioID, it == talkgroupFiles.end() ? nullptr : &it->second);
+}
+
+std::string generateV2Transcription(
+    const std::string &transcription,
+    int talkgroupID,
+    int radioID,
+    const sdrtrunk::TalkgroupProfiles &talkgroupProfiles)
+{
+    return generateV2Transcription(transcription, radioID, talkgroupProfiles.lookup(talkgroupID));
+}
+
+std::string generateV2Transcription(
+    const std::string &transcription,
+    int radioID,
+    const TalkgroupFiles *files)
 {
     // Extract the actual transcription
     const auto actualTranscription = extractActualTranscription(transcription);
@@ -100,20 +103,16 @@ std::string generateV2Transcription(
         return {};
     }
 
-    std::unordered_map<std::string, std::string> mappings;
-
-    // Check if there are glossary files for the talkgroup
-    auto it = talkgroupFiles.find(talkgroupID);
-    if (it != talkgroupFiles.end())
+    // The talkgroup's current glossary snapshot; configured talkgroups get
+    // theirs at startup, hand-built maps have the files read here. Held
+    // until the transcription is written, even if a reload replaces it.
+    std::shared_ptr<const sdrtrunk::GlossarySnapshot> glossary;
+    if (files)
     {
-        // Process each glossary file
-        for (const auto &file : it->second.glossaryFiles)
-        {
-            // Read the mappings from each glossary file
-            auto fileMappings = readMappingFile(file);
-            // Merge the mappings from this file into the main mappings map
-            mappings.insert(fileMappings.begin(), fileMappings.end());
-        }
+        if (files->glossary)
+            glossary = files->glossary->snapshot();
+        else if (!files->glossaryFiles.empty())
+            glossary = sdrtrunk::GlossarySnapshot::build(files->glossaryFiles);
     }
 
     // Build the ordered JSON string
@@ -121,8 +120,9 @@ std::string generateV2Transcription(
     orderedJsonStr << "{";
     orderedJsonStr << "\"" << std::to_string(radioID) << "\":\"" << actualTranscription << "\"";
 
-    // Insert the mappings into the JSON string
-    insertMappings(orderedJsonStr, actualTranscription, mappings);
+    // Insert the glossary terms found in the transcription
+    if (glossary)
+        glossary->appendMatches(orderedJsonStr, actualTranscription);
 
     orderedJsonStr << "}";
 
@@ -131,80 +131,22 @@ std::string generateV2Transcription(
 
 std::unordered_map<std::string, std::string> readMappingFile(const std::string &filePath)
 {
-    std::unordered_map<std::string, std::string> mapping;
-    std::ifstream file(filePath);
-    if (!file.is_open())
+    auto mapping = sdrtrunk::loadGlossaryJson(filePath);
+    if (mapping)
     {
-        if (ConfigSingleton::getInstance().isDebugTranscriptionProcessor())
-        {
-            std::cerr << "[" << getCurrentTime() << "] "
-                      << "transcriptionProcessor.cpp readMappingFile Could not open file: " << filePath << std::endl;
-        }
-        return mapping;
+        return std::move(*mapping);
     }
-    file.close(); // Close the file since JsonParser will open it again
-
-    try
+    if (mapping.error().code != sdrtrunk::ErrorCode::FileNotFound)
     {
-        // Try new multi-key glossary format first
-        auto glossaryEntries = JsonParser::parseGlossaryFile(filePath);
-        if (!glossaryEntries.empty()) {
-            for (const auto &entry : glossaryEntries) {
-                for (const auto &key : entry.keys) {
-                    mapping[key] = entry.value;
-                }
-            }
-        } else {
-            // Fall back to old flat format
-            JsonParser::JsonObject j = JsonParser::parseFile(filePath);
-
-            for (const auto &[key, value] : j)
-            {
-                if (std::holds_alternative<std::string>(value))
-                {
-                    mapping[key] = std::get<std::string>(value);
-                }
-                else if (std::holds_alternative<double>(value))
-                {
-                    double num = std::get<double>(value);
-                    if (num == static_cast<int>(num)) {
-                        mapping[key] = std::to_string(static_cast<int>(num));
-                    } else {
-                        mapping[key] = std::to_string(num);
-                    }
-                }
-                else if (std::holds_alternative<bool>(value))
-                {
-                    std::cerr << "[" << getCurrentTime() << "] "
-                              << "transcriptionProcessor.cpp readMappingFile Boolean type detected for key: " << key << " in " << filePath << std::endl;
-                }
-                else if (std::holds_alternative<std::nullptr_t>(value))
-                {
-                    std::cerr << "[" << getCurrentTime() << "] "
-                              << "transcriptionProcessor.cpp readMappingFile Null type detected for key: " << key << " in " << filePath << std::endl;
-                }
-            }
-        }
-
-        // Generate hyphen-stripped variants for all keys containing hyphens
-        std::unordered_map<std::string, std::string> hyphenVariants;
-        for (const auto &[key, value] : mapping) {
-            if (key.find('-') != std::string::npos) {
-                std::string stripped = key;
-                stripped.erase(std::remove(stripped.begin(), stripped.end(), '-'), stripped.end());
-                if (mapping.find(stripped) == mapping.end()) {
-                    hyphenVariants[stripped] = value;
-                }
-            }
-        }
-        mapping.insert(hyphenVariants.begin(), hyphenVariants.end());
+        std::cerr << "[" << getCurrentTime() << "] "
+                  << "transcriptionProcessor.cpp readMappingFile " << mapping.error().message << std::endl;
     }
-    catch (const std::exception &e)
+    else if (ConfigSingleton::getInstance().isDebugTranscriptionProcessor())
     {
         std::cerr << "[" << getCurrentTime() << "] "
-                  << "transcriptionProcessor.cpp readMappingFile JSON Error: " << e.what() << std::endl;
+                  << "transcriptionProcessor.cpp readMappingFile Could not open file: " << filePath << std::endl;
     }
-    return mapping;
+    return {};
 }
 
 std::string extractActualTranscription(const std::string &transcription)
@@ -31,6 +31,16 @@ template<> int YamlNode::as<int>() const {
     throw std::runtime_error("Cannot convert to int");
 }
 
+template<> double YamlNode::as<double>() const {
+    if (std::holds_alternative<int>(value_)) {
+        return std::get<int>(value_);
+    }
+    if (std::holds_alternative<std::string>(value_)) {
+        return std::stod(std::get<std::string>(value_));
+    }
+    throw std::runtime_error("Cannot convert to double");
+}
+
 template<> bool YamlNode::as<bool>() const {
     if (std::holds_alternative<bool>(value_)) {
         return std::get<bool>(value_);
@@ -0,0 +1,555 @@
+// Third-Party Library Headers
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+// Standard Library Headers
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <regex>
+#include <span>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Project-Specific Headers
+#include "AudioConvert.h"
+#include "Glossary.h"
+#include "MP3Duration.h"
+#include "SdrTrunkFilename.h"
+#include "SyntheticMP3.h"
+#include "transcriptionProcessor.h"
+
+// Define missing global flag for tests
+bool gLocalFlag = false;
+
+// =============================================================================
+// BENCHMARK CORPUS
+// =============================================================================
+// Set SDRTRUNK_MP3_CORPUS to a directory of real SDRTrunk recordings to
+// benchmark against them; otherwise a synthetic corpus covering the same
+// encodings (8 kHz CBR, Xing/LAME, VBRI, ID3-tagged, untagged VBR) is
+// generated under the temp directory.
+
+namespace {
+
+std::vector<std::string> buildSyntheticCorpus() {
+    namespace fs = std::filesystem;
+    fs::path dir = fs::temp_directory_path() / "sdrtrunk_mp3_corpus";
+    fs::create_directories(dir);
+
+    std::vector<std::string> files;
+    for (int i = 0; i < 200; ++i) {
+        SyntheticMP3 mp3;
+        mp3.frames = 100 + static_cast<size_t>(i) * 37 % 2000;  // ~7 s to ~150 s at 8 kHz
+        switch (i % 5) {
+            case 0: break;  // plain CBR
+            case 1: mp3.tag = SyntheticMP3::Tag::Info; mp3.encoderDelay = 576; mp3.encoderPadding = 300; break;
+            case 2: mp3.tag = SyntheticMP3::Tag::Xing; mp3.bitratesKbps = {16, 24, 32}; mp3.encoderDelay = 576; break;
+            case 3: mp3.tag = SyntheticMP3::Tag::Vbri; mp3.bitratesKbps = {16, 32}; break;
+            default: mp3.bitratesKbps = {16, 24}; mp3.id3v2Bytes = 2048; break;  // forces the full scan
+        }
+        fs::path path = dir / ("synthetic_" + std::to_string(i) + ".mp3");
+        mp3.write(path.string());
+        files.push_back(path.string());
+    }
+    return files;
+}
+
+const std::vector<std::string>& corpus() {
+    static const std::vector<std::string> files = []() {
+        std::vector<std::string> found;
+        if (const char* dir = std::getenv("SDRTRUNK_MP3_CORPUS")) {
+            for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+                if (entry.is_regular_file() && entry.path().extension() == ".mp3") {
+                    found.push_back(entry.path().string());
+                }
+            }
+        }
+        return found.empty() ? buildSyntheticCorpus() : found;
+    }();
+    return files;
+}
+
+} // namespace
+
+// =============================================================================
+// MP3 DURATION ACCURACY
+// =============================================================================
+
+// The header fast path must agree with the mpg123_scan() frame walk to
+// within one frame (72 ms at 8 kHz)
+TEST(MP3DurationAccuracy, HeaderMatchesFullScan) {
+    size_t compared = 0;
+    size_t headerHits = 0;
+    double maxError = 0.0;
+    for (const auto& path : corpus()) {
+        auto scan = sdrtrunk::scanMP3Duration(path);
+        auto fast = sdrtrunk::getMP3Duration(path);
+        if (!scan.has_value()) {
+            continue;
+        }
+        ASSERT_TRUE(fast.has_value()) << path;
+        double error = std::abs(fast.value() - scan.value());
+        EXPECT_LT(error, 0.075) << path << ": header " << fast.value() << " s, scan " << scan.value() << " s";
+        maxError = std::max(maxError, error);
+        ++compared;
+    }
+    for (const auto& path : corpus()) {
+        std::vector<unsigned char> bytes;
+        // Count files the fast path can answer on its own
+        if (auto size = std::filesystem::file_size(path); size > 0) {
+            bytes.resize(size);
+            std::ifstream(path, std::ios::binary).read(reinterpret_cast<char*>(bytes.data()),
+                                                       static_cast<std::streamsize>(size));
+            if (sdrtrunk::parseMP3HeaderDuration(bytes).has_value()) {
+                ++headerHits;
+            }
+        }
+    }
+    std::cout << "  " << corpus().size() << " files, " << headerHits << " answered from headers, "
+              << compared << " compared with mpg123_scan, max error " << maxError << " s" << std::endl;
+    if (compared == 0) {
+        GTEST_SKIP() << "mpg123_scan could not read the corpus";
+    }
+}
+
+// =============================================================================
+// MP3 DURATION BENCHMARKS
+// =============================================================================
+
+static void BM_MP3DurationHeader(benchmark::State& state) {
+    const auto& files = corpus();
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sdrtrunk::getMP3Duration(files[i++ % files.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MP3DurationHeader);
+
+static void BM_MP3DurationScan(benchmark::State& state) {
+    const auto& files = corpus();
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sdrtrunk::scanMP3Duration(files[i++ % files.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MP3DurationScan);
+
+// =============================================================================
+// RESAMPLE BENCHMARKS
+// =============================================================================
+// Decoder output (int16, native rate and channel count) to 16 kHz mono
+// float. items/s is input samples per second on one core.
+
+namespace {
+
+std::vector<int16_t> syntheticPcm(size_t frames, int channels, int rate) {
+    std::vector<int16_t> pcm(frames * static_cast<size_t>(channels));
+    for (size_t i = 0; i < frames; ++i) {
+        double t = static_cast<double>(i) / rate;
+        auto v = static_cast<int16_t>(12000.0 * std::sin(2.0 * 3.14159265358979 * 440.0 * t));
+        for (int c = 0; c < channels; ++c) {
+            pcm[i * static_cast<size_t>(channels) + static_cast<size_t>(c)] = v;
+        }
+    }
+    return pcm;
+}
+
+} // namespace
+
+static void BM_ResampleToWhisper(benchmark::State& state) {
+    const int rate = static_cast<int>(state.range(0));
+    const int channels = static_cast<int>(state.range(1));
+    const size_t frames = static_cast<size_t>(rate) * 10;  // ten-second recording
+    const auto pcm = syntheticPcm(frames, channels, rate);
+    std::vector<float> out;
+    for (auto _ : state) {
+        out.clear();
+        sdrtrunk::PolyphaseResampler resampler(rate, 16000);
+        // Push in decoder-sized chunks like decodeMP3ToPcm does
+        constexpr size_t CHUNK = 4096;
+        for (size_t offset = 0; offset < pcm.size(); offset += CHUNK) {
+            resampler.push(std::span<const int16_t>(pcm).subspan(offset, std::min(CHUNK, pcm.size() - offset)), channels, out);
+        }
+        resampler.finish(out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(frames));
+}
+BENCHMARK(BM_ResampleToWhisper)->Args({8000, 1})->Args({22050, 1})->Args({22050, 2})->Args({44100, 2});
+
+// The previous linear interpolation path (no anti-aliasing), for reference
+static void BM_ResampleLinear(benchmark::State& state) {
+    const int rate = static_cast<int>(state.range(0));
+    const size_t frames = static_cast<size_t>(rate) * 10;
+    const auto pcm = syntheticPcm(frames, 1, rate);
+    std::vector<float> mono(frames);
+    for (auto _ : state) {
+        for (size_t i = 0; i < frames; ++i) {
+            mono[i] = static_cast<float>(pcm[i]) / 32768.0f;
+        }
+        benchmark::DoNotOptimize(sdrtrunk::resamplePcm(mono, rate, 16000));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(frames));
+}
+BENCHMARK(BM_ResampleLinear)->Arg(8000)->Arg(22050);
+
+// =============================================================================
+// FILENAME PARSER
+// =============================================================================
+// parseSdrTrunkFilename() against the std::regex code it replaced in
+// extractFileInfo(), over a million names in every SDRTrunk format.
+
+namespace {
+
+struct RegexFields {
+    std::optional<int> talkgroup;
+    std::optional<int> radio;
+};
+
+// extractFileInfo() before the hand-written parser
+RegexFields parseWithRegex(const std::string& filename) {
+    RegexFields fields;
+    std::smatch match;
+    std::regex rgx_radio("_FROM_(\\d+)");
+    if (filename.find("TO_P") != std::string::npos) {
+        std::regex rgx_bracket("\\[(\\d+)");
+        if (std::regex_search(filename, match, rgx_bracket) && match.size() > 1) {
+            fields.talkgroup = std::stoi(match[1].str());
+        } else {
+            std::regex rgx_talkgroup_P("TO_P_?(\\d+)");
+            if (std::regex_search(filename, match, rgx_talkgroup_P) && match.size() > 1) {
+                fields.talkgroup = std::stoi(match[1].str());
+            }
+        }
+    }
+    if (!fields.talkgroup) {
+        std::regex rgx_talkgroup("TO_(\\d+)");
+        if (std::regex_search(filename, match, rgx_talkgroup) && match.size() > 1) {
+            fields.talkgroup = std::stoi(match[1].str());
+        }
+    }
+    if (std::regex_search(filename, match, rgx_radio) && match.size() > 1) {
+        fields.radio = std::stoi(match[1].str());
+    }
+    return fields;
+}
+
+const std::vector<std::string>& syntheticFilenames() {
+    static const std::vector<std::string> names = []() {
+        constexpr size_t COUNT = 1000000;
+        const char* systems[] = {"_North-Carolina-VIPER_Rutherford_T-Control", "North_Carolina_VIPER_Rutherford_T-SPDControl",
+                                 "_NC-VIPER", "_Conventional_Fire"};
+        std::vector<std::string> out;
+        out.reserve(COUNT);
+        uint32_t seed = 12345;
+        auto next = [&seed]() {
+            seed = seed * 1664525u + 1013904223u;
+            return seed >> 8;
+        };
+        for (size_t i = 0; i < COUNT; ++i) {
+            const int tg = 40000 + static_cast<int>(next() % 20000);
+            const int rid = 1000000 + static_cast<int>(next() % 2000000);
+            std::string name = "202602" + std::to_string(10 + i % 18) + "_1" + std::to_string(10000 + next() % 50000) +
+                               systems[i % 4] + "__TO_";
+            switch (i % 6) {
+                case 0: name += std::to_string(tg) + "_FROM_" + std::to_string(rid); break;
+                case 1: name += std::to_string(tg) + "_V2_FROM_" + std::to_string(rid); break;
+                case 2: name += "P" + std::to_string(tg) + "-[" + std::to_string(tg + 1) + "]_FROM_" + std::to_string(rid); break;
+                case 3: name += "P" + std::to_string(tg) + "-[" + std::to_string(tg + 1) + "--" + std::to_string(tg + 2) +
+                                "--" + std::to_string(tg + 3) + "]_FROM_" + std::to_string(rid); break;
+                case 4: name += "P_" + std::to_string(tg) + "_FROM_" + std::to_string(rid); break;
+                default: name += std::to_string(9000 + tg % 1000); break;  // NBFM, no radio
+            }
+            out.push_back(name + ".mp3");
+        }
+        return out;
+    }();
+    return names;
+}
+
+} // namespace
+
+TEST(FilenameParserAccuracy, MatchesRegexPath) {
+    const auto& names = syntheticFilenames();
+    // The regex path is slow; a sample covers every format many times
+    for (size_t i = 0; i < names.size(); i += 50) {
+        auto expected = parseWithRegex(names[i]);
+        auto parsed = sdrtrunk::parseSdrTrunkFilename(names[i]);
+        ASSERT_EQ(parsed.talkgroup, expected.talkgroup) << names[i];
+        ASSERT_EQ(parsed.radioId, expected.radio) << names[i];
+    }
+}
+
+static void BM_FilenameParser(benchmark::State& state) {
+    const auto& names = syntheticFilenames();
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sdrtrunk::parseSdrTrunkFilename(names[i++ % names.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FilenameParser)->Iterations(1000000);
+
+static void BM_FilenameRegex(benchmark::State& state) {
+    const auto& names = syntheticFilenames();
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parseWithRegex(names[i++ % names.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FilenameRegex)->Iterations(1000000);
+
+// =============================================================================
+// GLOSSARY MATCHING
+// =============================================================================
+// GlossarySnapshot's Aho-Corasick pass against insertMappings(), the loop
+// that compiles and runs one std::regex per key, with a glossary of ten
+// codes, signals and callsigns the size of a busy county's.
+
+namespace {
+
+std::shared_ptr<const sdrtrunk::GlossarySnapshot> benchmarkGlossary() {
+    static const auto snapshot = []() {
+        std::ostringstream json;
+        json << "{";
+        for (int code = 1; code <= 200; ++code) {
+            json << "\"10-" << code << "\": \"ten code " << code << "\", ";
+        }
+        for (int signal = 1; signal <= 100; ++signal) {
+            json << "\"Signal " << signal << "\": \"signal " << signal << "\", ";
+        }
+        for (int unit = 1; unit <= 200; ++unit) {
+            json << "\"Medic " << unit << "\": \"EMS unit " << unit << "\", ";
+        }
+        json << "\"K9\": \"canine\"}";
+        const std::string path = (std::filesystem::temp_directory_path() / "sdrtrunk_benchmark_glossary.json").string();
+        std::ofstream(path) << json.str();
+        auto built = sdrtrunk::GlossarySnapshot::build({path});
+        std::filesystem::remove(path);
+        return built;
+    }();
+    return snapshot;
+}
+
+const std::vector<std::string>& benchmarkTranscriptions() {
+    static const std::vector<std::string> texts = {
+        "Medic 14 responding to a signal 7 on Main Street, 10-4",
+        "Copy that, show me 10-8 and en route, K9 unit is 10-97",
+        "Engine 3 to dispatch, we have smoke showing from a two-story residential, requesting a second alarm",
+        "10-43 at the interstate, medic 120 and medic 12 en route, signal 10 on scene",
+        "Dispatch to all units, be advised the suspect vehicle is a blue sedan heading northbound"};
+    return texts;
+}
+
+} // namespace
+
+TEST(GlossaryMatcherAccuracy, MatchesRegexLoop) {
+    auto glossary = benchmarkGlossary();
+    ASSERT_GT(glossary->size(), 500u);
+    for (const auto& text : benchmarkTranscriptions()) {
+        std::stringstream regexOut;
+        for (size_t i = 0; i < glossary->size(); ++i) {
+            const auto term = glossary->term(i);
+            insertMappings(regexOut, text, {{std::string(term.key), std::string(term.value)}});
+        }
+        std::stringstream matcherOut;
+        glossary->appendMatches(matcherOut, text);
+        EXPECT_EQ(matcherOut.str(), regexOut.str()) << text;
+    }
+}
+
+static void BM_GlossaryAhoCorasick(benchmark::State& state) {
+    auto glossary = benchmarkGlossary();
+    const auto& texts = benchmarkTranscriptions();
+    size_t i = 0;
+    for (auto _ : state) {
+        std::stringstream out;
+        glossary->appendMatches(out, texts[i++ % texts.size()]);
+        benchmark::DoNotOptimize(out);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GlossaryAhoCorasick);
+
+static void BM_GlossaryRegexLoop(benchmark::State& state) {
+    const auto mappings = benchmarkGlossary()->mappings();
+    const auto& texts = benchmarkTranscriptions();
+    size_t i = 0;
+    for (auto _ : state) {
+        std::stringstream out;
+        insertMappings(out, texts[i++ % texts.size()], mappings);
+        benchmark::DoNotOptimize(out);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GlossaryRegexLoop)->Unit(benchmark::kMillisecond);
+
+// =============================================================================
+// GLOSSARY LOADING
+// =============================================================================
+// Startup cost of a statewide unit list: parsing the JSON and building the
+// automaton against mapping what glossary-compiler wrote from it.
+
+namespace {
+
+// JSON and compiled copies of 20,000 callsigns across a few agencies
+const std::pair<std::string, std::string>& statewideGlossaryFiles() {
+    static const auto files = []() {
+        const auto dir = std::filesystem::temp_directory_path();
+        const std::string jsonPath = (dir / "sdrtrunk_benchmark_statewide.json").string();
+        const std::string compiledPath = (dir / "sdrtrunk_benchmark_statewide.glossary").string();
+        const char* agencies[] = {"state patrol", "sheriff", "fire district", "EMS"};
+        std::ofstream json(jsonPath);
+        json << "{";
+        for (int unit = 1; unit <= 20000; ++unit) {
+            json << (unit > 1 ? ", " : "") << "\"Car " << unit << "\": \"" << agencies[unit % 4] << "\"";
+        }
+        json << "}";
+        json.close();
+        auto written = sdrtrunk::GlossarySnapshot::build({jsonPath})->writeCompiled(compiledPath);
+        if (!written) {
+            std::cerr << written.error().toString() << std::endl;
+        }
+        return std::make_pair(jsonPath, compiledPath);
+    }();
+    return files;
+}
+
+} // namespace
+
+TEST(CompiledGlossaryAccuracy, MatchesJsonBuild) {
+    const auto& [jsonPath, compiledPath] = statewideGlossaryFiles();
+    auto json = sdrtrunk::GlossarySnapshot::build({jsonPath});
+    auto compiled = sdrtrunk::GlossarySnapshot::openCompiled(compiledPath);
+    ASSERT_TRUE(compiled.has_value()) << compiled.error().toString();
+    ASSERT_EQ((*compiled)->size(), 20000u);
+    const std::string text = "Car 7 and car 19999 responding, Car 123 on scene";
+    std::stringstream fromJson;
+    json->appendMatches(fromJson, text);
+    std::stringstream fromCompiled;
+    (*compiled)->appendMatches(fromCompiled, text);
+    EXPECT_EQ(fromCompiled.str(), fromJson.str());
+}
+
+static void BM_GlossaryLoadJson(benchmark::State& state) {
+    const std::string& path = statewideGlossaryFiles().first;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sdrtrunk::GlossarySnapshot::build({path}));
+    }
+}
+BENCHMARK(BM_GlossaryLoadJson)->Unit(benchmark::kMillisecond);
+
+static void BM_GlossaryOpenCompiled(benchmark::State& state) {
+    const std::string& path = statewideGlossaryFiles().second;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sdrtrunk::GlossarySnapshot::build({path}));
+    }
+}
+BENCHMARK(BM_GlossaryOpenCompiled)->Unit(benchmark::kMillisecond);
+
+// =============================================================================
+// TALKGROUP RANGES
+// =============================================================================
+// Startup cost of TALKGROUP_FILES keys covering wide ranges: the interval
+// table against expanding every key into a hash map entry per ID.
+
+namespace {
+
+const std::vector<std::string> wideTalkgroupKeys = {"1-65535", "52197-52300", "40000-40999,28513", "9000-9010"};
+
+std::vector<TalkgroupFiles> wideTalkgroupSettings() {
+    std::vector<TalkgroupFiles> settings(wideTalkgroupKeys.size());
+    for (size_t k = 0; k < settings.size(); ++k) {
+        settings[k].glossaryFiles = {"/etc/sdrtrunk/statewide.json", "/etc/sdrtrunk/county" + std::to_string(k) + ".json"};
+        settings[k].prompt = "Dispatch traffic for key " + std::to_string(k) + ".";
+    }
+    return settings;
+}
+
+} // namespace
+
+TEST(TalkgroupRangeAccuracy, IntervalTableMatchesExpandedMap) {
+    const auto settings = wideTalkgroupSettings();
+    sdrtrunk::TalkgroupProfiles profiles;
+    std::unordered_map<int, TalkgroupFiles> expanded;
+    for (size_t k = 0; k < wideTalkgroupKeys.size(); ++k) {
+        profiles.assign(sdrtrunk::parseTalkgroupRanges(wideTalkgroupKeys[k]), settings[k]);
+        for (int id : parseTalkgroupIDs(wideTalkgroupKeys[k])) {
+            expanded[id] = settings[k];
+        }
+    }
+    ASSERT_EQ(profiles.size(), expanded.size());
+    for (int id = 0; id <= 65536; ++id) {
+        const TalkgroupFiles* files = profiles.lookup(id);
+        auto it = expanded.find(id);
+        ASSERT_EQ(files != nullptr, it != expanded.end()) << id;
+        if (files) {
+            ASSERT_EQ(files->prompt, it->second.prompt) << id;
+        }
+    }
+}
+
+static void BM_TalkgroupRangesInterval(benchmark::State& state) {
+    const auto settings = wideTalkgroupSettings();
+    for (auto _ : state) {
+        sdrtrunk::TalkgroupProfiles profiles;
+        for (size_t k = 0; k < wideTalkgroupKeys.size(); ++k) {
+            profiles.assign(sdrtrunk::parseTalkgroupRanges(wideTalkgroupKeys[k]), settings[k]);
+        }
+        benchmark::DoNotOptimize(profiles.lookup(52198));
+    }
+}
+BENCHMARK(BM_TalkgroupRangesInterval);
+
+static void BM_TalkgroupRangesExpanded(benchmark::State& state) {
+    const auto settings = wideTalkgroupSettings();
+    for (auto _ : state) {
+        std::unordered_map<int, TalkgroupFiles> expanded;
+        for (size_t k = 0; k < wideTalkgroupKeys.size(); ++k) {
+            for (int id : parseTalkgroupIDs(wideTalkgroupKeys[k])) {
+                expanded[id] = settings[k];
+            }
+        }
+        benchmark::DoNotOptimize(expanded.find(52198));
+    }
+}
+BENCHMARK(BM_TalkgroupRangesExpanded)->Unit(benchmark::kMillisecond);
+
+static void BM_TalkgroupRangeLookup(benchmark::State& state) {
+    const auto settings = wideTalkgroupSettings();
+    sdrtrunk::TalkgroupProfiles profiles;
+    for (size_t k = 0; k < wideTalkgroupKeys.size(); ++k) {
+        profiles.assign(sdrtrunk::parseTalkgroupRanges(wideTalkgroupKeys[k]), settings[k]);
+    }
+    int id = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(profiles.lookup(id));
+        id = (id + 7919) % 70000;
+    }
+}
+BENCHMARK(BM_TalkgroupRangeLookup);
+
+// Runs the accuracy tests, then the benchmarks. ctest invokes single
+// tests through --gtest_filter, which skips the benchmarks.
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    benchmark::Initialize(&argc, argv);
+
+    int result = RUN_ALL_TESTS();
+    if (!::testing::GTEST_FLAG(list_tests) && ::testing::GTEST_FLAG(filter) == "*") {
+        benchmark::RunSpecifiedBenchmarks();
+        benchmark::Shutdown();
+    }
+    return result;
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+// Standard Library Headers
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// =============================================================================
+// SYNTHETIC MP3 BUILDER
+// =============================================================================
+// Builds structurally valid MPEG Layer III streams (mono, silent payload)
+// with optional Xing/Info + LAME, VBRI and ID3 tags, so duration parsing can
+// be tested and benchmarked without shipping audio files.
+
+struct SyntheticMP3 {
+    enum class Tag { None, Xing, Info, Vbri };
+
+    int sampleRate = 8000;              // SDRTrunk records at 8 kHz (MPEG-2.5)
+    std::vector<int> bitratesKbps = {16};  // cycled per frame; more than one is VBR
+    size_t frames = 500;                // audio frames, excluding a tag frame
+    Tag tag = Tag::None;
+    int encoderDelay = 0;               // LAME tag fields (Xing/Info only)
+    int encoderPadding = 0;
+    size_t id3v2Bytes = 0;              // ID3v2 body size, 0 = no tag
+    bool id3v1 = false;
+
+    int samplesPerFrame() const { return sampleRate >= 32000 ? 1152 : 576; }
+
+    // What the file should decode to with gapless trimming
+    double expectedSeconds() const {
+        double samples = static_cast<double>(frames) * samplesPerFrame();
+        if (tag == Tag::Xing || tag == Tag::Info) {
+            samples -= encoderDelay + encoderPadding;
+        }
+        return samples / sampleRate;
+    }
+
+    std::vector<unsigned char> build() const {
+        std::vector<unsigned char> out;
+        if (id3v2Bytes > 0) {
+            const unsigned char header[10] = {
+                'I', 'D', '3', 4, 0, 0,
+                static_cast<unsigned char>((id3v2Bytes >> 21) & 0x7F),
+                static_cast<unsigned char>((id3v2Bytes >> 14) & 0x7F),
+                static_cast<unsigned char>((id3v2Bytes >> 7) & 0x7F),
+                static_cast<unsigned char>(id3v2Bytes & 0x7F)};
+            out.insert(out.end(), header, header + 10);
+            out.resize(out.size() + id3v2Bytes, 0);
+        }
+
+        const size_t audioStart = out.size();
+        double carry = 0.0;
+        auto appendFrame = [&](int kbps) -> size_t {
+            // Pad whenever the running fraction reaches a byte, like encoders do
+            const double exact = (sampleRate >= 32000 ? 144.0 : 72.0) * kbps * 1000.0 / sampleRate;
+            const size_t whole = static_cast<size_t>(exact);
+            carry += exact - static_cast<double>(whole);
+            const bool pad = carry >= 1.0;
+            if (pad) {
+                carry -= 1.0;
+            }
+            const size_t start = out.size();
+            out.resize(start + whole + (pad ? 1 : 0), 0);
+            writeHeader(&out[start], kbps, pad);
+            return start;
+        };
+
+        size_t tagFrame = 0;
+        if (tag != Tag::None) {
+            tagFrame = appendFrame(bitratesKbps.front());
+        }
+        for (size_t i = 0; i < frames; ++i) {
+            appendFrame(bitratesKbps[i % bitratesKbps.size()]);
+        }
+        const uint32_t audioBytes = static_cast<uint32_t>(out.size() - audioStart);
+
+        if (tag == Tag::Xing || tag == Tag::Info) {
+            const size_t sideInfo = sampleRate >= 32000 ? 17 : 9;
+            unsigned char* p = &out[tagFrame + 4 + sideInfo];
+            std::memcpy(p, tag == Tag::Xing ? "Xing" : "Info", 4);
+            putBigEndian32(p + 4, 0x3);  // frames + bytes
+            putBigEndian32(p + 8, static_cast<uint32_t>(frames));
+            putBigEndian32(p + 12, audioBytes);
+            unsigned char* lame = p + 16;
+            std::memcpy(lame, "LAME3.100", 9);
+            lame[21] = static_cast<unsigned char>(encoderDelay >> 4);
+            lame[22] = static_cast<unsigned char>(((encoderDelay & 0x0F) << 4) | ((encoderPadding >> 8) & 0x0F));
+            lame[23] = static_cast<unsigned char>(encoderPadding & 0xFF);
+        } else if (tag == Tag::Vbri) {
+            unsigned char* p = &out[tagFrame + 4 + 32];
+            std::memcpy(p, "VBRI", 4);
+            p[5] = 1;  // version
+            putBigEndian32(p + 10, audioBytes);
+            putBigEndian32(p + 14, static_cast<uint32_t>(frames));
+        }
+
+        if (id3v1) {
+            out.resize(out.size() + 128, 0);
+            std::memcpy(&out[out.size() - 128], "TAG", 3);
+        }
+        return out;
+    }
+
+    void write(const std::string& path) const {
+        auto bytes = build();
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    }
+
+private:
+    static void putBigEndian32(unsigned char* p, uint32_t v) {
+        p[0] = static_cast<unsigned char>(v >> 24);
+        p[1] = static_cast<unsigned char>(v >> 16);
+        p[2] = static_cast<unsigned char>(v >> 8);
+        p[3] = static_cast<unsigned char>(v);
+    }
+
+    void writeHeader(unsigned char* p, int kbps, bool pad) const {
+        static const int rates[3][3] = {{44100, 48000, 32000}, {22050, 24000, 16000}, {11025, 12000, 8000}};
+        static const int mpeg1[16] = {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0};
+        static const int lsf[16] = {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0};
+        int row = -1;
+        int rateIndex = -1;
+        for (int r = 0; r < 3; ++r) {
+            for (int i = 0; i < 3; ++i) {
+                if (rates[r][i] == sampleRate) {
+                    row = r;
+                    rateIndex = i;
+                }
+            }
+        }
+        const int* table = row == 0 ? mpeg1 : lsf;
+        int bitrateIndex = -1;
+        for (int i = 1; i < 15; ++i) {
+            if (table[i] == kbps) {
+                bitrateIndex = i;
+            }
+        }
+        if (row < 0 || bitrateIndex < 0) {
+            throw std::invalid_argument("Unsupported sample rate / bitrate for synthetic MP3");
+        }
+        const int versionBits = row == 0 ? 3 : (row == 1 ? 2 : 0);
+        p[0] = 0xFF;
+        p[1] = static_cast<unsigned char>(0xE0 | (versionBits << 3) | (1 << 1) | 1);  // Layer III, no CRC
+        p[2] = static_cast<unsigned char>((bitrateIndex << 4) | (rateIndex << 2) | (pad ? 0x2 : 0));
+        p[3] = 0xC0;  // mono
+    }
+};
@@ -3,6 +3,7 @@
 #ifdef GMOCK_AVAILABLE
 #include <gmock/gmock.h>
 #endif
+#include <mpg123.h>
 
 // Standard Library Headers
 #include <filesystem>
@@ -10,8 +11,13 @@
 #include <memory>
 #include <sstream>
 #include <iomanip>
+#include <atomic>
 #include <thread>
 #include <chrono>
+#include <cmath>
+#include <numbers>
+#include <random>
+#include <tuple>
 
 // Project-Specific Headers
 #include "ConfigSingleton.h"
@@ -24,6 +30,21 @@
 #include "FileData.h"
 #include "globalFlags.h"
 #include "jsonParser.h"
+#include "AudioConvert.h"
+#include "AudioFingerprint.h"
+#include "ChunkedBackend.h"
+#include "MP3Duration.h"
+#include "Mpg123Pool.h"
+#include "PcmStream.h"
+#include "RecordingFile.h"
+#include "RecordingTime.h"
+#include "Reenrich.h"
+#include "SdrTrunkFilename.h"
+#include "SyntheticMP3.h"
+#include "TieredBackend.h"
+#include "TranscriptionRouter.h"
+#include "VoiceActivity.h"
+#include "WhisperCppBackend.h"
 #include <cstdlib>
 
 // Test environment globals
@@ -169,6 +190,32 @@ TEST_F(ConfigSingletonTest, TalkgroupFilesMapping) {
     EXPECT_FALSE(it->second.glossaryFiles.empty());
 }
 
+TEST_F(ConfigSingletonTest, TalkgroupsWithEqualSettingsShareOneProfile) {
+    YamlNode config = YamlParser::loadFile(TEST_CONFIG_PATH);
+    YamlNode talkgroups = YamlParser::parseString(
+        "TALKGROUP_FILES:\n"
+        "  9201-9300:\n"
+        "    PROMPT: Fire dispatch.\n"
+        "  9301:\n"
+        "    PROMPT: Fire dispatch.\n"
+        "  9302:\n"
+        "    PROMPT: Fire dispatch.\n"
+        "    DECODE_PROFILE: fast\n");
+    config["TALKGROUP_FILES"] = talkgroups["TALKGROUP_FILES"];
+    auto& configSingleton = ConfigSingleton::getInstance();
+    configSingleton.initialize(config);
+    const auto& talkgroupFiles = configSingleton.getTalkgroupFiles();
+
+    const TalkgroupFiles* first = talkgroupFiles.lookup(9201);
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(first->prompt, "Fire dispatch.");
+    EXPECT_EQ(talkgroupFiles.lookup(9300), first);
+    EXPECT_EQ(talkgroupFiles.lookup(9301), first);
+    ASSERT_NE(talkgroupFiles.lookup(9302), nullptr);
+    EXPECT_NE(talkgroupFiles.lookup(9302), first);
+    EXPECT_TRUE(talkgroupFiles.lookup(9302)->decodeProfile.has_value());
+}
+
 // =============================================================================
 // DATABASE MANAGER TESTS  
 // =============================================================================
@@ -200,6 +247,159 @@ TEST_F(DatabaseManagerTest, InsertRecording) {
     ));
 }
 
+TEST_F(DatabaseManagerTest, InsertSkippedRecordingStoresReason) {
+    std::string dbPath = getTempDir() + "skip_reason_test.db";
+    std::filesystem::remove(dbPath);
+    {
+        DatabaseManager db(dbPath);
+        db.createTable();
+        db.insertRecording("20240115", "143045", 1705330245, 52198, "NCSHP", 12345, 12.0,
+                           "keyup.mp3", "/tmp/keyup.mp3", "", "", "vad", 0.02);
+        db.insertRecording("20240115", "143046", 1705330246, 52198, "NCSHP", 12345, 12.0,
+                           "speech.mp3", "/tmp/speech.mp3", "{\"text\":\"ok\"}", "{}");
+    }
+
+    sqlite3 *raw = nullptr;
+    ASSERT_EQ(sqlite3_open(dbPath.c_str(), &raw), SQLITE_OK);
+    sqlite3_stmt *stmt = nullptr;
+    ASSERT_EQ(sqlite3_prepare_v2(raw, "SELECT filename, skip_reason, speech_ratio FROM recordings ORDER BY id;",
+                                 -1, &stmt, nullptr), SQLITE_OK);
+    ASSERT_EQ(sqlite3_step(stmt), SQLITE_ROW);
+    EXPECT_STREQ(reinterpret_cast<const char *>(sqlite3_column_text(stmt, 1)), "vad");
+    EXPECT_DOUBLE_EQ(sqlite3_column_double(stmt, 2), 0.02);
+    ASSERT_EQ(sqlite3_step(stmt), SQLITE_ROW);
+    EXPECT_STREQ(reinterpret_cast<const char *>(sqlite3_column_text(stmt, 1)), "");
+    EXPECT_EQ(sqlite3_column_type(stmt, 2), SQLITE_NULL);
+    sqlite3_finalize(stmt);
+    sqlite3_close(raw);
+    std::filesystem::remove(dbPath);
+}
+
+TEST_F(DatabaseManagerTest, AudioMetadataCacheMatchesFileVersion) {
+    sdrtrunk::FileIdentity identity{66305, 1234567, 48000, 1705330245000000000};
+    sdrtrunk::AudioMetadata metadata{12.5, 8000, 1, 16, "MPEG-2.5 Layer III"};
+    EXPECT_FALSE(dbManager->findAudioMetadata(identity).has_value());
+
+    dbManager->storeAudioMetadata(identity, metadata);
+    auto cached = dbManager->findAudioMetadata(identity);
+    ASSERT_TRUE(cached.has_value());
+    EXPECT_DOUBLE_EQ(cached->durationSeconds, 12.5);
+    EXPECT_EQ(cached->sampleRate, 8000);
+    EXPECT_EQ(cached->channels, 1);
+    EXPECT_EQ(cached->bitrateKbps, 16);
+    EXPECT_EQ(cached->format, "MPEG-2.5 Layer III");
+
+    // Same inode, rewritten: a miss until stored again, which replaces the row
+    sdrtrunk::FileIdentity rewritten = identity;
+    rewritten.size += 100;
+    rewritten.mtimeNs += 1;
+    EXPECT_FALSE(dbManager->findAudioMetadata(rewritten).has_value());
+    metadata.durationSeconds = 13.0;
+    dbManager->storeAudioMetadata(rewritten, metadata);
+    EXPECT_DOUBLE_EQ(dbManager->findAudioMetadata(rewritten)->durationSeconds, 13.0);
+    EXPECT_FALSE(dbManager->findAudioMetadata(identity).has_value());
+
+    // Identities without an inode are never cached
+    sdrtrunk::FileIdentity unknown;
+    dbManager->storeAudioMetadata(unknown, metadata);
+    EXPECT_FALSE(dbManager->findAudioMetadata(unknown).has_value());
+}
+
+TEST_F(DatabaseManagerTest, PatchMembersFoundByTalkgroup) {
+    const std::string patched = "20260208_121343_NC__TO_P52197-[52198--51426--56881]_FROM_2499843.mp3";
+    const auto talkgroups = sdrtrunk::recordingTalkgroups(sdrtrunk::parseSdrTrunkFilename(patched));
+    EXPECT_EQ(talkgroups, (std::vector<int>{52198, 51426, 56881, 52197}));
+
+    dbManager->insertRecording("20260208", "121343", 1770570823, 52198, "NC", 2499843, 4.0,
+                               patched, "/tmp/" + patched, "", "", "", -1.0, "", talkgroups);
+    // A second insert of the same file is ignored along with its talkgroups
+    dbManager->insertRecording("20260208", "121343", 1770570823, 52198, "NC", 2499843, 4.0,
+                               patched, "/tmp/" + patched, "", "", "", -1.0, "", talkgroups);
+    dbManager->insertRecording("20260208", "121500", 1770570900, 51426, "NC", 7, 3.0,
+                               "single.mp3", "/tmp/single.mp3", "", "");
+
+    EXPECT_EQ(dbManager->findRecordingsByTalkgroup(51426, 1770570000, 1770571000),
+              (std::vector<std::string>{patched, "single.mp3"}));
+    EXPECT_EQ(dbManager->findRecordingsByTalkgroup(52197, 1770570000, 1770571000),
+              (std::vector<std::string>{patched}));
+    EXPECT_EQ(dbManager->findRecordingsByTalkgroup(51426, 1770570850, 1770571000),
+              (std::vector<std::string>{"single.mp3"}));
+    EXPECT_TRUE(dbManager->findRecordingsByTalkgroup(99999, 0, 1770571000).empty());
+}
+
+TEST_F(DatabaseManagerTest, TalkgroupLookupSeeksIndexAndBackfills) {
+    std::string dbPath = getTempDir() + "recording_talkgroups_test.db";
+    std::filesystem::remove(dbPath);
+    const std::string patched = "20260208_121343_NC__TO_P52197-[52198--51426]_FROM_2499843.mp3";
+    {
+        DatabaseManager db(dbPath);
+        db.createTable();
+        db.insertRecording("20260208", "121343", 1770570823, 52198, "NC", 2499843, 4.0,
+                           patched, "/tmp/" + patched, "", "");
+    }
+
+    sqlite3 *raw = nullptr;
+    ASSERT_EQ(sqlite3_open(dbPath.c_str(), &raw), SQLITE_OK);
+    sqlite3_stmt *stmt = nullptr;
+    ASSERT_EQ(sqlite3_prepare_v2(raw,
+                                 "EXPLAIN QUERY PLAN SELECT recording_id FROM recording_talkgroups "
+                                 "WHERE talkgroup_id = 51426 AND unixtime BETWEEN 0 AND 2000000000;",
+                                 -1, &stmt, nullptr), SQLITE_OK);
+    std::string plan;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        plan += reinterpret_cast<const char *>(sqlite3_column_text(stmt, 3));
+    }
+    sqlite3_finalize(stmt);
+    EXPECT_NE(plan.find("idx_recording_talkgroups_talkgroup_unixtime"), std::string::npos) << plan;
+
+    // Databases from before the table get it filled from their filenames
+    ASSERT_EQ(sqlite3_exec(raw, "DELETE FROM recording_talkgroups;", nullptr, nullptr, nullptr), SQLITE_OK);
+    sqlite3_close(raw);
+    {
+        DatabaseManager db(dbPath);
+        db.createTable();
+        EXPECT_EQ(db.findRecordingsByTalkgroup(51426, 0, 2000000000), (std::vector<std::string>{patched}));
+        EXPECT_EQ(db.findRecordingsByTalkgroup(52198, 0, 2000000000), (std::vector<std::string>{patched}));
+    }
+    std::filesystem::remove(dbPath);
+}
+
+TEST_F(DatabaseManagerTest, ReadsTranscriptionsInPagesAndUpdatesInBatches) {
+    const std::string text = R"({"text":"unit on scene"})";
+    dbManager->insertRecording("20260208", "000001", 1000, 100, "NC", 1, 1.0, "a.mp3", "/tmp/a.mp3", text, "old");
+    dbManager->insertRecording("20260208", "000002", 1500, 100, "NC", 1, 1.0, "skipped.mp3", "/tmp/skipped.mp3", "", "", "vad");
+    dbManager->insertRecording("20260208", "000003", 2000, 100, "NC", 2, 1.0, "b.mp3", "/tmp/b.mp3", text, "old");
+    dbManager->insertRecording("20260208", "000004", 2500, 200, "NC", 3, 1.0, "c.mp3", "/tmp/c.mp3", text, "old");
+    dbManager->insertRecording("20260208", "000005", 3000, 100, "NC", 4, 1.0, "d.mp3", "/tmp/d.mp3", text, "old");
+
+    // Skipped and untranscribed recordings are left out; pages follow id
+    auto first = dbManager->readTranscriptions({}, 0, 2);
+    ASSERT_EQ(first.size(), 2u);
+    EXPECT_EQ(first[0].radioID, 1);
+    EXPECT_EQ(first[1].radioID, 2);
+    auto rest = dbManager->readTranscriptions({}, first.back().id, 10);
+    ASSERT_EQ(rest.size(), 2u);
+    EXPECT_EQ(rest[0].talkgroupID, 200);
+    EXPECT_EQ(rest[1].transcription, text);
+    EXPECT_TRUE(dbManager->readTranscriptions({}, rest.back().id, 10).empty());
+
+    TranscriptionFilter filter;
+    filter.talkgroupID = 100;
+    filter.fromUnixtime = 1500;
+    filter.toUnixtime = 3000;
+    auto filtered = dbManager->readTranscriptions(filter, 0, 10);
+    ASSERT_EQ(filtered.size(), 1u);
+    EXPECT_EQ(filtered[0].radioID, 2);
+
+    EXPECT_EQ(dbManager->updateV2Transcriptions({}), 0u);
+    EXPECT_EQ(dbManager->updateV2Transcriptions({{first[0].id, "new a"}, {rest[1].id, "new d"}, {99999, "none"}}), 2u);
+    auto updated = dbManager->readTranscriptions({}, 0, 10);
+    ASSERT_EQ(updated.size(), 4u);
+    EXPECT_EQ(updated[0].v2transcription, "new a");
+    EXPECT_EQ(updated[1].v2transcription, "old");
+    EXPECT_EQ(updated[3].v2transcription, "new d");
+}
+
 TEST_F(DatabaseManagerTest, InvalidDatabasePath) {
     EXPECT_THROW(DatabaseManager("/invalid/path/db.sqlite"), std::runtime_error);
 }
@@ -353,6 +553,303 @@ TEST_F(TranscriptionProcessorTest, GenerateV2Transcription) {
     EXPECT_NE(result.find("police officer"), std::string::npos);
 }
 
+TEST_F(TranscriptionProcessorTest, GlossarySnapshotsSharedPerFileList) {
+    std::string overridePath = getTempDir() + "test_glossary_override.json";
+    {
+        std::ofstream file(overridePath);
+        file << R"({"officer": "deputy", "medic": "paramedic"})";
+    }
+
+    sdrtrunk::GlossaryCache cache;
+    auto first = cache.get({TEST_GLOSSARY_PATH, overridePath})->snapshot();
+    auto again = cache.get({TEST_GLOSSARY_PATH, overridePath})->snapshot();
+    auto reversed = cache.get({overridePath, TEST_GLOSSARY_PATH})->snapshot();
+    EXPECT_EQ(first.get(), again.get());
+    EXPECT_NE(first.get(), reversed.get());
+    EXPECT_EQ(cache.size(), 2u);
+
+    // The first file listed wins; hyphen variants are expanded once
+    EXPECT_EQ(first->mappings().at("officer"), "police officer");
+    EXPECT_EQ(reversed->mappings().at("officer"), "deputy");
+    EXPECT_EQ(first->mappings().at("104"), "acknowledged");
+    EXPECT_EQ(first->mappings().at("medic"), "paramedic");
+    std::filesystem::remove(overridePath);
+}
+
+TEST_F(TranscriptionProcessorTest, GenerateV2TranscriptionUsesSnapshot) {
+    TalkgroupFiles files;
+    files.glossaryFiles.push_back(TEST_GLOSSARY_PATH);
+    files.glossary = std::make_shared<sdrtrunk::GlossarySet>(files.glossaryFiles);
+    std::unordered_map<int, TalkgroupFiles> talkgroupFiles{{52198, files}};
+
+    // Lookups do not go back to the file
+    std::filesystem::remove(TEST_GLOSSARY_PATH);
+    auto result = generateV2Transcription(R"({"text":"Officer copies, 10-4"})", 52198, 12345, talkgroupFiles);
+    EXPECT_NE(result.find(R"("officer":"police officer")"), std::string::npos) << result;
+    EXPECT_NE(result.find(R"("10-4":"acknowledged")"), std::string::npos) << result;
+    EXPECT_EQ(result.find("patrol unit"), std::string::npos) << result;
+}
+
+TEST_F(TranscriptionProcessorTest, GlossarySetReloadsChangedFiles) {
+    sdrtrunk::GlossarySet set({TEST_GLOSSARY_PATH});
+    auto before = set.snapshot();
+    EXPECT_FALSE(set.reloadIfChanged());
+
+    {
+        std::ofstream file(TEST_GLOSSARY_PATH);
+        file << R"({"officer": "deputy sheriff", "medic": "paramedic"})";
+    }
+    // Published only once the file has stayed the same for a second check
+    EXPECT_FALSE(set.reloadIfChanged());
+    EXPECT_EQ(set.snapshot().get(), before.get());
+    EXPECT_TRUE(set.reloadIfChanged());
+    EXPECT_FALSE(set.reloadIfChanged());
+
+    auto after = set.snapshot();
+    EXPECT_EQ(after->mappings().at("officer"), "deputy sheriff");
+    EXPECT_EQ(after->mappings().count("unit"), 0u);
+    // A reader holding the old snapshot keeps it intact
+    EXPECT_EQ(before->mappings().at("officer"), "police officer");
+}
+
+TEST_F(TranscriptionProcessorTest, GlossaryReloadDoesNotDisturbReaders) {
+    auto set = std::make_shared<sdrtrunk::GlossarySet>(std::vector<std::string>{TEST_GLOSSARY_PATH});
+    TalkgroupFiles files;
+    files.glossaryFiles.push_back(TEST_GLOSSARY_PATH);
+    files.glossary = set;
+    const std::unordered_map<int, TalkgroupFiles> talkgroupFiles{{52198, files}};
+    const std::string transcription = R"({"text":"officer copies"})";
+
+    std::atomic<bool> done{false};
+    std::atomic<int> unexpected{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&] {
+            while (!done) {
+                auto v2 = generateV2Transcription(transcription, 52198, 1, talkgroupFiles);
+                if (v2.find("police officer") == std::string::npos && v2.find("deputy 1") == std::string::npos &&
+                    v2.find("deputy 22") == std::string::npos) {
+                    ++unexpected;
+                }
+            }
+        });
+    }
+    for (int round = 0; round < 20; ++round) {
+        {
+            std::ofstream file(TEST_GLOSSARY_PATH);
+            file << "{\"officer\": \"deputy " << (round % 2 ? "1" : "22") << "\"}";
+        }
+        set->reloadIfChanged();
+        set->reloadIfChanged();
+    }
+    done = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(unexpected.load(), 0);
+    EXPECT_NE(set->snapshot()->mappings().at("officer").find("deputy"), std::string::npos);
+}
+
+TEST_F(TranscriptionProcessorTest, GlossaryWatcherPublishesEdits) {
+    sdrtrunk::GlossaryCache cache;
+    auto set = cache.get({TEST_GLOSSARY_PATH});
+    sdrtrunk::GlossaryWatcher watcher(cache, std::chrono::milliseconds(10));
+    {
+        std::ofstream file(TEST_GLOSSARY_PATH);
+        file << R"({"officer": "trooper"})";
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (set->snapshot()->mappings().at("officer") != "trooper" && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(set->snapshot()->mappings().at("officer"), "trooper");
+}
+
+TEST(GlossaryMatcherTest, ReportsOverlappingKeysCaseInsensitively) {
+    sdrtrunk::GlossaryMatcher matcher({"he", "SHE", "his", "hers", ""});
+    std::vector<std::tuple<size_t, size_t, size_t>> hits;
+    matcher.scan("uShers", [&](size_t key, size_t begin, size_t end) { hits.emplace_back(key, begin, end); });
+    const std::vector<std::tuple<size_t, size_t, size_t>> expected{{1, 1, 4}, {0, 2, 4}, {3, 2, 6}};
+    EXPECT_EQ(hits, expected);
+
+    size_t none = 0;
+    sdrtrunk::GlossaryMatcher().scan("anything", [&](size_t, size_t, size_t) { ++none; });
+    EXPECT_EQ(none, 0u);
+}
+
+TEST_F(TranscriptionProcessorTest, GlossaryMatchesAgreeWithRegexLoop) {
+    std::string path = getTempDir() + "test_glossary_boundaries.json";
+    {
+        std::ofstream file(path);
+        file << R"({"unit": "patrol unit", "10-4": "acknowledged", "10-43": "traffic", "Signal 7": "deceased",
+                    "sq_1": "squad one", "K9": "canine", "a": "letter a", "-x": "dash x"})";
+    }
+    auto snapshot = sdrtrunk::GlossarySnapshot::build({path});
+    const std::vector<std::string> texts = {
+        "Unit 12 copies 10-4", "units and community", "10-43 on the interstate", "10-4.", "signal 7 confirmed",
+        "sq_1 and sq_12", "k9unit responding", "A unit", "a-x-y", "word -x", "", "10-410-4"};
+    for (const auto& text : texts) {
+        // The regex loop over each term in turn, so both write term order
+        std::stringstream regexOut;
+        for (size_t i = 0; i < snapshot->size(); ++i) {
+            const auto term = snapshot->term(i);
+            insertMappings(regexOut, text, {{std::string(term.key), std::string(term.value)}});
+        }
+        std::stringstream matcherOut;
+        snapshot->appendMatches(matcherOut, text);
+        EXPECT_EQ(matcherOut.str(), regexOut.str()) << text;
+    }
+    std::filesystem::remove(path);
+}
+
+TEST_F(TranscriptionProcessorTest, ReenrichRewritesChangedRowsInParallel) {
+    DatabaseManager db(":memory:");
+    db.createTable();
+    TalkgroupFiles files;
+    files.glossaryFiles = {TEST_GLOSSARY_PATH};
+    files.glossary = std::make_shared<sdrtrunk::GlossarySet>(files.glossaryFiles);
+    sdrtrunk::TalkgroupProfiles talkgroupFiles;
+    talkgroupFiles.assign({{100, 100}}, files);
+
+    const std::string current = R"({"text":"officer 0 copies 10-4"})";
+    const std::string currentV2 = generateV2Transcription(current, 100, 1000, talkgroupFiles);
+    db.insertRecording("20260208", "000000", 1000, 100, "NC", 1000, 1.0, "current.mp3", "/tmp/current.mp3", current, currentV2);
+    for (int i = 1; i <= 7; ++i) {
+        const std::string name = "stale" + std::to_string(i) + ".mp3";
+        db.insertRecording("20260208", "000000", 1000 + i, 100, "NC", 1000 + i, 1.0, name, "/tmp/" + name,
+                           R"({"text":"officer )" + std::to_string(i) + R"( with unit"})", "{}");
+    }
+    db.insertRecording("20260208", "000000", 1010, 100, "NC", 1010, 1.0, "garbled.mp3", "/tmp/garbled.mp3", "garbled", "{}");
+    db.insertRecording("20260208", "000000", 1011, 200, "NC", 1011, 1.0, "other.mp3", "/tmp/other.mp3", current, "{}");
+
+    sdrtrunk::ReenrichOptions options;
+    options.filter.talkgroupID = 100;
+    options.batchSize = 3;
+    options.threads = 4;
+    auto stats = sdrtrunk::reenrichTranscriptions(db, talkgroupFiles, options);
+    EXPECT_EQ(stats.scanned, 9u);
+    EXPECT_EQ(stats.updated, 7u);
+    EXPECT_EQ(stats.unchanged, 1u);
+    EXPECT_EQ(stats.failed, 1u);
+    for (const auto& row : db.readTranscriptions(options.filter, 0, 100)) {
+        if (row.transcription != "garbled") {
+            EXPECT_EQ(row.v2transcription, generateV2Transcription(row.transcription, 100, row.radioID, talkgroupFiles));
+            EXPECT_NE(row.v2transcription.find("police officer"), std::string::npos);
+        }
+    }
+    TranscriptionFilter other;
+    other.talkgroupID = 200;
+    EXPECT_EQ(db.readTranscriptions(other, 0, 10).at(0).v2transcription, "{}");
+
+    // Nothing left to write on a second pass, or once cancelled
+    stats = sdrtrunk::reenrichTranscriptions(db, talkgroupFiles, options);
+    EXPECT_EQ(stats.updated, 0u);
+    EXPECT_EQ(stats.unchanged, 8u);
+    std::atomic<bool> cancelled{true};
+    EXPECT_EQ(sdrtrunk::reenrichTranscriptions(db, talkgroupFiles, options, &cancelled).scanned, 0u);
+
+    auto filter = sdrtrunk::reenrichFilter(100, "20240115", "20240115");
+    ASSERT_TRUE(filter.has_value());
+    EXPECT_EQ(*filter->toUnixtime - *filter->fromUnixtime, 86400);
+    EXPECT_FALSE(sdrtrunk::reenrichFilter(std::nullopt, "2024-01-15", "").has_value());
+}
+
+TEST_F(TranscriptionProcessorTest, CompiledGlossaryMatchesJsonSnapshot) {
+    const std::string multiKeyPath = getTempDir() + "test_glossary_multikey_compile.json";
+    const std::string compiledPath = getTempDir() + "test_glossary.compiled";
+    {
+        std::ofstream file(multiKeyPath);
+        file << R"({"GLOSSARY": [{"keys": ["Medic 1", "M1", "medic one"], "value": "ambulance"},
+                                 {"keys": ["10-8"], "value": "in service"}]})";
+    }
+    auto json = sdrtrunk::GlossarySnapshot::build({TEST_GLOSSARY_PATH, multiKeyPath});
+    auto written = json->writeCompiled(compiledPath);
+    ASSERT_TRUE(written.has_value()) << written.error().toString();
+    EXPECT_TRUE(sdrtrunk::GlossarySnapshot::isCompiled(compiledPath));
+    EXPECT_FALSE(sdrtrunk::GlossarySnapshot::isCompiled(TEST_GLOSSARY_PATH));
+
+    // Listed on its own, a compiled file is mapped as it is
+    auto compiled = sdrtrunk::GlossarySnapshot::build({compiledPath});
+    ASSERT_EQ(compiled->size(), json->size());
+    for (size_t i = 0; i < json->size(); ++i) {
+        const auto term = json->term(i);
+        EXPECT_EQ(compiled->find(term.key), term.value) << term.key;
+    }
+    EXPECT_EQ(compiled->find("104"), "acknowledged");
+    EXPECT_FALSE(compiled->find("Officer").has_value());
+    EXPECT_FALSE(compiled->find("").has_value());
+
+    // Keys sharing a value share its bytes
+    const auto m1 = compiled->find("M1");
+    const auto medicOne = compiled->find("medic one");
+    ASSERT_TRUE(m1 && medicOne);
+    EXPECT_EQ(m1->data(), medicOne->data());
+
+    for (const std::string text : {"Officer on scene, unit 10-4", "M1 and medic one are 10-8", "nothing here", ""}) {
+        std::stringstream fromJson;
+        json->appendMatches(fromJson, text);
+        std::stringstream fromCompiled;
+        compiled->appendMatches(fromCompiled, text);
+        EXPECT_EQ(fromCompiled.str(), fromJson.str()) << text;
+    }
+
+    // In a longer list its terms merge like any file's, first file winning
+    const std::string overridePath = getTempDir() + "test_glossary_override.json";
+    std::ofstream(overridePath) << R"({"officer": "deputy"})";
+    auto merged = sdrtrunk::GlossarySnapshot::build({overridePath, compiledPath});
+    EXPECT_EQ(merged->find("officer"), "deputy");
+    EXPECT_EQ(merged->find("M1"), "ambulance");
+
+    std::filesystem::remove(overridePath);
+    std::filesystem::remove(compiledPath);
+    std::filesystem::remove(multiKeyPath);
+}
+
+TEST_F(TranscriptionProcessorTest, CompiledGlossaryRejectsDamagedFiles) {
+    const std::string compiledPath = getTempDir() + "test_glossary_damaged.compiled";
+    ASSERT_TRUE(sdrtrunk::GlossarySnapshot::build({TEST_GLOSSARY_PATH})->writeCompiled(compiledPath).has_value());
+    std::string bytes;
+    {
+        std::ifstream in(compiledPath, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    auto openDamaged = [&](const std::string& contents) {
+        std::ofstream(compiledPath, std::ios::binary | std::ios::trunc) << contents;
+        return sdrtrunk::GlossarySnapshot::openCompiled(compiledPath);
+    };
+
+    EXPECT_TRUE(openDamaged(bytes).has_value());
+    EXPECT_FALSE(openDamaged(bytes.substr(0, bytes.size() - 1)).has_value());
+    EXPECT_FALSE(openDamaged(bytes.substr(0, 16)).has_value());
+
+    std::string wrongVersion = bytes;
+    wrongVersion[8] = 2;
+    EXPECT_FALSE(openDamaged(wrongVersion).has_value());
+
+    // A transition to a state that does not exist; the transition table's
+    // offset follows the magic, six counts and the class table's offset
+    uint64_t nextOffset = 0;
+    std::memcpy(&nextOffset, bytes.data() + 40, sizeof(nextOffset));
+    std::string badState = bytes;
+    std::memset(badState.data() + nextOffset, 0xff, sizeof(uint32_t));
+    auto rejected = openDamaged(badState);
+    ASSERT_FALSE(rejected.has_value());
+    EXPECT_EQ(rejected.error().code, sdrtrunk::ErrorCode::InvalidFormat);
+
+    // The daemon carries on without the glossary
+    EXPECT_EQ(sdrtrunk::GlossarySnapshot::build({compiledPath})->size(), 0u);
+
+    // Merged with other files the daemon skips it, while a compile fails
+    auto lenient = sdrtrunk::mergeGlossaryFiles({compiledPath, TEST_GLOSSARY_PATH}, false);
+    ASSERT_TRUE(lenient.has_value());
+    EXPECT_EQ(*lenient, sdrtrunk::loadGlossaryJson(TEST_GLOSSARY_PATH).value());
+    auto strict = sdrtrunk::mergeGlossaryFiles({compiledPath, TEST_GLOSSARY_PATH}, true);
+    ASSERT_FALSE(strict.has_value());
+    EXPECT_EQ(strict.error().code, sdrtrunk::ErrorCode::InvalidFormat);
+    EXPECT_FALSE(sdrtrunk::mergeGlossaryFiles({getTempDir() + "no_such_glossary.json"}, true).has_value());
+    std::filesystem::remove(compiledPath);
+}
+
 // =============================================================================
 // CURL HELPER TESTS
 // =============================================================================
@@ -464,6 +961,1500 @@ TEST_F(FasterWhisperTest, LocalTranscribeAudioInvalidFile) {
     }
 }
 
+TEST_F(FasterWhisperTest, ModelWarmupIsIdempotent) {
+    start_model_warmup();
+    start_model_warmup();
+    // Fallback (subprocess) builds have nothing to load, so readiness is immediate
+#ifndef USE_PYBIND11
+    EXPECT_TRUE(wait_for_model_ready().has_value());
+#endif
+}
+
+// =============================================================================
+// PCM DECODE TESTS
+// =============================================================================
+
+TEST(PcmDecodeTest, ResampleSameRateIsIdentity) {
+    std::vector<float> in = {0.0f, 0.5f, -0.5f, 1.0f};
+    auto out = sdrtrunk::resamplePcm(in, 16000, 16000);
+    EXPECT_EQ(out, in);
+}
+
+TEST(PcmDecodeTest, ResampleUpsample8kTo16k) {
+    std::vector<float> in = {0.0f, 1.0f, 0.0f, -1.0f};
+    auto out = sdrtrunk::resamplePcm(in, 8000, 16000);
+    ASSERT_EQ(out.size(), 7u);
+    EXPECT_FLOAT_EQ(out[0], 0.0f);
+    EXPECT_FLOAT_EQ(out[1], 0.5f);
+    EXPECT_FLOAT_EQ(out[2], 1.0f);
+    EXPECT_FLOAT_EQ(out[5], -0.5f);
+    EXPECT_FLOAT_EQ(out[6], -1.0f);
+}
+
+TEST(PcmDecodeTest, ResampleDownsamplePreservesDuration) {
+    std::vector<float> in(44100, 0.25f);
+    auto out = sdrtrunk::resamplePcm(in, 44100, 16000);
+    EXPECT_NEAR(static_cast<double>(out.size()), 16000.0, 1.0);
+    EXPECT_FLOAT_EQ(out.back(), 0.25f);
+}
+
+TEST(PcmDecodeTest, ResampleEmptyInput) {
+    EXPECT_TRUE(sdrtrunk::resamplePcm({}, 8000, 16000).empty());
+}
+
+TEST(PcmDecodeTest, DecodeNonexistentFileFails) {
+    auto result = sdrtrunk::decodeMP3ToPcm("/nonexistent/file.mp3");
+    EXPECT_FALSE(result.has_value());
+}
+
+// =============================================================================
+// AUDIO CONVERSION TESTS
+// =============================================================================
+
+namespace {
+
+std::vector<float> sineWave(size_t n, double hz, int rate, double amplitude) {
+    std::vector<float> out(n);
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = static_cast<float>(amplitude * std::sin(2.0 * std::numbers::pi * hz * static_cast<double>(i) / rate));
+    }
+    return out;
+}
+
+std::vector<int16_t> toInt16(const std::vector<float>& x) {
+    std::vector<int16_t> out(x.size());
+    for (size_t i = 0; i < x.size(); ++i) {
+        out[i] = static_cast<int16_t>(std::lround(x[i] * 32767.0f));
+    }
+    return out;
+}
+
+std::vector<float> resampleAll(const std::vector<float>& in, int inRate, int outRate) {
+    sdrtrunk::PolyphaseResampler resampler(inRate, outRate);
+    std::vector<float> out;
+    resampler.push(std::span<const float>(in), out);
+    resampler.finish(out);
+    return out;
+}
+
+} // namespace
+
+TEST(AudioConvertTest, Int16KernelMatchesScalarReference) {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> dist(-32768, 32767);
+    // Odd frame counts exercise the vector tails
+    for (int channels : {1, 2, 3}) {
+        for (size_t frames : {0u, 1u, 5u, 15u, 17u, 1001u}) {
+            std::vector<int16_t> in(frames * static_cast<size_t>(channels));
+            for (auto& v : in) v = static_cast<int16_t>(dist(rng));
+            std::vector<float> out(frames, 99.0f);
+            sdrtrunk::audio::int16ToMonoFloat(in, channels, out.data());
+            for (size_t f = 0; f < frames; ++f) {
+                double sum = 0.0;
+                for (int c = 0; c < channels; ++c) sum += in[f * static_cast<size_t>(channels) + static_cast<size_t>(c)];
+                EXPECT_NEAR(out[f], sum / channels / 32768.0, 1e-6) << "channels=" << channels << " frame=" << f;
+            }
+        }
+    }
+}
+
+TEST(AudioConvertTest, DotMatchesScalarReference) {
+    for (size_t n : {0u, 1u, 7u, 16u, 32u, 33u, 100u}) {
+        std::vector<float> a(n), b(n);
+        double expected = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            a[i] = static_cast<float>(std::sin(static_cast<double>(i)));
+            b[i] = static_cast<float>(std::cos(static_cast<double>(i) * 0.3));
+            expected += static_cast<double>(a[i]) * static_cast<double>(b[i]);
+        }
+        EXPECT_NEAR(sdrtrunk::audio::dot(a, b), expected, 1e-4) << "n=" << n;
+    }
+}
+
+TEST(AudioConvertTest, ReducesSdrtrunkRates) {
+    sdrtrunk::PolyphaseResampler from8k(8000, 16000);
+    EXPECT_EQ(from8k.upFactor(), 2);
+    EXPECT_EQ(from8k.downFactor(), 1);
+    sdrtrunk::PolyphaseResampler from22k(22050, 16000);
+    EXPECT_EQ(from22k.upFactor(), 320);
+    EXPECT_EQ(from22k.downFactor(), 441);
+    sdrtrunk::PolyphaseResampler from44k(44100, 16000);
+    EXPECT_EQ(from44k.upFactor(), 160);
+    EXPECT_EQ(from44k.downFactor(), 441);
+}
+
+TEST(AudioConvertTest, OutputLengthFollowsRatio) {
+    for (int rate : {8000, 22050, 44100, 48000}) {
+        std::vector<float> in(static_cast<size_t>(rate), 0.0f);
+        EXPECT_EQ(resampleAll(in, rate, 16000).size(), 16000u) << rate;
+    }
+}
+
+TEST(AudioConvertTest, SameRatePassesThrough) {
+    std::vector<int16_t> in = {0, 16384, -16384, 32767, -32768};
+    sdrtrunk::PolyphaseResampler resampler(16000, 16000);
+    std::vector<float> out;
+    resampler.push(std::span<const int16_t>(in), 1, out);
+    resampler.finish(out);
+    ASSERT_EQ(out.size(), in.size());
+    EXPECT_FLOAT_EQ(out[1], 0.5f);
+    EXPECT_FLOAT_EQ(out[4], -1.0f);
+}
+
+TEST(AudioConvertTest, PreservesInBandToneAndTiming) {
+    // A 1 kHz tone lands where the ideal 16 kHz tone is, away from the edges
+    for (int rate : {8000, 22050, 44100}) {
+        auto out = resampleAll(sineWave(static_cast<size_t>(rate), 1000.0, rate, 0.5), rate, 16000);
+        auto ideal = sineWave(out.size(), 1000.0, 16000, 0.5);
+        double maxError = 0.0;
+        for (size_t i = 64; i + 64 < out.size(); ++i) {
+            maxError = std::max(maxError, std::abs(static_cast<double>(out[i] - ideal[i])));
+        }
+        EXPECT_LT(maxError, 0.01) << rate;
+    }
+}
+
+TEST(AudioConvertTest, RejectsAliasingAboveNewNyquist) {
+    // 12 kHz is above 8 kHz Nyquist and would alias to 4 kHz unfiltered
+    auto out = resampleAll(sineWave(44100, 12000.0, 44100, 0.5), 44100, 16000);
+    double sumSq = 0.0;
+    for (size_t i = 64; i + 64 < out.size(); ++i) sumSq += static_cast<double>(out[i]) * static_cast<double>(out[i]);
+    double rms = std::sqrt(sumSq / static_cast<double>(out.size() - 128));
+    EXPECT_LT(rms, 0.5 / std::sqrt(2.0) * 1e-3);  // below -60 dB
+}
+
+TEST(AudioConvertTest, StereoDownmixIsFusedWithResampling) {
+    // Left and right in antiphase cancel; equal channels keep their level
+    auto tone = sineWave(22050, 440.0, 22050, 0.5);
+    auto pcm = toInt16(tone);
+    std::vector<int16_t> cancel(pcm.size() * 2), same(pcm.size() * 2);
+    for (size_t i = 0; i < pcm.size(); ++i) {
+        cancel[2 * i] = pcm[i];
+        cancel[2 * i + 1] = static_cast<int16_t>(-pcm[i]);
+        same[2 * i] = same[2 * i + 1] = pcm[i];
+    }
+    sdrtrunk::PolyphaseResampler a(22050, 16000), b(22050, 16000);
+    std::vector<float> outCancel, outSame;
+    a.push(std::span<const int16_t>(cancel), 2, outCancel);
+    a.finish(outCancel);
+    b.push(std::span<const int16_t>(same), 2, outSame);
+    b.finish(outSame);
+    ASSERT_EQ(outCancel.size(), 16000u);
+    EXPECT_LT(*std::max_element(outCancel.begin(), outCancel.end()), 1e-3f);
+    EXPECT_NEAR(*std::max_element(outSame.begin() + 64, outSame.end() - 64), 0.5f, 0.01f);
+}
+
+TEST(AudioConvertTest, ChunkedPushMatchesSinglePush) {
+    auto in = sineWave(22050, 700.0, 22050, 0.8);
+    auto whole = resampleAll(in, 22050, 16000);
+
+    sdrtrunk::PolyphaseResampler resampler(22050, 16000);
+    std::vector<float> chunked;
+    // Uneven chunk sizes, cycled until the input runs out
+    const size_t sizes[] = {1, 7, 100, 4096, 3};
+    for (size_t offset = 0, i = 0; offset < in.size(); ++i) {
+        size_t size = std::min(sizes[i % std::size(sizes)], in.size() - offset);
+        resampler.push(std::span<const float>(in).subspan(offset, size), chunked);
+        offset += size;
+    }
+    resampler.finish(chunked);
+
+    ASSERT_EQ(chunked.size(), whole.size());
+    for (size_t i = 0; i < whole.size(); ++i) {
+        ASSERT_FLOAT_EQ(chunked[i], whole[i]) << i;
+    }
+}
+
+// =============================================================================
+// MP3 HEADER DURATION TESTS
+// =============================================================================
+
+namespace {
+sdrtrunk::Result<double> headerDuration(const SyntheticMP3& mp3) {
+    auto bytes = mp3.build();
+    return sdrtrunk::parseMP3HeaderDuration(bytes);
+}
+} // namespace
+
+TEST(MP3HeaderDurationTest, CbrFromFrameArithmetic) {
+    SyntheticMP3 mp3;  // 8 kHz MPEG-2.5, 16 kbps, as SDRTrunk writes
+    auto duration = headerDuration(mp3);
+    ASSERT_TRUE(duration.has_value()) << duration.error().toString();
+    EXPECT_DOUBLE_EQ(duration.value(), mp3.expectedSeconds());
+}
+
+TEST(MP3HeaderDurationTest, CbrWithPaddedFrames) {
+    SyntheticMP3 mp3;
+    mp3.sampleRate = 44100;
+    mp3.bitratesKbps = {128};
+    mp3.frames = 1000;
+    auto duration = headerDuration(mp3);
+    ASSERT_TRUE(duration.has_value()) << duration.error().toString();
+    EXPECT_NEAR(duration.value(), mp3.expectedSeconds(), 1152.0 / 44100.0);
+}
+
+TEST(MP3HeaderDurationTest, XingFrameCountWithLameGaplessTrim) {
+    SyntheticMP3 mp3;
+    mp3.bitratesKbps = {16, 24, 32};
+    mp3.tag = SyntheticMP3::Tag::Xing;
+    mp3.encoderDelay = 576;
+    mp3.encoderPadding = 1000;
+    auto duration = headerDuration(mp3);
+    ASSERT_TRUE(duration.has_value()) << duration.error().toString();
+    EXPECT_DOUBLE_EQ(duration.value(), mp3.expectedSeconds());
+}
+
+TEST(MP3HeaderDurationTest, InfoTagOnCbr) {
+    SyntheticMP3 mp3;
+    mp3.tag = SyntheticMP3::Tag::Info;
+    mp3.encoderDelay = 1105;
+    auto duration = headerDuration(mp3);
+    ASSERT_TRUE(duration.has_value());
+    EXPECT_DOUBLE_EQ(duration.value(), mp3.expectedSeconds());
+}
+
+TEST(MP3HeaderDurationTest, VbriFrameCount) {
+    SyntheticMP3 mp3;
+    mp3.sampleRate = 22050;
+    mp3.bitratesKbps = {32, 64};
+    mp3.tag = SyntheticMP3::Tag::Vbri;
+    auto duration = headerDuration(mp3);
+    ASSERT_TRUE(duration.has_value()) << duration.error().toString();
+    EXPECT_DOUBLE_EQ(duration.value(), mp3.expectedSeconds());
+}
+
+TEST(MP3HeaderDurationTest, SkipsId3Tags) {
+    SyntheticMP3 mp3;
+    mp3.id3v2Bytes = 3000;
+    mp3.id3v1 = true;
+    auto duration = headerDuration(mp3);
+    ASSERT_TRUE(duration.has_value()) << duration.error().toString();
+    EXPECT_DOUBLE_EQ(duration.value(), mp3.expectedSeconds());
+}
+
+TEST(MP3HeaderDurationTest, UntaggedVbrFallsBack) {
+    SyntheticMP3 mp3;
+    mp3.bitratesKbps = {16, 16, 16, 16, 32};
+    EXPECT_FALSE(headerDuration(mp3).has_value());
+
+    // Bitrate changes after the leading frames are caught by the probes
+    SyntheticMP3 late;
+    auto bytes = late.build();
+    SyntheticMP3 tail;
+    tail.bitratesKbps = {32};
+    auto tailBytes = tail.build();
+    bytes.insert(bytes.end(), tailBytes.begin(), tailBytes.end());
+    EXPECT_FALSE(sdrtrunk::parseMP3HeaderDuration(bytes).has_value());
+}
+
+TEST(MP3HeaderDurationTest, TruncatedXingFileFallsBack) {
+    SyntheticMP3 mp3;
+    mp3.tag = SyntheticMP3::Tag::Xing;
+    auto bytes = mp3.build();
+    bytes.resize(bytes.size() / 2);  // still being written
+    EXPECT_FALSE(sdrtrunk::parseMP3HeaderDuration(bytes).has_value());
+}
+
+TEST(MP3HeaderDurationTest, RejectsNonMpegData) {
+    std::vector<unsigned char> junk(4096);
+    for (size_t i = 0; i < junk.size(); ++i) {
+        junk[i] = static_cast<unsigned char>(i % 256);
+    }
+    EXPECT_FALSE(sdrtrunk::parseMP3HeaderDuration(junk).has_value());
+    EXPECT_FALSE(sdrtrunk::parseMP3HeaderDuration({}).has_value());
+}
+
+TEST(MP3HeaderDurationTest, GetMP3DurationReadsHeaderFromFile) {
+    SyntheticMP3 mp3;
+    mp3.tag = SyntheticMP3::Tag::Xing;
+    mp3.frames = 2000;
+    std::string path = getTempDir() + "synthetic_header_test.mp3";
+    mp3.write(path);
+    auto duration = sdrtrunk::getMP3Duration(path);
+    std::filesystem::remove(path);
+    ASSERT_TRUE(duration.has_value()) << duration.error().toString();
+    EXPECT_DOUBLE_EQ(duration.value(), mp3.expectedSeconds());
+}
+
+// =============================================================================
+// MPG123 HANDLE POOL TESTS
+// =============================================================================
+
+TEST(Mpg123PoolTest, ReleasedHandleIsReusedForSameFlags) {
+    std::thread([] {
+        {
+            auto lease = sdrtrunk::openMpg123Feed(MPG123_GAPLESS);
+            ASSERT_TRUE(lease.has_value()) << lease.error().toString();
+            EXPECT_NE(lease->get(), nullptr);
+        }
+        auto first = sdrtrunk::mpg123ThreadPoolStats();
+        EXPECT_EQ(first.created, 1u);
+        EXPECT_EQ(first.idle, 1u);
+
+        auto again = sdrtrunk::openMpg123Feed(MPG123_GAPLESS);
+        ASSERT_TRUE(again.has_value());
+        auto second = sdrtrunk::mpg123ThreadPoolStats();
+        EXPECT_EQ(second.created, 1u);
+        EXPECT_EQ(second.reused, 1u);
+        EXPECT_EQ(second.idle, 0u);
+    }).join();
+}
+
+TEST(Mpg123PoolTest, DifferentFlagsGetSeparateHandles) {
+    std::thread([] {
+        { auto lease = sdrtrunk::openMpg123Feed(MPG123_GAPLESS); }
+        auto other = sdrtrunk::openMpg123Feed(MPG123_GAPLESS | MPG123_MONO_MIX);
+        ASSERT_TRUE(other.has_value());
+        auto stats = sdrtrunk::mpg123ThreadPoolStats();
+        EXPECT_EQ(stats.created, 2u);
+        EXPECT_EQ(stats.reused, 0u);
+        EXPECT_EQ(stats.idle, 1u);
+    }).join();
+}
+
+TEST(Mpg123PoolTest, IdleHandlesAreBounded) {
+    std::thread([] {
+        {
+            std::vector<sdrtrunk::Mpg123Lease> held;
+            for (int i = 0; i < 10; ++i) {
+                auto lease = sdrtrunk::openMpg123Feed(MPG123_GAPLESS);
+                ASSERT_TRUE(lease.has_value());
+                held.push_back(std::move(lease.value()));
+            }
+        }
+        auto stats = sdrtrunk::mpg123ThreadPoolStats();
+        EXPECT_EQ(stats.created, 10u);
+        EXPECT_LE(stats.idle, 4u);
+    }).join();
+}
+
+TEST(Mpg123PoolTest, MissingFileReturnsHandleToPool) {
+    std::thread([] {
+        auto lease = sdrtrunk::openMpg123File("/nonexistent/file.mp3", MPG123_GAPLESS);
+        ASSERT_FALSE(lease.has_value());
+        EXPECT_EQ(lease.error().code, sdrtrunk::ErrorCode::FileNotFound);
+        EXPECT_EQ(sdrtrunk::mpg123ThreadPoolStats().idle, 1u);
+    }).join();
+}
+
+// =============================================================================
+// RECORDING FILE TESTS
+// =============================================================================
+
+TEST(RecordingFileTest, OpenMissingFileFails) {
+    auto file = sdrtrunk::RecordingFile::open("/nonexistent/file.mp3");
+    ASSERT_FALSE(file.has_value());
+    EXPECT_EQ(file.error().code, sdrtrunk::ErrorCode::FileNotFound);
+}
+
+TEST(RecordingFileTest, MapsContentsOnce) {
+    std::string path = getTempDir() + "recording_file_test.mp3";
+    SyntheticMP3 mp3;
+    mp3.write(path);
+    auto expected = mp3.build();
+
+    auto file = sdrtrunk::RecordingFile::open(path);
+    ASSERT_TRUE(file.has_value()) << file.error().toString();
+    EXPECT_EQ(file->size(), expected.size());
+    ASSERT_EQ(file->bytes().size(), expected.size());
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), file->bytes().begin()));
+    EXPECT_EQ(file->path(), path);
+
+    // Moving keeps the mapping valid
+    sdrtrunk::RecordingFile moved = std::move(file.value());
+    EXPECT_EQ(moved.bytes().size(), expected.size());
+    EXPECT_EQ(moved.bytes()[0], 0xFF);
+    std::filesystem::remove(path);
+}
+
+TEST(RecordingFileTest, EmptyFileHasNoBytes) {
+    std::string path = getTempDir() + "recording_file_empty.mp3";
+    std::ofstream(path).close();
+    auto file = sdrtrunk::RecordingFile::open(path);
+    ASSERT_TRUE(file.has_value());
+    EXPECT_EQ(file->size(), 0u);
+    EXPECT_TRUE(file->bytes().empty());
+    std::filesystem::remove(path);
+}
+
+TEST(RecordingFileTest, DetectsGrowthSinceOpen) {
+    std::string path = getTempDir() + "recording_file_growing.mp3";
+    std::ofstream(path, std::ios::binary) << "ID3";
+    auto file = sdrtrunk::RecordingFile::open(path);
+    ASSERT_TRUE(file.has_value());
+    EXPECT_FALSE(file->hasGrown());
+    std::ofstream(path, std::ios::binary | std::ios::app) << "more";
+    EXPECT_TRUE(file->hasGrown());
+    std::filesystem::remove(path);
+}
+
+TEST(RecordingFileTest, DurationFromOpenRecording) {
+    std::string path = getTempDir() + "recording_file_duration.mp3";
+    SyntheticMP3 mp3;
+    mp3.write(path);
+    auto file = sdrtrunk::RecordingFile::open(path);
+    ASSERT_TRUE(file.has_value());
+    auto duration = sdrtrunk::getMP3Duration(file.value());
+    ASSERT_TRUE(duration.has_value()) << duration.error().toString();
+    EXPECT_NEAR(duration.value(), mp3.expectedSeconds(), 1e-6);
+    std::filesystem::remove(path);
+}
+
+TEST(RecordingFileTest, MetadataFromOpenRecording) {
+    std::string path = getTempDir() + "recording_file_metadata.mp3";
+    SyntheticMP3 mp3;
+    mp3.id3v2Bytes = 500;
+    mp3.write(path);
+    auto file = sdrtrunk::RecordingFile::open(path);
+    ASSERT_TRUE(file.has_value());
+    auto metadata = sdrtrunk::probeMP3Metadata(file.value());
+    ASSERT_TRUE(metadata.has_value()) << metadata.error().toString();
+    EXPECT_NEAR(metadata->durationSeconds, mp3.expectedSeconds(), 1e-6);
+    EXPECT_EQ(metadata->sampleRate, 8000);
+    EXPECT_EQ(metadata->channels, 1);
+    EXPECT_EQ(metadata->bitrateKbps, 16);
+    EXPECT_EQ(metadata->format, "MPEG-2.5 Layer III");
+    std::filesystem::remove(path);
+}
+
+TEST(RecordingFileTest, IdentityChangesWhenRewritten) {
+    std::string path = getTempDir() + "recording_file_identity.mp3";
+    SyntheticMP3().write(path);
+    auto first = sdrtrunk::RecordingFile::open(path);
+    auto again = sdrtrunk::RecordingFile::open(path);
+    ASSERT_TRUE(first.has_value() && again.has_value());
+#ifndef _WIN32
+    EXPECT_TRUE(first->identity().valid());
+#endif
+    EXPECT_EQ(first->identity(), again->identity());
+    EXPECT_EQ(first->identity().size, first->size());
+
+    std::ofstream(path, std::ios::binary | std::ios::app) << "more";
+    auto rewritten = sdrtrunk::RecordingFile::open(path);
+    ASSERT_TRUE(rewritten.has_value());
+    EXPECT_NE(rewritten->identity(), first->identity());
+    EXPECT_EQ(rewritten->identity().inode, first->identity().inode);
+    std::filesystem::remove(path);
+}
+
+TEST(RecordingFileTest, UploadPartBuildsFromOpenRecording) {
+    std::string path = getTempDir() + "recording_file_upload.mp3";
+    SyntheticMP3().write(path);
+    auto file = sdrtrunk::RecordingFile::open(path);
+    ASSERT_TRUE(file.has_value());
+
+    CURL* curl = curl_easy_init();
+    ASSERT_NE(curl, nullptr);
+    curl_mime* mime = nullptr;
+    EXPECT_NO_THROW(setupCurlPostFields(curl, mime, file.value(), "prompt"));
+    EXPECT_NE(mime, nullptr);
+    curl_mime_free(mime);
+    curl_easy_cleanup(curl);
+    std::filesystem::remove(path);
+}
+
+// =============================================================================
+// WHISPER.CPP BACKEND TESTS
+// =============================================================================
+
+TEST(WhisperCppBackendTest, TranscriptionJsonEscapesText) {
+    EXPECT_EQ(sdrtrunk::makeTranscriptionJson("10-4 copy"), "{\"text\":\"10-4 copy\"}");
+    EXPECT_EQ(sdrtrunk::makeTranscriptionJson("say \"go\"\n\\"),
+              "{\"text\":\"say \\\"go\\\"\\n\\\\\"}");
+    EXPECT_EQ(sdrtrunk::makeTranscriptionJson(std::string("\x01", 1)), "{\"text\":\"\\u0001\"}");
+}
+
+TEST(WhisperCppBackendTest, CreateWithoutModelFails) {
+    auto backend = sdrtrunk::WhisperCppBackend::create({});
+    ASSERT_FALSE(backend.has_value());
+    EXPECT_EQ(backend.error().code, sdrtrunk::ErrorCode::ConfigError);
+}
+
+TEST(WhisperCppBackendTest, TranscribeSilence) {
+#ifdef USE_WHISPER_CPP
+    // Set WHISPER_CPP_TEST_MODEL to a small ggml model (e.g. ggml-tiny.en.bin)
+    const char* model = std::getenv("WHISPER_CPP_TEST_MODEL");
+    if (!model) {
+        GTEST_SKIP() << "WHISPER_CPP_TEST_MODEL not set";
+    }
+    sdrtrunk::WhisperCppConfig config;
+    config.modelPath = model;
+    config.threads = 2;
+    auto backend = sdrtrunk::WhisperCppBackend::create(config);
+    ASSERT_TRUE(backend.has_value()) << backend.error().toString();
+
+    sdrtrunk::PcmBuffer silence;
+    silence.samples.assign(sdrtrunk::WHISPER_SAMPLE_RATE, 0.0f);
+    sdrtrunk::TranscriptionRequest request;
+    request.filePath = "silence";
+    request.pcm = &silence;
+    auto result = backend.value()->transcribe(request);
+    ASSERT_TRUE(result.has_value()) << result.error().toString();
+    EXPECT_EQ(result.value().find("{\"text\":"), 0u);
+#else
+    GTEST_SKIP() << "Built without whisper.cpp";
+#endif
+}
+
+// =============================================================================
+// VOICE ACTIVITY TESTS
+// =============================================================================
+
+namespace {
+
+std::vector<float> whiteNoise(size_t n, float amplitude) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dist(-amplitude, amplitude);
+    std::vector<float> out(n);
+    for (auto &v : out) v = dist(rng);
+    return out;
+}
+
+// Harmonic-rich tone with a 150 Hz fundamental, roughly like voiced speech
+std::vector<float> voicedTone(size_t n) {
+    std::vector<float> out(n);
+    for (size_t i = 0; i < n; ++i) {
+        double t = static_cast<double>(i) / sdrtrunk::WHISPER_SAMPLE_RATE;
+        double v = 0.0;
+        for (int h = 1; h <= 5; ++h) {
+            v += std::sin(2.0 * std::numbers::pi * 150.0 * h * t) / h;
+        }
+        out[i] = static_cast<float>(0.2 * v);
+    }
+    return out;
+}
+
+} // namespace
+
+TEST(VoiceActivityTest, KernelsMatchScalarReference) {
+    // Odd lengths exercise the vector tails
+    for (size_t n : {0u, 1u, 3u, 7u, 17u, 511u, 1000u}) {
+        auto x = whiteNoise(n, 1.0f);
+        double sumSq = 0.0;
+        size_t crossings = 0;
+        for (size_t i = 0; i < n; ++i) {
+            sumSq += static_cast<double>(x[i]) * static_cast<double>(x[i]);
+            if (i > 0 && ((x[i] < 0.0f) != (x[i - 1] < 0.0f))) ++crossings;
+        }
+        EXPECT_NEAR(sdrtrunk::vad::sumOfSquares(x), sumSq, 1e-3 * (1.0 + sumSq)) << "n=" << n;
+        EXPECT_EQ(sdrtrunk::vad::zeroCrossings(x), crossings) << "n=" << n;
+    }
+}
+
+TEST(VoiceActivityTest, SpectralFlatnessSeparatesToneFromNoise) {
+    auto tone = voicedTone(512);
+    auto noise = whiteNoise(512, 0.5f);
+    EXPECT_LT(sdrtrunk::vad::spectralFlatness(tone), 0.1);
+    EXPECT_GT(sdrtrunk::vad::spectralFlatness(noise), 0.4);
+}
+
+TEST(VoiceActivityTest, SilenceHasNoSpeech) {
+    std::vector<float> silence(sdrtrunk::WHISPER_SAMPLE_RATE * 2, 0.0f);
+    auto result = sdrtrunk::analyzeVoiceActivity(silence);
+    EXPECT_EQ(result.frames, silence.size() / 512);
+    EXPECT_EQ(result.speechFrames, 0u);
+}
+
+TEST(VoiceActivityTest, NoiseIsRejectedAndToneAccepted) {
+    auto noise = whiteNoise(sdrtrunk::WHISPER_SAMPLE_RATE * 2, 0.5f);
+    auto tone = voicedTone(sdrtrunk::WHISPER_SAMPLE_RATE * 2);
+    EXPECT_LT(sdrtrunk::analyzeVoiceActivity(noise).speechRatio(), 0.05);
+    EXPECT_GT(sdrtrunk::analyzeVoiceActivity(tone).speechRatio(), 0.95);
+}
+
+TEST(VoiceActivityTest, YamlDoubleThresholds) {
+    YamlNode config = YamlParser::parseString("VAD_MIN_SPEECH_RATIO: 0.25\nVAD_ENERGY_THRESHOLD_DB: -40\n");
+    EXPECT_DOUBLE_EQ(config["VAD_MIN_SPEECH_RATIO"].as<double>(), 0.25);
+    EXPECT_DOUBLE_EQ(config["VAD_ENERGY_THRESHOLD_DB"].as<double>(), -40.0);
+}
+
+// =============================================================================
+// AUDIO FINGERPRINT TESTS
+// =============================================================================
+
+namespace {
+
+// Two-tone chords changing every 100 ms, a stand-in for one radio call
+std::vector<float> syntheticCall(unsigned seed, double seconds) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> freq(300.0, 3000.0);
+    std::uniform_real_distribution<double> level(0.05, 0.25);
+    std::vector<float> out(static_cast<size_t>(seconds * sdrtrunk::WHISPER_SAMPLE_RATE));
+    double f1 = 0.0, f2 = 0.0, a1 = 0.0, a2 = 0.0;
+    for (size_t i = 0; i < out.size(); ++i) {
+        if (i % 1600 == 0) {
+            f1 = freq(rng);
+            f2 = freq(rng);
+            a1 = level(rng);
+            a2 = level(rng);
+        }
+        double t = static_cast<double>(i) / sdrtrunk::WHISPER_SAMPLE_RATE;
+        out[i] = static_cast<float>(a1 * std::sin(2.0 * std::numbers::pi * f1 * t) + a2 * std::sin(2.0 * std::numbers::pi * f2 * t));
+    }
+    return out;
+}
+
+// The same call as heard by another site: different start and end, gain and noise
+std::vector<float> otherSiteCopy(const std::vector<float>& call, size_t startSkip, size_t endSkip, float gain) {
+    std::mt19937 rng(99);
+    std::normal_distribution<float> noise(0.0f, 0.02f);
+    std::vector<float> out(call.begin() + static_cast<std::ptrdiff_t>(startSkip), call.end() - static_cast<std::ptrdiff_t>(endSkip));
+    for (auto& v : out) v = v * gain + noise(rng);
+    return out;
+}
+
+} // namespace
+
+TEST(AudioFingerprintTest, MatchesCopyWithDifferentStartAndEnd) {
+    auto call = syntheticCall(1, 12.0);
+    // 0.37 s later start (not a whole analysis hop) and 0.8 s earlier end
+    auto copy = otherSiteCopy(call, 5920, 12800, 0.5f);
+    auto a = sdrtrunk::computeFingerprint(call);
+    auto b = sdrtrunk::computeFingerprint(copy);
+    EXPECT_GT(sdrtrunk::fingerprintSimilarity(a, b), 0.5);
+    EXPECT_TRUE(sdrtrunk::isNearDuplicate(a, b));
+    EXPECT_TRUE(sdrtrunk::isNearDuplicate(b, a));
+}
+
+TEST(AudioFingerprintTest, RejectsDifferentCall) {
+    auto a = sdrtrunk::computeFingerprint(syntheticCall(1, 12.0));
+    auto b = sdrtrunk::computeFingerprint(syntheticCall(2, 12.0));
+    EXPECT_LT(sdrtrunk::fingerprintSimilarity(a, b), 0.05);
+    EXPECT_FALSE(sdrtrunk::isNearDuplicate(a, b));
+}
+
+TEST(AudioFingerprintTest, ShortClipOfLongCallIsNotDuplicate) {
+    auto call = syntheticCall(3, 20.0);
+    std::vector<float> clip(call.begin(), call.begin() + 3 * sdrtrunk::WHISPER_SAMPLE_RATE);
+    auto a = sdrtrunk::computeFingerprint(call);
+    auto b = sdrtrunk::computeFingerprint(clip);
+    EXPECT_GT(sdrtrunk::fingerprintSimilarity(a, b), 0.5);
+    EXPECT_FALSE(sdrtrunk::isNearDuplicate(a, b));
+}
+
+TEST(AudioFingerprintTest, SilenceHasNoLandmarks) {
+    std::vector<float> silence(sdrtrunk::WHISPER_SAMPLE_RATE * 5, 0.0f);
+    auto fingerprint = sdrtrunk::computeFingerprint(silence);
+    EXPECT_TRUE(fingerprint.landmarks.empty());
+    EXPECT_NEAR(fingerprint.durationSeconds(), 5.0, 0.05);
+    EXPECT_FALSE(sdrtrunk::isNearDuplicate(fingerprint, fingerprint));
+}
+
+TEST(AudioFingerprintTest, SerializeRoundTrip) {
+    auto fingerprint = sdrtrunk::computeFingerprint(syntheticCall(4, 4.0));
+    ASSERT_FALSE(fingerprint.landmarks.empty());
+    auto bytes = fingerprint.serialize();
+    EXPECT_EQ(bytes.size(), 8 + fingerprint.landmarks.size() * 8);
+
+    auto decoded = sdrtrunk::AudioFingerprint::deserialize(bytes);
+    EXPECT_EQ(decoded.frames, fingerprint.frames);
+    ASSERT_EQ(decoded.landmarks.size(), fingerprint.landmarks.size());
+    for (size_t i = 0; i < decoded.landmarks.size(); ++i) {
+        EXPECT_EQ(decoded.landmarks[i].hash, fingerprint.landmarks[i].hash);
+        EXPECT_EQ(decoded.landmarks[i].frame, fingerprint.landmarks[i].frame);
+    }
+
+    bytes.pop_back();
+    EXPECT_TRUE(sdrtrunk::AudioFingerprint::deserialize(bytes).landmarks.empty());
+}
+
+TEST(AudioFingerprintTest, StoredFingerprintsAreFoundByTime) {
+    DatabaseManager db(":memory:");
+    db.createTable();
+    auto bytes = sdrtrunk::computeFingerprint(syntheticCall(5, 6.0)).serialize();
+    db.insertFingerprint("early.mp3", 52198, 1705330000, bytes, "{\"text\":\"early\"}");
+    db.insertFingerprint("near.mp3", 52199, 1705330245, bytes, "{\"text\":\"near\"}");
+    db.insertFingerprint("untranscribed.mp3", 52198, 1705330246, bytes, "");
+
+    auto found = db.findFingerprintsNear(1705330250, 10);
+    ASSERT_EQ(found.size(), 1u);
+    EXPECT_EQ(found[0].filename, "near.mp3");
+    EXPECT_EQ(found[0].talkgroupID, 52199);
+    EXPECT_EQ(found[0].fingerprint, bytes);
+    EXPECT_EQ(found[0].transcription, "{\"text\":\"near\"}");
+    EXPECT_TRUE(db.findFingerprintsNear(1705340000, 10).empty());
+}
+
+// =============================================================================
+// TRANSCRIPTION ROUTER TESTS
+// =============================================================================
+
+class FakeBackend : public sdrtrunk::TranscriptionBackend {
+public:
+    explicit FakeBackend(std::string name) : name_(std::move(name)) {}
+    sdrtrunk::Result<std::string> transcribe(const sdrtrunk::TranscriptionRequest&) override {
+        ++calls;
+        return sdrtrunk::makeTranscriptionJson(name_);
+    }
+    std::string name() const override { return name_; }
+    int calls = 0;
+
+private:
+    std::string name_;
+};
+
+class TranscriptionRouterTest : public ::testing::Test {
+protected:
+    sdrtrunk::TranscriptionRouter makeRouter(sdrtrunk::RoutingRules rules) {
+        return sdrtrunk::TranscriptionRouter(local, remote, std::move(rules), [this]() { return headroom; });
+    }
+
+    static sdrtrunk::TranscriptionRequest request(int talkgroup, double seconds) {
+        sdrtrunk::TranscriptionRequest req;
+        req.filePath = "clip.mp3";
+        req.talkgroupId = talkgroup;
+        req.durationSeconds = seconds;
+        return req;
+    }
+
+    std::shared_ptr<FakeBackend> local = std::make_shared<FakeBackend>("local");
+    std::shared_ptr<FakeBackend> remote = std::make_shared<FakeBackend>("remote");
+    int headroom = 50;
+};
+
+TEST_F(TranscriptionRouterTest, DefaultRulesStayLocal) {
+    auto router = makeRouter({});
+    EXPECT_EQ(router.choose(request(100, 120.0)), sdrtrunk::Route::Local);
+}
+
+TEST_F(TranscriptionRouterTest, LongRecordingsGoRemote) {
+    sdrtrunk::RoutingRules rules;
+    rules.localMaxDurationSeconds = 30.0;
+    auto router = makeRouter(rules);
+    EXPECT_EQ(router.choose(request(100, 10.0)), sdrtrunk::Route::Local);
+    EXPECT_EQ(router.choose(request(100, 45.0)), sdrtrunk::Route::Remote);
+}
+
+TEST_F(TranscriptionRouterTest, NoHeadroomKeepsWorkLocal) {
+    sdrtrunk::RoutingRules rules;
+    rules.localMaxDurationSeconds = 30.0;
+    rules.remoteMinHeadroom = 5;
+    auto router = makeRouter(rules);
+    headroom = 4;
+    EXPECT_EQ(router.choose(request(100, 45.0)), sdrtrunk::Route::Local);
+    headroom = 5;
+    EXPECT_EQ(router.choose(request(100, 45.0)), sdrtrunk::Route::Remote);
+}
+
+TEST_F(TranscriptionRouterTest, PinnedTalkgroupsOverrideRules) {
+    sdrtrunk::RoutingRules rules;
+    rules.localMaxDurationSeconds = 30.0;
+    rules.localTalkgroups = {200};
+    rules.remoteTalkgroups = {300};
+    auto router = makeRouter(rules);
+    EXPECT_EQ(router.choose(request(200, 90.0)), sdrtrunk::Route::Local);
+    EXPECT_EQ(router.choose(request(300, 5.0)), sdrtrunk::Route::Remote);
+}
+
+TEST_F(TranscriptionRouterTest, OverflowSpillsToRemote) {
+    sdrtrunk::RoutingRules rules;
+    rules.localMaxInFlight = 1;
+
+    // A local backend that asks the router for the next decision while busy
+    class BusyBackend : public sdrtrunk::TranscriptionBackend {
+    public:
+        sdrtrunk::TranscriptionRouter* router = nullptr;
+        sdrtrunk::Route whileBusy = sdrtrunk::Route::Local;
+        sdrtrunk::Result<std::string> transcribe(const sdrtrunk::TranscriptionRequest& req) override {
+            whileBusy = router->choose(req);
+            return sdrtrunk::makeTranscriptionJson("busy");
+        }
+        std::string name() const override { return "busy"; }
+    };
+    auto busy = std::make_shared<BusyBackend>();
+    sdrtrunk::TranscriptionRouter router(busy, remote, rules, [this]() { return headroom; });
+    busy->router = &router;
+
+    ASSERT_TRUE(router.transcribe(request(100, 5.0)).has_value());
+    EXPECT_EQ(busy->whileBusy, sdrtrunk::Route::Remote);
+    EXPECT_EQ(router.localInFlight(), 0);
+    EXPECT_EQ(router.choose(request(100, 5.0)), sdrtrunk::Route::Local);
+}
+
+TEST_F(TranscriptionRouterTest, ConcurrentWorkersRespectInFlightLimit) {
+    sdrtrunk::RoutingRules rules;
+    rules.localMaxInFlight = 2;
+
+    // Local work blocks until every worker has been routed
+    class GatedBackend : public sdrtrunk::TranscriptionBackend {
+    public:
+        std::atomic<int> calls{0};
+        std::atomic<bool> open{false};
+        sdrtrunk::Result<std::string> transcribe(const sdrtrunk::TranscriptionRequest&) override {
+            ++calls;
+            while (!open.load()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            return sdrtrunk::makeTranscriptionJson("gated");
+        }
+        std::string name() const override { return "gated"; }
+    };
+    class CountingBackend : public sdrtrunk::TranscriptionBackend {
+    public:
+        std::atomic<int> calls{0};
+        sdrtrunk::Result<std::string> transcribe(const sdrtrunk::TranscriptionRequest&) override {
+            ++calls;
+            return sdrtrunk::makeTranscriptionJson("remote");
+        }
+        std::string name() const override { return "counting"; }
+    };
+    auto gated = std::make_shared<GatedBackend>();
+    auto counting = std::make_shared<CountingBackend>();
+    sdrtrunk::TranscriptionRouter router(gated, counting, rules, [this]() { return headroom; });
+
+    constexpr int workers = 16;
+    std::atomic<bool> start{false};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < workers; ++i) {
+        threads.emplace_back([&]() {
+            while (!start.load()) {
+                std::this_thread::yield();
+            }
+            EXPECT_TRUE(router.transcribe(request(100, 5.0)).has_value());
+        });
+    }
+    start = true;
+    while (counting->calls.load() < workers - rules.localMaxInFlight) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(router.localInFlight(), rules.localMaxInFlight);
+    gated->open = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(gated->calls.load(), rules.localMaxInFlight);
+    EXPECT_EQ(counting->calls.load(), workers - rules.localMaxInFlight);
+    EXPECT_EQ(router.localInFlight(), 0);
+}
+
+TEST_F(TranscriptionRouterTest, DispatchesToChosenBackend) {
+    sdrtrunk::RoutingRules rules;
+    rules.localMaxDurationSeconds = 30.0;
+    auto router = makeRouter(rules);
+    auto shortClip = router.transcribe(request(100, 5.0));
+    auto longClip = router.transcribe(request(100, 60.0));
+    ASSERT_TRUE(shortClip.has_value());
+    ASSERT_TRUE(longClip.has_value());
+    EXPECT_EQ(shortClip.value(), "{\"text\":\"local\"}");
+    EXPECT_EQ(longClip.value(), "{\"text\":\"remote\"}");
+    EXPECT_EQ(local->calls, 1);
+    EXPECT_EQ(remote->calls, 1);
+}
+
+TEST_F(TranscriptionRouterTest, MissingBackendUsesTheOther) {
+    sdrtrunk::TranscriptionRouter remoteOnly(nullptr, remote, {}, nullptr);
+    sdrtrunk::TranscriptionRouter localOnly(local, nullptr, {}, nullptr);
+    EXPECT_EQ(remoteOnly.choose(request(100, 5.0)), sdrtrunk::Route::Remote);
+    EXPECT_EQ(localOnly.choose(request(100, 500.0)), sdrtrunk::Route::Local);
+}
+
+// =============================================================================
+// TIERED TRANSCRIPTION TESTS
+// =============================================================================
+
+TEST(TranscriptionConfidenceTest, ParsesReportedFields) {
+    auto confidence = sdrtrunk::parseTranscriptionConfidence(
+        "{\"text\":\"engine 4 responding\",\"avg_logprob\":-0.3125,\"no_speech_prob\":0.02}");
+    ASSERT_TRUE(confidence.avgLogprob.has_value());
+    ASSERT_TRUE(confidence.noSpeechProb.has_value());
+    EXPECT_DOUBLE_EQ(*confidence.avgLogprob, -0.3125);
+    EXPECT_DOUBLE_EQ(*confidence.noSpeechProb, 0.02);
+}
+
+TEST(TranscriptionConfidenceTest, MissingOrInvalidFieldsAreEmpty) {
+    auto plain = sdrtrunk::parseTranscriptionConfidence("{\"text\":\"hello\"}");
+    EXPECT_FALSE(plain.avgLogprob.has_value());
+    EXPECT_FALSE(plain.noSpeechProb.has_value());
+    auto garbage = sdrtrunk::parseTranscriptionConfidence("not json");
+    EXPECT_FALSE(garbage.avgLogprob.has_value());
+}
+
+TEST(TranscriptionConfidenceTest, JsonWithLogprobRoundTrips) {
+    std::string json = sdrtrunk::makeTranscriptionJson("say \"again\"", -0.25);
+    EXPECT_EQ(json, "{\"text\":\"say \\\"again\\\"\",\"avg_logprob\":-0.2500}");
+    auto confidence = sdrtrunk::parseTranscriptionConfidence(json);
+    ASSERT_TRUE(confidence.avgLogprob.has_value());
+    EXPECT_DOUBLE_EQ(*confidence.avgLogprob, -0.25);
+}
+
+class TieredBackendTest : public ::testing::Test {
+protected:
+    // Returns a scripted response, or an error when the response is empty
+    class ScriptedBackend : public sdrtrunk::TranscriptionBackend {
+    public:
+        explicit ScriptedBackend(std::string name) : name_(std::move(name)) {}
+        sdrtrunk::Result<std::string> transcribe(const sdrtrunk::TranscriptionRequest& req) override {
+            ++calls;
+            sawPcm = req.pcm != nullptr;
+            sawProfile = req.decodeProfile != nullptr;
+            if (response.empty()) {
+                return sdrtrunk::Err<std::string>(sdrtrunk::ErrorCode::TranscriptionFailed, name_ + " failed");
+            }
+            return response;
+        }
+        std::string name() const override { return name_; }
+        std::string response;
+        int calls = 0;
+        bool sawPcm = false;
+        bool sawProfile = false;
+
+    private:
+        std::string name_;
+    };
+
+    sdrtrunk::TranscriptionRequest request(sdrtrunk::TierOutcome* outcome) {
+        pcm.samples.assign(16000, 0.0f);
+        sdrtrunk::TranscriptionRequest req;
+        req.filePath = "clip.mp3";
+        req.talkgroupId = 100;
+        req.durationSeconds = 1.0;
+        req.pcm = &pcm;
+        req.tierOutcome = outcome;
+        return req;
+    }
+
+    sdrtrunk::PcmBuffer pcm;
+    std::shared_ptr<ScriptedBackend> draft = std::make_shared<ScriptedBackend>("small.en");
+    std::shared_ptr<ScriptedBackend> full = std::make_shared<ScriptedBackend>("large-v3");
+};
+
+TEST_F(TieredBackendTest, ConfidentDraftIsAccepted) {
+    draft->response = "{\"text\":\"draft\",\"avg_logprob\":-0.2,\"no_speech_prob\":0.1}";
+    full->response = "{\"text\":\"full\"}";
+    sdrtrunk::TieredBackend tiered(draft, full);
+    sdrtrunk::TierOutcome outcome;
+    auto result = tiered.transcribe(request(&outcome));
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result.value(), draft->response);
+    EXPECT_EQ(full->calls, 0);
+    EXPECT_TRUE(draft->sawPcm);
+    EXPECT_TRUE(outcome.tiered);
+    EXPECT_FALSE(outcome.escalated);
+    EXPECT_DOUBLE_EQ(outcome.fullSeconds, 0.0);
+}
+
+TEST_F(TieredBackendTest, LowConfidenceEscalates) {
+    full->response = "{\"text\":\"full\"}";
+    sdrtrunk::TieredBackend tiered(draft, full);
+
+    draft->response = "{\"text\":\"mumble\",\"avg_logprob\":-1.2,\"no_speech_prob\":0.1}";
+    sdrtrunk::TierOutcome lowLogprob;
+    auto first = tiered.transcribe(request(&lowLogprob));
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(first.value(), full->response);
+    EXPECT_TRUE(lowLogprob.escalated);
+    EXPECT_TRUE(full->sawPcm);
+
+    draft->response = "{\"text\":\"\",\"avg_logprob\":-0.1,\"no_speech_prob\":0.9}";
+    sdrtrunk::TierOutcome noSpeech;
+    ASSERT_TRUE(tiered.transcribe(request(&noSpeech)).has_value());
+    EXPECT_TRUE(noSpeech.escalated);
+    EXPECT_EQ(full->calls, 2);
+}
+
+TEST_F(TieredBackendTest, DecodeProfileAppliesToFullPassOnly) {
+    draft->response = "{\"text\":\"mumble\",\"avg_logprob\":-1.2}";
+    full->response = "{\"text\":\"full\"}";
+    sdrtrunk::TieredBackend tiered(draft, full);
+    sdrtrunk::DecodeProfile profile = sdrtrunk::decodeProfilePreset("balanced").value();
+    auto req = request(nullptr);
+    req.decodeProfile = &profile;
+    ASSERT_TRUE(tiered.transcribe(req).has_value());
+    EXPECT_FALSE(draft->sawProfile);
+    EXPECT_TRUE(full->sawProfile);
+}
+
+TEST_F(TieredBackendTest, FailedDraftFallsBackToFull) {
+    full->response = "{\"text\":\"full\"}";
+    sdrtrunk::TieredBackend tiered(draft, full);
+    sdrtrunk::TierOutcome outcome;
+    auto result = tiered.transcribe(request(&outcome));
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result.value(), full->response);
+    EXPECT_TRUE(outcome.escalated);
+}
+
+TEST_F(TieredBackendTest, FailedFullKeepsLowConfidenceDraft) {
+    draft->response = "{\"text\":\"mumble\",\"avg_logprob\":-1.5}";
+    sdrtrunk::TieredBackend tiered(draft, full);
+    auto result = tiered.transcribe(request(nullptr));
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result.value(), draft->response);
+}
+
+TEST_F(TieredBackendTest, ThresholdsAreConfigurable) {
+    sdrtrunk::TierThresholds strict;
+    strict.minAvgLogprob = -0.1;
+    sdrtrunk::TieredBackend tiered(draft, full, strict);
+    sdrtrunk::TranscriptionConfidence confidence;
+    confidence.avgLogprob = -0.3;
+    EXPECT_TRUE(tiered.shouldEscalate(confidence));
+    confidence.avgLogprob = -0.05;
+    EXPECT_FALSE(tiered.shouldEscalate(confidence));
+}
+
+TEST_F(TieredBackendTest, EmptyDraftWithoutConfidenceEscalates) {
+    draft->response = "{\"text\":\"\"}";
+    full->response = "{\"text\":\"full\"}";
+    sdrtrunk::TieredBackend tiered(draft, full);
+    EXPECT_TRUE(tiered.shouldEscalate({}));
+    sdrtrunk::TierOutcome outcome;
+    auto result = tiered.transcribe(request(&outcome));
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result.value(), full->response);
+    EXPECT_TRUE(outcome.escalated);
+    EXPECT_EQ(full->calls, 1);
+}
+
+TEST(DatabaseTierStatsTest, AccumulatesPerTalkgroup) {
+    std::string dbPath = getTempDir() + "tier_stats_test.db";
+    std::filesystem::remove(dbPath);
+    {
+        DatabaseManager db(dbPath);
+        db.createTable();
+        db.recordTierOutcome(52198, false, 0.5, 0.0, 2.0);
+        db.recordTierOutcome(52198, true, 0.5, 3.0, 0.0);
+        db.recordTierOutcome(52198, false, 0.4, 0.0, 1.5);
+        db.recordTierOutcome(1234, true, 0.2, 1.0, 0.0);
+    }
+
+    sqlite3 *raw = nullptr;
+    ASSERT_EQ(sqlite3_open(dbPath.c_str(), &raw), SQLITE_OK);
+    sqlite3_stmt *stmt = nullptr;
+    ASSERT_EQ(sqlite3_prepare_v2(raw,
+                                 "SELECT draft_accepted, escalated, draft_compute_seconds, full_compute_seconds, "
+                                 "saved_compute_seconds FROM talkgroup_tier_stats WHERE talkgroup_id = 52198;",
+                                 -1, &stmt, nullptr), SQLITE_OK);
+    ASSERT_EQ(sqlite3_step(stmt), SQLITE_ROW);
+    EXPECT_EQ(sqlite3_column_int(stmt, 0), 2);
+    EXPECT_EQ(sqlite3_column_int(stmt, 1), 1);
+    EXPECT_DOUBLE_EQ(sqlite3_column_double(stmt, 2), 1.4);
+    EXPECT_DOUBLE_EQ(sqlite3_column_double(stmt, 3), 3.0);
+    EXPECT_DOUBLE_EQ(sqlite3_column_double(stmt, 4), 3.5);
+    sqlite3_finalize(stmt);
+    sqlite3_close(raw);
+    std::filesystem::remove(dbPath);
+}
+
+// =============================================================================
+// CHUNKED TRANSCRIPTION TESTS
+// =============================================================================
+
+namespace {
+
+// Speech-like bursts at a distinct level each, separated by 1 s pauses
+std::vector<float> segmentedRecording(const std::vector<double>& segmentSeconds) {
+    std::vector<float> out;
+    for (size_t i = 0; i < segmentSeconds.size(); ++i) {
+        if (i > 0) {
+            out.insert(out.end(), sdrtrunk::WHISPER_SAMPLE_RATE, 0.0f);
+        }
+        auto samples = static_cast<size_t>(segmentSeconds[i] * sdrtrunk::WHISPER_SAMPLE_RATE);
+        out.insert(out.end(), samples, 0.1f * static_cast<float>(i + 1));
+    }
+    return out;
+}
+
+// Names each chunk by its loudest level and records how many ran at once
+class PcmEchoBackend : public sdrtrunk::TranscriptionBackend {
+public:
+    sdrtrunk::Result<std::string> transcribe(const sdrtrunk::TranscriptionRequest& request) override {
+        int running = ++inFlight;
+        int seen = maxInFlight.load();
+        while (running > seen && !maxInFlight.compare_exchange_weak(seen, running)) {}
+        size_t reserved = sdrtrunk::DecodeMemoryBudget::instance().reservedBytes();
+        size_t seenReserved = maxReserved.load();
+        while (reserved > seenReserved && !maxReserved.compare_exchange_weak(seenReserved, reserved)) {}
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        --inFlight;
+        ++calls;
+        if (!request.pcm) {
+            return sdrtrunk::makeTranscriptionJson("whole file");
+        }
+        float peak = *std::max_element(request.pcm->samples.begin(), request.pcm->samples.end());
+        return sdrtrunk::makeTranscriptionJson(" part" + std::to_string(std::lround(peak * 10.0f)) + " ", -0.5);
+    }
+    std::string name() const override { return "echo"; }
+    bool consumesPcm() const override { return pcmCapable; }
+    bool transcribesConcurrently() const override { return concurrent; }
+
+    bool pcmCapable = true;
+    bool concurrent = true;
+    std::atomic<int> calls{0};
+    std::atomic<int> inFlight{0};
+    std::atomic<int> maxInFlight{0};
+    std::atomic<size_t> maxReserved{0};  // process decode budget in use during calls
+};
+
+sdrtrunk::ChunkingConfig chunkingFor(double threshold) {
+    sdrtrunk::ChunkingConfig config;
+    config.thresholdSeconds = threshold;
+    config.targetChunkSeconds = 30.0;
+    config.searchSeconds = 5.0;
+    config.maxParallel = 3;
+    return config;
+}
+
+} // namespace
+
+TEST(ChunkedTranscriptionTest, SplitsInsidePauses) {
+    auto audio = segmentedRecording({27.0, 28.0, 26.0, 20.0});
+    auto chunks = sdrtrunk::splitAtSilence(audio, sdrtrunk::WHISPER_SAMPLE_RATE, chunkingFor(60.0));
+    ASSERT_EQ(chunks.size(), 4u);
+    EXPECT_EQ(chunks.front().begin, 0u);
+    EXPECT_EQ(chunks.back().end, audio.size());
+    for (size_t i = 1; i < chunks.size(); ++i) {
+        EXPECT_EQ(chunks[i].begin, chunks[i - 1].end);
+        EXPECT_FLOAT_EQ(audio[chunks[i].begin], 0.0f) << "cut " << i << " is not in a pause";
+    }
+}
+
+TEST(ChunkedTranscriptionTest, ShortAudioIsOneChunk) {
+    auto audio = segmentedRecording({20.0, 10.0});
+    auto chunks = sdrtrunk::splitAtSilence(audio, sdrtrunk::WHISPER_SAMPLE_RATE, chunkingFor(60.0));
+    ASSERT_EQ(chunks.size(), 1u);
+    EXPECT_EQ(chunks[0].end, audio.size());
+    EXPECT_TRUE(sdrtrunk::splitAtSilence({}, sdrtrunk::WHISPER_SAMPLE_RATE, chunkingFor(60.0)).empty());
+}
+
+TEST(ChunkedTranscriptionTest, StitchesChunksInOrder) {
+    auto echo = std::make_shared<PcmEchoBackend>();
+    sdrtrunk::ChunkedBackend chunked(echo, chunkingFor(60.0));
+    sdrtrunk::PcmBuffer pcm;
+    pcm.samples = segmentedRecording({27.0, 28.0, 26.0, 20.0});
+
+    sdrtrunk::TranscriptionRequest request;
+    request.filePath = "long.mp3";
+    request.durationSeconds = pcm.durationSeconds();
+    request.pcm = &pcm;
+    auto result = chunked.transcribe(request);
+    ASSERT_TRUE(result.has_value()) << result.error().toString();
+    EXPECT_EQ(result.value(), "{\"text\":\"part1 part2 part3 part4\",\"avg_logprob\":-0.5000}");
+    EXPECT_EQ(echo->calls.load(), 4);
+    EXPECT_GE(echo->maxInFlight.load(), 2);
+}
+
+TEST(ChunkedTranscriptionTest, ShortRecordingsAndFileOnlyBackendsPassThrough) {
+    auto echo = std::make_shared<PcmEchoBackend>();
+    sdrtrunk::ChunkedBackend chunked(echo, chunkingFor(60.0));
+    sdrtrunk::PcmBuffer pcm;
+    pcm.samples = segmentedRecording({27.0, 28.0, 26.0, 20.0});
+    sdrtrunk::TranscriptionRequest request;
+    request.pcm = &pcm;
+
+    request.durationSeconds = 30.0;
+    EXPECT_EQ(chunked.transcribe(request).value(), "{\"text\":\" part4 \",\"avg_logprob\":-0.5000}");
+
+    echo->pcmCapable = false;
+    request.durationSeconds = pcm.durationSeconds();
+    EXPECT_EQ(chunked.transcribe(request).value(), "{\"text\":\" part4 \",\"avg_logprob\":-0.5000}");
+    EXPECT_EQ(echo->calls.load(), 2);
+}
+
+TEST(ChunkedTranscriptionTest, SerializedBackendsAreNotChunked) {
+    // Chunks of an engine behind one model lock would only run in turn
+    auto echo = std::make_shared<PcmEchoBackend>();
+    echo->concurrent = false;
+    sdrtrunk::ChunkedBackend chunked(echo, chunkingFor(60.0));
+    EXPECT_FALSE(chunked.transcribesConcurrently());
+    sdrtrunk::PcmBuffer pcm;
+    pcm.samples = segmentedRecording({27.0, 28.0, 26.0, 20.0});
+    sdrtrunk::TranscriptionRequest request;
+    request.durationSeconds = pcm.durationSeconds();
+    request.pcm = &pcm;
+    EXPECT_EQ(chunked.transcribe(request).value(), "{\"text\":\" part4 \",\"avg_logprob\":-0.5000}");
+    EXPECT_EQ(echo->calls.load(), 1);
+}
+
+TEST(ChunkedTranscriptionTest, FailedChunkFailsRecording) {
+    class FailingSecondChunk : public sdrtrunk::TranscriptionBackend {
+    public:
+        sdrtrunk::Result<std::string> transcribe(const sdrtrunk::TranscriptionRequest& request) override {
+            if (request.pcm && request.pcm->samples.front() < 0.05f) {
+                return sdrtrunk::Err<std::string>(sdrtrunk::ErrorCode::TranscriptionFailed, "chunk failed");
+            }
+            return sdrtrunk::makeTranscriptionJson("ok");
+        }
+        std::string name() const override { return "failing"; }
+        bool consumesPcm() const override { return true; }
+    };
+    sdrtrunk::ChunkedBackend chunked(std::make_shared<FailingSecondChunk>(), chunkingFor(60.0));
+    sdrtrunk::PcmBuffer pcm;
+    pcm.samples = segmentedRecording({27.0, 28.0, 26.0, 20.0});
+    sdrtrunk::TranscriptionRequest request;
+    request.pcm = &pcm;
+    request.durationSeconds = pcm.durationSeconds();
+    auto result = chunked.transcribe(request);
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().code, sdrtrunk::ErrorCode::TranscriptionFailed);
+}
+
+// =============================================================================
+// STREAMING DECODE TESTS
+// =============================================================================
+
+TEST(StreamingDecodeTest, BudgetTracksReservations) {
+    sdrtrunk::DecodeMemoryBudget budget(1000);
+    {
+        auto a = budget.reserve(600);
+        EXPECT_EQ(budget.reservedBytes(), 600u);
+        EXPECT_FALSE(budget.tryReserve(500).has_value());
+        auto b = budget.tryReserve(400);
+        ASSERT_TRUE(b.has_value());
+        EXPECT_EQ(budget.reservedBytes(), 1000u);
+
+        auto moved = std::move(a);
+        EXPECT_EQ(moved.bytes(), 600u);
+        EXPECT_EQ(budget.reservedBytes(), 1000u);
+    }
+    EXPECT_EQ(budget.reservedBytes(), 0u);
+    EXPECT_EQ(budget.peakBytes(), 1000u);
+
+    // Larger than the cap: granted once nothing else is held
+    auto oversized = budget.tryReserve(5000);
+    ASSERT_TRUE(oversized.has_value());
+    EXPECT_FALSE(budget.tryReserve(1).has_value());
+}
+
+TEST(StreamingDecodeTest, ReserveWaitsForRelease) {
+    sdrtrunk::DecodeMemoryBudget budget(1000);
+    auto held = std::make_unique<sdrtrunk::DecodeMemoryBudget::Reservation>(budget.reserve(800));
+    std::atomic<bool> granted{false};
+    std::thread waiter([&] {
+        auto reservation = budget.reserve(500);
+        granted = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(granted.load());
+    held.reset();
+    waiter.join();
+    EXPECT_TRUE(granted.load());
+    EXPECT_EQ(budget.reservedBytes(), 0u);
+    EXPECT_LE(budget.peakBytes(), 1000u);
+}
+
+TEST(StreamingDecodeTest, BlockPoolRecyclesBuffers) {
+    auto& pool = sdrtrunk::PcmBlockPool::instance();
+    auto block = pool.acquire();
+    EXPECT_TRUE(block.empty());
+    EXPECT_GE(block.capacity(), sdrtrunk::PCM_BLOCK_SAMPLES);
+    const float* storage = block.data();
+    block.assign(100, 1.0f);
+    pool.release(std::move(block));
+
+    const size_t created = pool.created();
+    auto again = pool.acquire();
+    EXPECT_EQ(again.data(), storage);
+    EXPECT_TRUE(again.empty());
+    EXPECT_EQ(pool.created(), created);
+    pool.release(std::move(again));
+
+    // Buffers too small to hold a block are dropped
+    const size_t idle = pool.idle();
+    pool.release(std::vector<float>(16));
+    EXPECT_EQ(pool.idle(), idle);
+}
+
+TEST(StreamingDecodeTest, InvalidRecordingFailsToDecode) {
+    const std::string path = getTempDir() + "not_audio.mp3";
+    {
+        std::ofstream out(path, std::ios::binary);
+        std::string junk(200000, 'x');
+        out << junk;
+    }
+    auto file = sdrtrunk::RecordingFile::open(path);
+    ASSERT_TRUE(file.has_value());
+    auto stream = sdrtrunk::PcmStream::open(file.value());
+    ASSERT_TRUE(stream.has_value()) << stream.error().toString();
+    auto block = stream->next();
+    ASSERT_FALSE(block.has_value());
+    EXPECT_EQ(block.error().code, sdrtrunk::ErrorCode::InvalidFormat);
+}
+
+TEST(StreamingDecodeTest, UndecodableLongRecordingFallsBackToBackend) {
+    const std::string path = getTempDir() + "long_junk.mp3";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << std::string(200000, 'x');
+    }
+    auto file = sdrtrunk::RecordingFile::open(path);
+    ASSERT_TRUE(file.has_value());
+    auto echo = std::make_shared<PcmEchoBackend>();
+    sdrtrunk::ChunkedBackend chunked(echo, chunkingFor(60.0));
+    sdrtrunk::TranscriptionRequest request;
+    request.filePath = path;
+    request.file = &file.value();
+    request.durationSeconds = 600.0;
+    auto result = chunked.transcribe(request);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result.value(), "{\"text\":\"whole file\"}");
+    EXPECT_EQ(echo->calls.load(), 1);
+    EXPECT_EQ(sdrtrunk::DecodeMemoryBudget::instance().reservedBytes(), 0u);
+}
+
+TEST(StreamingDecodeTest, BackendDecodesWaitForTheBudget) {
+    // A PCM backend with nothing decoded for it decodes the file itself
+    class RecordingPcm : public sdrtrunk::TranscriptionBackend {
+    public:
+        sdrtrunk::Result<std::string> transcribe(const sdrtrunk::TranscriptionRequest& request) override {
+            samples = request.pcm ? request.pcm->samples.size() : 0;
+            reserved = sdrtrunk::DecodeMemoryBudget::instance().reservedBytes();
+            called = true;
+            return sdrtrunk::makeTranscriptionJson("draft", -0.1);
+        }
+        std::string name() const override { return "recording"; }
+        bool consumesPcm() const override { return true; }
+        std::atomic<bool> called{false};
+        size_t samples = 0;
+        size_t reserved = 0;
+    };
+    const std::string path = getTempDir() + "budgeted_decode.mp3";
+    SyntheticMP3 mp3;
+    mp3.write(path);
+    auto file = sdrtrunk::RecordingFile::open(path);
+    ASSERT_TRUE(file.has_value());
+
+    auto& budget = sdrtrunk::DecodeMemoryBudget::instance();
+    const size_t previousCap = budget.capBytes();
+    budget.setCapBytes(sdrtrunk::wholeDecodeBytes(mp3.expectedSeconds()) * 3 / 2);
+    auto draft = std::make_shared<RecordingPcm>();
+    sdrtrunk::TieredBackend tiered(draft, std::make_shared<RecordingPcm>());
+    sdrtrunk::TranscriptionRequest request;
+    request.filePath = path;
+    request.file = &file.value();
+    request.durationSeconds = mp3.expectedSeconds();
+
+    // Another decode holds most of the cap, so this one has to wait
+    auto held = std::make_unique<sdrtrunk::DecodeMemoryBudget::Reservation>(
+        budget.reserve(sdrtrunk::wholeDecodeBytes(mp3.expectedSeconds())));
+    std::atomic<bool> done{false};
+    std::thread worker([&] {
+        (void)tiered.transcribe(request);
+        done = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(done.load());
+    EXPECT_FALSE(draft->called.load());
+    held.reset();
+    worker.join();
+
+    EXPECT_TRUE(done.load());
+    if (draft->samples > 0) {
+        // The decoded buffer stays reserved while the backend uses it
+        EXPECT_GE(draft->reserved, draft->samples * sizeof(float));
+    }
+    EXPECT_EQ(budget.reservedBytes(), 0u);
+    budget.setCapBytes(previousCap);
+    std::filesystem::remove(path);
+}
+
+TEST(StreamingDecodeTest, RecordingsOverTheCapAreStreamedWithoutChunking) {
+    const std::string path = getTempDir() + "over_cap.mp3";
+    SyntheticMP3 mp3;
+    mp3.frames = 3000;  // 216 s
+    mp3.write(path);
+    auto file = sdrtrunk::RecordingFile::open(path);
+    ASSERT_TRUE(file.has_value());
+    if (!sdrtrunk::decodeWithinBudget(file.value(), mp3.expectedSeconds()).has_value()) {
+        std::filesystem::remove(path);
+        GTEST_SKIP() << "mpg123 could not decode the synthetic recording";
+    }
+    const size_t wholeBytes = sdrtrunk::wholeDecodeBytes(mp3.expectedSeconds());
+
+    auto& budget = sdrtrunk::DecodeMemoryBudget::instance();
+    const size_t previousCap = budget.capBytes();
+    budget.setCapBytes(wholeBytes / 2);
+    ASSERT_TRUE(sdrtrunk::exceedsDecodeBudget(mp3.expectedSeconds()));
+
+    // Chunking off and an engine that serializes its calls: the stream
+    // is still cut into pieces, handed over one at a time
+    auto echo = std::make_shared<PcmEchoBackend>();
+    echo->concurrent = false;
+    sdrtrunk::ChunkedBackend chunked(echo, sdrtrunk::ChunkingConfig{});
+    sdrtrunk::TranscriptionRequest request;
+    request.filePath = path;
+    request.file = &file.value();
+    request.durationSeconds = mp3.expectedSeconds();
+    auto result = chunked.transcribe(request);
+    budget.setCapBytes(previousCap);
+
+    ASSERT_TRUE(result.has_value()) << result.error().toString();
+    EXPECT_GT(echo->calls.load(), 1);
+    EXPECT_EQ(echo->maxInFlight.load(), 1);
+    EXPECT_GT(echo->maxReserved.load(), 0u);
+    EXPECT_LT(echo->maxReserved.load(), wholeBytes);
+    EXPECT_EQ(budget.reservedBytes(), 0u);
+    std::filesystem::remove(path);
+}
+
+TEST(StreamingDecodeTest, SingleStreamedChunkKeepsTierOutcome) {
+    // Stands in for a TieredBackend that accepted its draft
+    class TieredEcho : public sdrtrunk::TranscriptionBackend {
+    public:
+        sdrtrunk::Result<std::string> transcribe(const sdrtrunk::TranscriptionRequest& request) override {
+            if (request.tierOutcome) {
+                request.tierOutcome->tiered = true;
+                request.tierOutcome->draftSeconds = 0.5;
+            }
+            return sdrtrunk::makeTranscriptionJson("draft", -0.1);
+        }
+        std::string name() const override { return "tiered-echo"; }
+        bool consumesPcm() const override { return true; }
+        bool transcribesConcurrently() const override { return false; }
+    };
+    const std::string path = getTempDir() + "single_chunk.mp3";
+    SyntheticMP3 mp3;
+    mp3.frames = 300;  // 21.6 s, under one chunk
+    mp3.write(path);
+    auto file = sdrtrunk::RecordingFile::open(path);
+    ASSERT_TRUE(file.has_value());
+    if (!sdrtrunk::decodeWithinBudget(file.value(), mp3.expectedSeconds()).has_value()) {
+        std::filesystem::remove(path);
+        GTEST_SKIP() << "mpg123 could not decode the synthetic recording";
+    }
+
+    auto& budget = sdrtrunk::DecodeMemoryBudget::instance();
+    const size_t previousCap = budget.capBytes();
+    budget.setCapBytes(sdrtrunk::wholeDecodeBytes(mp3.expectedSeconds()) / 2);
+    sdrtrunk::ChunkedBackend chunked(std::make_shared<TieredEcho>(), sdrtrunk::ChunkingConfig{});
+    sdrtrunk::TierOutcome outcome;
+    sdrtrunk::TranscriptionRequest request;
+    request.filePath = path;
+    request.file = &file.value();
+    request.durationSeconds = mp3.expectedSeconds();
+    request.tierOutcome = &outcome;
+    auto result = chunked.transcribe(request);
+    budget.setCapBytes(previousCap);
+
+    ASSERT_TRUE(result.has_value()) << result.error().toString();
+    EXPECT_TRUE(outcome.tiered);
+    EXPECT_DOUBLE_EQ(outcome.draftSeconds, 0.5);
+    std::filesystem::remove(path);
+}
+
+TEST(StreamingDecodeTest, LongRecordingsAreDecodedWholeForSerialBackends) {
+    auto& budget = sdrtrunk::DecodeMemoryBudget::instance();
+    const size_t previousCap = budget.capBytes();
+    budget.setCapBytes(0);
+
+    // A backend that serializes its calls is never chunked, so a long
+    // recording is decoded whole and fingerprint dedup still runs
+    auto echo = std::make_shared<PcmEchoBackend>();
+    echo->concurrent = false;
+    sdrtrunk::ChunkedBackend chunked(echo, chunkingFor(60.0));
+    EXPECT_FALSE(streamsRecording(&chunked, 600.0));
+    EXPECT_FALSE(streamsRecording(nullptr, 600.0));
+
+    echo->concurrent = true;
+    EXPECT_TRUE(streamsRecording(&chunked, 600.0));
+    EXPECT_FALSE(streamsRecording(&chunked, 30.0));
+
+    // Over the cap every recording is streamed, whatever transcribes it
+    budget.setCapBytes(sdrtrunk::wholeDecodeBytes(600.0) / 2);
+    EXPECT_TRUE(streamsRecording(nullptr, 600.0));
+    budget.setCapBytes(previousCap);
+}
+
 // =============================================================================
 // FILEDATA TESTS
 // =============================================================================
@@ -828,6 +2819,204 @@ TEST(ExtractTalkgroupIdTest, PGroupManyGroups) {
         "20260208_121343_NC__TO_P52197-[52198--52047--50662--52196]_FROM_2499843.mp3"), 52198);
 }
 
+// =============================================================================
+// SDRTRUNK FILENAME PARSER TESTS
+// =============================================================================
+
+TEST(SdrTrunkFilenameTest, StandardFields) {
+    auto parsed = sdrtrunk::parseSdrTrunkFilename(
+        "20260208_121634_North-Carolina-VIPER_Rutherford_T-Control__TO_41001_FROM_1610018.mp3");
+    EXPECT_EQ(parsed.date, "20260208");
+    EXPECT_EQ(parsed.time, "121634");
+    EXPECT_EQ(parsed.name, "North-Carolina-VIPER_Rutherford_T-Control");
+    EXPECT_EQ(parsed.talkgroup, 41001);
+    EXPECT_FALSE(parsed.patchGroup.has_value());
+    EXPECT_TRUE(parsed.members().empty());
+    EXPECT_EQ(parsed.radioId, 1610018);
+    EXPECT_EQ(parsed.version, 1);
+}
+
+TEST(SdrTrunkFilenameTest, OldFormatNameAndVersion) {
+    auto parsed = sdrtrunk::parseSdrTrunkFilename(
+        "20250715_112349North_Carolina_VIPER_Rutherford_T-SPDControl__TO_52324_V2_FROM_2097268.mp3");
+    EXPECT_EQ(parsed.name, "North_Carolina_VIPER_Rutherford_T-SPDControl");
+    EXPECT_EQ(parsed.talkgroup, 52324);
+    EXPECT_EQ(parsed.version, 2);
+    EXPECT_EQ(parsed.radioId, 2097268);
+}
+
+TEST(SdrTrunkFilenameTest, PatchMembers) {
+    auto parsed = sdrtrunk::parseSdrTrunkFilename(
+        "20260208_121343_NC__TO_P52197-[52198--52047--50662--52196]_FROM_2499843.mp3");
+    EXPECT_EQ(parsed.patchGroup, 52197);
+    EXPECT_EQ(parsed.talkgroup, 52198);
+    ASSERT_EQ(parsed.members().size(), 4u);
+    EXPECT_EQ(parsed.members()[3], 52196);
+
+    auto underscores = sdrtrunk::parseSdrTrunkFilename("20260208_121343_NC-VIPER__TO_P52197_[52198__52199]_V2_FROM_1.mp3");
+    ASSERT_EQ(underscores.members().size(), 2u);
+    EXPECT_EQ(underscores.members()[1], 52199);
+    EXPECT_EQ(underscores.version, 2);
+
+    auto alone = sdrtrunk::parseSdrTrunkFilename("20260208_121343_NC-VIPER__TO_P52197.mp3");
+    EXPECT_EQ(alone.talkgroup, 52197);
+    EXPECT_FALSE(alone.radioId.has_value());
+
+    auto legacy = sdrtrunk::parseSdrTrunkFilename("20240115_143045Test_System__TO_P_52198_FROM_12345.mp3");
+    EXPECT_EQ(legacy.talkgroup, 52198);
+}
+
+TEST(SdrTrunkFilenameTest, MalformedNames) {
+    auto empty = sdrtrunk::parseSdrTrunkFilename("");
+    EXPECT_TRUE(empty.date.empty());
+    EXPECT_TRUE(empty.time.empty());
+    EXPECT_FALSE(empty.talkgroup.has_value());
+
+    auto shortName = sdrtrunk::parseSdrTrunkFilename("2024.mp3");
+    EXPECT_TRUE(shortName.time.empty());
+
+    // Digits that overflow an int count as absent rather than throwing
+    auto huge = sdrtrunk::parseSdrTrunkFilename("20240115_143045X__TO_99999999999999_FROM_12.mp3");
+    EXPECT_FALSE(huge.talkgroup.has_value());
+    EXPECT_EQ(huge.radioId, 12);
+
+    // A name that merely contains _V is not a version
+    auto named = sdrtrunk::parseSdrTrunkFilename("20240115_143045Site_VHF__TO_100_Vx_FROM_7.mp3");
+    EXPECT_EQ(named.version, 1);
+}
+
+TEST(SdrTrunkFilenameTest, ExtractFileInfoUsesParser) {
+    FileData data;
+    extractFileInfo(data, std::string("20260208_121343_NC-VIPER__TO_9969.mp3"), "");
+    EXPECT_EQ(data.talkgroupID.get(), 9969);
+    EXPECT_EQ(data.radioID.get(), 1234567);
+    EXPECT_EQ(data.talkgroupName, "NC-VIPER");
+    EXPECT_EQ(data.date, "20260208");
+    EXPECT_EQ(data.time, "121343");
+}
+
+// =============================================================================
+// RECORDING TIME TESTS
+// =============================================================================
+
+class RecordingTimeTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        const char* tz = std::getenv("TZ");
+        savedTz = tz ? std::optional<std::string>(tz) : std::nullopt;
+    }
+
+    void TearDown() override {
+        if (savedTz) {
+            setenv("TZ", savedTz->c_str(), 1);
+        } else {
+            unsetenv("TZ");
+        }
+        sdrtrunk::reloadLocalTimeZone();
+    }
+
+    static void useZone(const char* zone) {
+        setenv("TZ", zone, 1);
+        sdrtrunk::reloadLocalTimeZone();
+    }
+
+    std::optional<std::string> savedTz;
+};
+
+TEST_F(RecordingTimeTest, DaysFromCivil) {
+    EXPECT_EQ(sdrtrunk::daysFromCivil(1970, 1, 1), 0);
+    EXPECT_EQ(sdrtrunk::daysFromCivil(1969, 12, 31), -1);
+    EXPECT_EQ(sdrtrunk::daysFromCivil(2100, 3, 1) - sdrtrunk::daysFromCivil(2100, 2, 28), 1);
+    // Out-of-range days roll into the next month like mktime
+    EXPECT_EQ(sdrtrunk::daysFromCivil(2023, 2, 29), sdrtrunk::daysFromCivil(2023, 3, 1));
+}
+
+TEST_F(RecordingTimeTest, MatchesMktimeInUtc) {
+    useZone("UTC");
+    for (int month = 1; month <= 12; ++month) {
+        std::tm tm = {};
+        tm.tm_year = 2025 - 1900;
+        tm.tm_mon = month - 1;
+        tm.tm_mday = 17;
+        tm.tm_hour = 23;
+        tm.tm_min = 5;
+        tm.tm_sec = 9;
+        tm.tm_isdst = -1;
+        char date[9];
+        std::snprintf(date, sizeof(date), "2025%02d17", month);
+        EXPECT_EQ(generateUnixTimestamp(date, "230509"), static_cast<int64_t>(std::mktime(&tm))) << date;
+    }
+}
+
+TEST_F(RecordingTimeTest, ReadsDaylightSavingTimesAsStandardTime) {
+    useZone("America/New_York");
+    EXPECT_EQ(generateUnixTimestamp("20240115", "143045"), 1705347045);
+    // Summer times keep the EST offset the get_time()/mktime() version gave
+    EXPECT_EQ(generateUnixTimestamp("20240715", "120000"), 1721062800);
+    EXPECT_EQ(generateUnixTimestamp("20240310", "023000"), 1710055800);
+    EXPECT_EQ(generateUnixTimestamp("20241103", "013000"), 1730615400);
+    EXPECT_EQ(generateUnixTimestamp("20241103", "023000"), 1730619000);
+
+    // Cached periods are dropped when the zone changes
+    useZone("UTC");
+    EXPECT_EQ(generateUnixTimestamp("20240715", "120000"), 1721044800);
+}
+
+TEST_F(RecordingTimeTest, MatchesMktimeWithoutDst) {
+    // What the baseline stored: std::get_time() leaves tm_isdst at 0
+    useZone("America/New_York");
+    for (int month = 1; month <= 12; ++month) {
+        std::tm tm = {};
+        tm.tm_year = 2024 - 1900;
+        tm.tm_mon = month - 1;
+        tm.tm_mday = 17;
+        tm.tm_hour = 9;
+        tm.tm_min = 41;
+        tm.tm_sec = 2;
+        tm.tm_isdst = 0;
+        char date[9];
+        std::snprintf(date, sizeof(date), "2024%02d17", month);
+        EXPECT_EQ(generateUnixTimestamp(date, "094102"), static_cast<int64_t>(std::mktime(&tm))) << date;
+    }
+}
+
+TEST_F(RecordingTimeTest, ParallelWorkersAgree) {
+    useZone("America/New_York");
+    std::vector<std::pair<std::string, std::string>> stamps;
+    std::vector<int64_t> expected;
+    for (int day = 1; day <= 28; ++day) {
+        for (int month = 1; month <= 12; month += 2) {
+            char date[9];
+            std::snprintf(date, sizeof(date), "2024%02d%02d", month, day);
+            stamps.emplace_back(date, "081500");
+            expected.push_back(generateUnixTimestamp(date, "081500"));
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::atomic<int> mismatches{0};
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&] {
+            for (size_t i = 0; i < stamps.size(); ++i) {
+                if (generateUnixTimestamp(stamps[i].first, stamps[i].second) != expected[i]) {
+                    ++mismatches;
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    EXPECT_EQ(mismatches.load(), 0);
+}
+
+TEST_F(RecordingTimeTest, MalformedFields) {
+    EXPECT_FALSE(sdrtrunk::recordingUnixTime("2024011", "143045").has_value());
+    EXPECT_FALSE(sdrtrunk::recordingUnixTime("20240115", "14304x").has_value());
+    EXPECT_FALSE(sdrtrunk::recordingUnixTime("20240115", "250000").has_value());
+    EXPECT_EQ(generateUnixTimestamp("", ""), 0);
+}
+
 // =============================================================================
 // REAL MP3 FILE TESTS (diverse SDRTrunk filename patterns)
 // =============================================================================
@@ -967,6 +3156,131 @@ TEST(PerTalkgroupPromptTest, StructFieldAssignment) {
     EXPECT_EQ(files.glossaryFiles.size(), 1);
 }
 
+TEST(PerTalkgroupPromptTest, ProfilesAreStoredOncePerDistinctSettings) {
+    TalkgroupFiles police;
+    police.prompt = "Police radio dispatch.";
+    TalkgroupFiles fire;
+    fire.prompt = "Fire dispatch.";
+
+    sdrtrunk::TalkgroupProfiles profiles;
+    profiles.assign(sdrtrunk::parseTalkgroupRanges("100-199"), police);
+    profiles.assign({{200, 200}}, police);
+    profiles.assign({{300, 300}}, fire);
+    EXPECT_EQ(profiles.size(), 102);
+    EXPECT_EQ(profiles.profileCount(), 2);
+    EXPECT_EQ(profiles.lookup(150), profiles.lookup(200));
+    EXPECT_EQ(profiles.at(300).prompt, "Fire dispatch.");
+    EXPECT_EQ(profiles.lookup(400), nullptr);
+    EXPECT_THROW(profiles.at(400), std::out_of_range);
+
+    // Reassigning the last talkgroup off a profile releases it
+    profiles.assign({{300, 300}}, police);
+    EXPECT_EQ(profiles.profileCount(), 1);
+    EXPECT_EQ(profiles.at(300).prompt, "Police radio dispatch.");
+
+    size_t visited = 0;
+    for (const auto& [talkgroupID, files] : profiles) {
+        EXPECT_EQ(&files, profiles.lookup(talkgroupID));
+        ++visited;
+    }
+    EXPECT_EQ(visited, profiles.size());
+}
+
+TEST(PerTalkgroupPromptTest, WideRangesAreIntervalsWithOverrides) {
+    TalkgroupFiles statewide;
+    statewide.prompt = "Statewide.";
+    TalkgroupFiles county;
+    county.prompt = "County.";
+
+    sdrtrunk::TalkgroupProfiles profiles;
+    profiles.assign(sdrtrunk::parseTalkgroupRanges("1-65535"), statewide);
+    EXPECT_EQ(profiles.size(), 65535);
+    EXPECT_EQ(profiles.intervalCount(), 1);
+
+    // A later key wins for the IDs it covers and splits the wide range
+    profiles.assign(sdrtrunk::parseTalkgroupRanges("500-600,601,65535"), county);
+    EXPECT_EQ(profiles.size(), 65535);
+    EXPECT_EQ(profiles.intervalCount(), 4);
+    EXPECT_EQ(profiles.at(499).prompt, "Statewide.");
+    EXPECT_EQ(profiles.at(500).prompt, "County.");
+    EXPECT_EQ(profiles.at(601).prompt, "County.");
+    EXPECT_EQ(profiles.at(602).prompt, "Statewide.");
+    EXPECT_EQ(profiles.at(65535).prompt, "County.");
+    EXPECT_EQ(profiles.count(0), 0);
+    EXPECT_EQ(profiles.count(65536), 0);
+
+    auto it = profiles.find(601);
+    ASSERT_NE(it, profiles.end());
+    EXPECT_EQ(it->first, 601);
+    ++it;
+    EXPECT_EQ(it->first, 602);
+    EXPECT_EQ(it->second.prompt, "Statewide.");
+
+    // Giving the holes back their old settings rejoins the intervals
+    profiles.assign(sdrtrunk::parseTalkgroupRanges("500-601,65535"), statewide);
+    EXPECT_EQ(profiles.intervalCount(), 1);
+    EXPECT_EQ(profiles.profileCount(), 1);
+}
+
+// =============================================================================
+// DECODE PROFILE TESTS
+// =============================================================================
+
+TEST(DecodeProfileTest, PresetsTradeAccuracyForSpeed) {
+    auto fast = sdrtrunk::decodeProfilePreset("fast");
+    auto balanced = sdrtrunk::decodeProfilePreset("balanced");
+    auto accurate = sdrtrunk::decodeProfilePreset("accurate");
+    ASSERT_TRUE(fast.has_value());
+    ASSERT_TRUE(balanced.has_value());
+    ASSERT_TRUE(accurate.has_value());
+    EXPECT_EQ(fast->beamSize, 1);
+    EXPECT_EQ(fast->bestOf, 1);
+    EXPECT_LT(fast->beamSize, balanced->beamSize);
+    EXPECT_LT(balanced->beamSize, accurate->beamSize);
+    // accurate matches the fasterWhisper.py module constants
+    EXPECT_EQ(accurate->beamSize, 9);
+    EXPECT_DOUBLE_EQ(accurate->patience, 10.0);
+    EXPECT_EQ(accurate->minSilenceDurationMs, 1500);
+}
+
+TEST(DecodeProfileTest, UnknownPresetIsConfigError) {
+    auto profile = sdrtrunk::decodeProfilePreset("turbo");
+    ASSERT_FALSE(profile.has_value());
+    EXPECT_EQ(profile.error().code, sdrtrunk::ErrorCode::ConfigError);
+}
+
+TEST_F(ConfigSingletonTest, LoadsTalkgroupDecodeProfiles) {
+    YamlNode config = YamlParser::loadFile(TEST_CONFIG_PATH);
+    YamlNode talkgroups = YamlParser::parseString(
+        "TALKGROUP_FILES:\n"
+        "  9101:\n"
+        "    DECODE_PROFILE: fast\n"
+        "  9102-9103:\n"
+        "    DECODE_PROFILE:\n"
+        "      PRESET: balanced\n"
+        "      BEAM_SIZE: 3\n"
+        "      TEMPERATURE: 0.2\n"
+        "  9104:\n"
+        "    DECODE_PROFILE: turbo\n");
+    config["TALKGROUP_FILES"] = talkgroups["TALKGROUP_FILES"];
+    auto& configSingleton = ConfigSingleton::getInstance();
+    configSingleton.initialize(config);
+    const auto& talkgroupFiles = configSingleton.getTalkgroupFiles();
+
+    ASSERT_TRUE(talkgroupFiles.at(9101).decodeProfile.has_value());
+    EXPECT_EQ(talkgroupFiles.at(9101).decodeProfile->name, "fast");
+    EXPECT_EQ(talkgroupFiles.at(9101).decodeProfile->beamSize, 1);
+
+    ASSERT_TRUE(talkgroupFiles.at(9103).decodeProfile.has_value());
+    const auto& tuned = *talkgroupFiles.at(9103).decodeProfile;
+    EXPECT_EQ(tuned.name, "balanced");
+    EXPECT_EQ(tuned.beamSize, 3);
+    EXPECT_DOUBLE_EQ(tuned.temperature, 0.2);
+    EXPECT_EQ(tuned.bestOf, sdrtrunk::decodeProfilePreset("balanced")->bestOf);
+
+    EXPECT_FALSE(talkgroupFiles.at(9104).decodeProfile.has_value());
+}
+
 // =============================================================================
 // parseTalkgroupIDs EXTENDED TESTS
 // =============================================================================
@@ -993,6 +3307,15 @@ TEST(ParseTalkgroupIDsExtendedTest, RangeOfOne) {
     EXPECT_TRUE(ids.count(100));
 }
 
+TEST(ParseTalkgroupIDsExtendedTest, RangesAreKeptUnexpanded) {
+    auto ranges = sdrtrunk::parseTalkgroupRanges("1-65535,28513,300-200");
+    ASSERT_EQ(ranges.size(), 2);
+    EXPECT_EQ(ranges[0].first, 1);
+    EXPECT_EQ(ranges[0].last, 65535);
+    EXPECT_EQ(ranges[1].first, 28513);
+    EXPECT_EQ(ranges[1].last, 28513);
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);